@@ -34,6 +34,29 @@
 #include <Wire.h>
 
 #include "Adafruit_LSM6DS.h"
+#include "Adafruit_LSM6DS_Capture.h"
+#include "Adafruit_LSM6DS_Decode.h"
+#include "Adafruit_LSM6DS_FIFORing.h"
+#include "Adafruit_LSM6DS_Window.h"
+
+// INT1_CTRL/INT2_CTRL, CTRL1_XL to CTRL10_C, then TAP_CFG to MD2_CFG
+static const lsm6ds_reg_block_t _config_blocks[] = {
+    {LSM6DS_INT1_CTRL, 2, 0},
+    {LSM6DS_CTRL1_XL, 10, 0},
+#if LSM6DS_ENABLE_EVENTS
+    {LSM6DS_TAP_CFG, 8, 0},
+#endif
+};
+
+// everything saveConfig() keeps: FIFO_CTRL1 to FIFO_CTRL5 and the gyro
+// orientation/pulse register, INT1_CTRL/INT2_CTRL, TAP_CFG to MD2_CFG, the
+// pedometer and significant motion thresholds in the embedded bank, then
+// CTRL1_XL to CTRL10_C last so the sensors restart fully configured
+static const lsm6ds_reg_block_t _saved_blocks[] = {
+    {LSM6DS_FIFO_CTRL1, 6, 0}, {LSM6DS_INT1_CTRL, 2, 0},
+    {LSM6DS_TAP_CFG, 8, 0},    {0x0F, 1, 1},
+    {0x13, 3, 1},              {LSM6DS_CTRL1_XL, 10, 0},
+};
 
 static const float _data_rate_arr[] = {
     [LSM6DS_RATE_SHUTDOWN] = 0.0f,    [LSM6DS_RATE_12_5_HZ] = 12.5f,
@@ -52,7 +75,13 @@ Adafruit_LSM6DS::Adafruit_LSM6DS(void) {}
 /*!
  *    @brief  Cleans up the LSM6DS
  */
-Adafruit_LSM6DS::~Adafruit_LSM6DS(void) { delete temp_sensor; }
+Adafruit_LSM6DS::~Adafruit_LSM6DS(void) {
+  delete i2c_dev;
+  delete spi_dev;
+  delete temp_sensor;
+  delete accel_sensor;
+  delete gyro_sensor;
+}
 
 /*!  @brief  Unique subclass initializer post i2c/spi init
  *   @param sensor_id Optional unique ID for the sensor set
@@ -71,15 +100,6 @@ bool Adafruit_LSM6DS::_init(int32_t sensor_id) {
 
   delay(10);
 
-  // delete objects if sensor is reinitialized
-  delete temp_sensor;
-  delete accel_sensor;
-  delete gyro_sensor;
-
-  temp_sensor = new Adafruit_LSM6DS_Temp(this);
-  accel_sensor = new Adafruit_LSM6DS_Accelerometer(this);
-  gyro_sensor = new Adafruit_LSM6DS_Gyro(this);
-
   return false;
 };
 
@@ -88,22 +108,409 @@ bool Adafruit_LSM6DS::_init(int32_t sensor_id) {
  *    @returns 8 Bit value from WHOAMI register
  */
 uint8_t Adafruit_LSM6DS::chipID(void) {
-  Adafruit_BusIO_Register chip_id = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_WHOAMI);
-  // Serial.print("Read ID 0x"); Serial.println(chip_id.read(), HEX);
-
-  // make sure we're talking to the right chip
-  return chip_id.read();
+  uint8_t chip_id = 0;
+  readRegisters(LSM6DS_WHOAMI, &chip_id, 1);
+  return chip_id;
 }
 
 /*!
  *    @brief  Read Status register
- *    @returns 8 Bit value from Status register
+ *    @returns 8 Bit value from Status register, 0 on a bus error
  */
 uint8_t Adafruit_LSM6DS::status(void) {
-  Adafruit_BusIO_Register status_reg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_STATUS_REG);
-  return status_reg.read();
+  uint8_t status_reg = 0;
+  readStatus(&status_reg);
+  return status_reg;
+}
+
+/*!
+ *    @brief  Reads the STATUS_REG data-ready flags, telling a bus error
+ *            apart from no new data, which accelerationAvailable() and
+ *            gyroscopeAvailable() can't
+ *    @param  status Set to the register value, bit 0 for new accel data
+ *            and bit 1 for new gyro data
+ *    @returns False on a bus error
+ */
+bool Adafruit_LSM6DS::readStatus(uint8_t *status) {
+  return readRegisters(LSM6DS_STATUS_REG, status, 1);
+}
+
+/*!
+ *    @brief  Reads a run of consecutive registers in a single bus
+ *            transaction. All register access goes through here so it can be
+ *            retried, counted and carried by any bus backend.
+ *    @param  reg The first register address
+ *    @param  buffer Buffer to hold the register values
+ *    @param  len The number of registers to read
+ *    @returns True if the bus transfer succeeded
+ */
+bool Adafruit_LSM6DS::readRegisters(uint8_t reg, uint8_t *buffer,
+                                    size_t len) {
+  bool ok = false;
+  for (uint8_t attempt = 0; !ok && (attempt <= LSM6DS_BUS_RETRIES);
+       attempt++) {
+    if (attempt) {
+      delayMicroseconds(LSM6DS_BUS_RETRY_US << (attempt - 1));
+    }
+    if (_bus) {
+      ok = _bus->read(reg, buffer, len);
+    } else if (i2c_dev) {
+      ok = i2c_dev->write_then_read(&reg, 1, buffer, len);
+    } else {
+      uint8_t addr = reg | 0x80; // ADDRBIT8_HIGH_TOREAD
+      ok = spi_dev->write_then_read(&addr, 1, buffer, len);
+    }
+#if LSM6DS_ENABLE_STATS
+    _stats.transactions++;
+    if (!ok) {
+      _stats.failures++;
+    }
+#endif
+  }
+
+#if LSM6DS_ENABLE_STATS
+  if (ok) {
+    _stats.bytes += len;
+  }
+#endif
+  return ok;
+}
+
+/*!
+ *    @brief  Writes a run of consecutive registers in a single bus
+ *            transaction
+ *    @param  reg The first register address
+ *    @param  buffer The register values to write
+ *    @param  len The number of registers to write
+ *    @returns True if the bus transfer succeeded
+ */
+bool Adafruit_LSM6DS::writeRegisters(uint8_t reg, const uint8_t *buffer,
+                                     size_t len) {
+  bool ok = false;
+  for (uint8_t attempt = 0; !ok && (attempt <= LSM6DS_BUS_RETRIES);
+       attempt++) {
+    if (attempt) {
+      delayMicroseconds(LSM6DS_BUS_RETRY_US << (attempt - 1));
+    }
+    if (_bus) {
+      ok = _bus->write(reg, buffer, len);
+    } else if (i2c_dev) {
+      ok = i2c_dev->write(buffer, len, true, &reg, 1);
+    } else {
+      ok = spi_dev->write(buffer, len, &reg, 1);
+    }
+#if LSM6DS_ENABLE_STATS
+    _stats.transactions++;
+    if (!ok) {
+      _stats.failures++;
+    }
+#endif
+  }
+
+#if LSM6DS_ENABLE_STATS
+  if (ok) {
+    _stats.bytes += len;
+  }
+#endif
+  return ok;
+}
+
+/*!
+ *    @brief  Reads a bit field from one register
+ *    @param  reg The register address
+ *    @param  bits The width of the field
+ *    @param  shift The position of the field's lowest bit
+ *    @returns The field value, 0 if the read failed
+ */
+uint8_t Adafruit_LSM6DS::readBits(uint8_t reg, uint8_t bits, uint8_t shift) {
+  uint8_t value = 0;
+  readRegisters(reg, &value, 1);
+  return (value >> shift) & ((1 << bits) - 1);
+}
+
+/*!
+ *    @brief  Changes a bit field in one register, leaving the other bits as
+ *            they are
+ *    @param  reg The register address
+ *    @param  bits The width of the field
+ *    @param  shift The position of the field's lowest bit
+ *    @param  value The new field value
+ *    @returns True if the register was read and written
+ */
+bool Adafruit_LSM6DS::writeBits(uint8_t reg, uint8_t bits, uint8_t shift,
+                                uint8_t value) {
+  uint8_t mask = ((1 << bits) - 1) << shift;
+  uint8_t reg_value;
+  if (!readRegisters(reg, &reg_value, 1)) {
+    return false;
+  }
+  reg_value = (reg_value & ~mask) | ((value << shift) & mask);
+  return writeRegisters(reg, &reg_value, 1);
+}
+
+/*!
+ *    @brief  Records the chip ID after a successful begin, for recover()
+ *    @param  init_ok The result of _init()
+ *    @returns `init_ok`
+ */
+bool Adafruit_LSM6DS::_begun(bool init_ok) {
+  _chip_id = init_ok ? chipID() : 0;
+  _config_valid = false;
+  _config_dirty = true;
+  return init_ok;
+}
+
+/*!
+ *    @brief  Sets the pins used to free a stuck I2C bus during recover().
+ *            Without them recovery only restarts the I2C peripheral.
+ *    @param  scl_pin The pin connected to SCL, or -1 to disable
+ *    @param  sda_pin The pin connected to SDA, or -1 to disable
+ */
+void Adafruit_LSM6DS::setI2CRecoveryPins(int8_t scl_pin, int8_t sda_pin) {
+  _scl_pin = scl_pin;
+  _sda_pin = sda_pin;
+}
+
+/*!
+ *    @brief  Copies the control registers into the configuration cache so
+ *            recover() can put them back after the chip loses power
+ *    @returns True if every register was read
+ */
+bool Adafruit_LSM6DS::captureConfig(void) {
+  uint8_t *cache = _config;
+  for (uint8_t i = 0; i < sizeof(_config_blocks) / sizeof(_config_blocks[0]);
+       i++) {
+    if (!readRegisters(_config_blocks[i].reg, cache, _config_blocks[i].len)) {
+      return false;
+    }
+    cache += _config_blocks[i].len;
+  }
+  _config_valid = true;
+  _config_dirty = false;
+  return true;
+}
+
+/*!
+ *    @brief  Brings the bus and chip back after a failed transfer: frees a
+ *            stuck I2C bus, restarts the bus interface, checks the chip ID
+ *            and, if the chip lost its configuration, rewrites the cached
+ *            control registers in a few bursts. When the configuration is
+ *            intact nothing is written, so FIFO contents are kept.
+ *    @returns True if the chip is responding and configured
+ */
+bool Adafruit_LSM6DS::recover(void) {
+#if LSM6DS_ENABLE_STATS
+  _stats.recoveries++;
+#endif
+
+  if (_bus) {
+    _bus->end();
+    if (!_bus->begin()) {
+      return false;
+    }
+  } else if (i2c_dev) {
+    i2c_dev->end();
+    if ((_scl_pin >= 0) && (_sda_pin >= 0)) {
+      // clock out whatever transfer a slave is stuck in, then STOP
+      pinMode(_sda_pin, INPUT_PULLUP);
+      pinMode(_scl_pin, INPUT_PULLUP);
+      for (uint8_t i = 0; (i < 9) && !digitalRead(_sda_pin); i++) {
+        pinMode(_scl_pin, OUTPUT);
+        digitalWrite(_scl_pin, LOW);
+        delayMicroseconds(5);
+        pinMode(_scl_pin, INPUT_PULLUP);
+        delayMicroseconds(5);
+      }
+      pinMode(_sda_pin, OUTPUT);
+      digitalWrite(_sda_pin, LOW);
+      delayMicroseconds(5);
+      pinMode(_sda_pin, INPUT_PULLUP);
+      delayMicroseconds(5);
+    }
+    if (!i2c_dev->begin()) {
+      return false;
+    }
+  } else if (!spi_dev->begin()) {
+    return false;
+  }
+
+  if (!_chip_id || (chipID() != _chip_id)) {
+    return false;
+  }
+  if (!_config_valid) {
+    return true;
+  }
+
+  // CTRL1_XL..CTRL10_C go back to defaults when the chip resets
+  uint8_t ctrl[10];
+  uint8_t *cached_ctrl = _config + _config_blocks[0].len;
+  if (!readRegisters(LSM6DS_CTRL1_XL, ctrl, sizeof(ctrl))) {
+    return false;
+  }
+  if (memcmp(ctrl, cached_ctrl, sizeof(ctrl)) == 0) {
+    return true;
+  }
+  // a pending setter change explains a difference, a powered down chip that
+  // was running does not
+  bool was_reset = !(ctrl[0] | ctrl[1]) && (cached_ctrl[0] | cached_ctrl[1]);
+  if (_config_dirty && !was_reset) {
+    return true;
+  }
+
+  cached_ctrl[LSM6DS_CTRL3_C - LSM6DS_CTRL1_XL] &= ~0x81; // no BOOT/SW_RESET
+  const uint8_t *cache = _config;
+  for (uint8_t i = 0; i < sizeof(_config_blocks) / sizeof(_config_blocks[0]);
+       i++) {
+    if (!writeRegisters(_config_blocks[i].reg, cache, _config_blocks[i].len)) {
+      return false;
+    }
+    cache += _config_blocks[i].len;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Takes a snapshot of every control and embedded function
+ *            register the driver can change, for restoreConfig()
+ *    @param  config The snapshot to fill in
+ *    @returns True if every register was read
+ */
+bool Adafruit_LSM6DS::saveConfig(lsm6ds_config_t *config) {
+  uint8_t count;
+  const lsm6ds_reg_block_t *blocks = configBlocks(&count);
+  uint8_t *regs = config->regs;
+  uint8_t bank = 0;
+  bool ok = true;
+
+  config->chip_id = _chip_id;
+  for (uint8_t i = 0; ok && (i < count); i++) {
+    if ((regs + blocks[i].len) > (config->regs + sizeof(config->regs))) {
+      ok = false;
+      break;
+    }
+    if (blocks[i].bank != bank) {
+      bank = blocks[i].bank;
+      uint8_t access = bank ? 0x80 : 0x00;
+      ok = writeRegisters(LSM6DS_FUNC_CFG_ACCESS, &access, 1);
+    }
+    ok = ok && readRegisters(blocks[i].reg, regs, blocks[i].len);
+    if (!blocks[i].bank && (blocks[i].reg <= LSM6DS_CTRL3_C) &&
+        (blocks[i].reg + blocks[i].len > LSM6DS_CTRL3_C)) {
+      regs[LSM6DS_CTRL3_C - blocks[i].reg] &= ~0x81; // no BOOT/SW_RESET
+    }
+    regs += blocks[i].len;
+  }
+  if (bank) {
+    uint8_t access = 0x00;
+    ok = writeRegisters(LSM6DS_FUNC_CFG_ACCESS, &access, 1) && ok;
+  }
+  config->length = regs - config->regs;
+
+#if LSM6DS_ENABLE_FIFO
+  config->fifo_rates = (_fifo_gyro_rate << 4) | _fifo_accel_rate;
+#else
+  config->fifo_rates = 0;
+#endif
+  return ok;
+}
+
+/*!
+ *    @brief  Writes a saveConfig() snapshot back with one burst per
+ *            register block, in place of reset() and the setup calls. Use
+ *            after the sensor lost power or after begin() on a warm start.
+ *            Nothing is read back and there are no delays.
+ *    @param  config The snapshot, taken from a chip with the same WHOAMI
+ *    @returns True if every register was written
+ */
+bool Adafruit_LSM6DS::restoreConfig(const lsm6ds_config_t *config) {
+  uint8_t count;
+  const lsm6ds_reg_block_t *blocks = configBlocks(&count);
+  size_t length = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    length += blocks[i].len;
+  }
+  if (!_chip_id || (config->chip_id != _chip_id) ||
+      (config->length != length)) {
+    return false;
+  }
+
+  const uint8_t *regs = config->regs;
+  uint8_t bank = 0;
+  bool ok = true;
+  for (uint8_t i = 0; ok && (i < count); i++) {
+    if (blocks[i].bank != bank) {
+      bank = blocks[i].bank;
+      uint8_t access = bank ? 0x80 : 0x00;
+      ok = writeRegisters(LSM6DS_FUNC_CFG_ACCESS, &access, 1);
+    }
+    ok = ok && writeRegisters(blocks[i].reg, regs, blocks[i].len);
+    regs += blocks[i].len;
+  }
+  if (bank) {
+    uint8_t access = 0x00;
+    ok = writeRegisters(LSM6DS_FUNC_CFG_ACCESS, &access, 1) && ok;
+  }
+
+  restoreState(config);
+  _config_dirty = true;
+  return ok;
+}
+
+/*!
+ *    @brief  Lists the register blocks saveConfig() keeps for this chip.
+ *            Embedded function blocks are written with the bank switched.
+ *    @param  count Set to the number of blocks
+ *    @returns The blocks, in the order they are restored
+ */
+const lsm6ds_reg_block_t *Adafruit_LSM6DS::configBlocks(uint8_t *count) {
+  *count = sizeof(_saved_blocks) / sizeof(_saved_blocks[0]);
+  return _saved_blocks;
+}
+
+/*!
+ *    @brief  Brings the driver's copies of the chip settings in line with a
+ *            restored snapshot
+ *    @param  config The snapshot that was written
+ */
+void Adafruit_LSM6DS::restoreState(const lsm6ds_config_t *config) {
+  uint8_t ctrl;
+  if (savedRegister(config, LSM6DS_CTRL1_XL, 0, &ctrl)) {
+    accelRateBuffered = (lsm6ds_data_rate_t)(ctrl >> 4);
+    accelRangeBuffered = (lsm6ds_accel_range_t)((ctrl >> 2) & 0x03);
+  }
+  if (savedRegister(config, LSM6DS_CTRL2_G, 0, &ctrl)) {
+    gyroRateBuffered = (lsm6ds_data_rate_t)(ctrl >> 4);
+    gyroRangeBuffered = (lsm6ds_gyro_range_t)(ctrl & 0x0F);
+  }
+#if LSM6DS_ENABLE_FIFO
+  _fifo_accel_rate = (lsm6ds_data_rate_t)(config->fifo_rates & 0x0F);
+  _fifo_gyro_rate = (lsm6ds_data_rate_t)(config->fifo_rates >> 4);
+#endif
+}
+
+/*!
+ *    @brief  Looks up one register's value in a snapshot
+ *    @param  config The snapshot from saveConfig()
+ *    @param  reg The register address
+ *    @param  bank 0 for the main registers, 1 for the embedded functions
+ *    @param  value Set to the saved value
+ *    @returns True if the snapshot holds the register
+ */
+bool Adafruit_LSM6DS::savedRegister(const lsm6ds_config_t *config,
+                                    uint8_t reg, uint8_t bank,
+                                    uint8_t *value) {
+  uint8_t count;
+  const lsm6ds_reg_block_t *blocks = configBlocks(&count);
+  const uint8_t *regs = config->regs;
+  for (uint8_t i = 0; i < count; i++) {
+    if ((blocks[i].bank == bank) && (reg >= blocks[i].reg) &&
+        (reg < blocks[i].reg + blocks[i].len)) {
+      *value = regs[reg - blocks[i].reg];
+      return true;
+    }
+    regs += blocks[i].len;
+  }
+  return false;
 }
 
 /*!
@@ -118,6 +525,7 @@ uint8_t Adafruit_LSM6DS::status(void) {
  */
 boolean Adafruit_LSM6DS::begin_I2C(uint8_t i2c_address, TwoWire *wire,
                                    int32_t sensor_id) {
+  _bus = NULL;
   delete i2c_dev; // remove old interface
 
   i2c_dev = new Adafruit_I2CDevice(i2c_address, wire);
@@ -126,7 +534,7 @@ boolean Adafruit_LSM6DS::begin_I2C(uint8_t i2c_address, TwoWire *wire,
     return false;
   }
 
-  return _init(sensor_id);
+  return _begun(_init(sensor_id));
 }
 
 /*!
@@ -140,20 +548,24 @@ boolean Adafruit_LSM6DS::begin_I2C(uint8_t i2c_address, TwoWire *wire,
  */
 bool Adafruit_LSM6DS::begin_SPI(uint8_t cs_pin, SPIClass *theSPI,
                                 int32_t sensor_id, uint32_t frequency) {
+  _bus = NULL;
+  delete i2c_dev; // remove old interfaces
+  delete spi_dev;
   i2c_dev = NULL;
 
-  delete spi_dev; // remove old interface
-
   spi_dev = new Adafruit_SPIDevice(cs_pin,
                                    frequency,             // frequency
                                    SPI_BITORDER_MSBFIRST, // bit order
                                    SPI_MODE0,             // data mode
                                    theSPI);
+  _spi = theSPI;
+  _spi_cs = cs_pin;
+  _spi_frequency = frequency;
   if (!spi_dev->begin()) {
     return false;
   }
 
-  return _init(sensor_id);
+  return _begun(_init(sensor_id));
 }
 
 /*!
@@ -170,40 +582,779 @@ bool Adafruit_LSM6DS::begin_SPI(uint8_t cs_pin, SPIClass *theSPI,
 bool Adafruit_LSM6DS::begin_SPI(int8_t cs_pin, int8_t sck_pin, int8_t miso_pin,
                                 int8_t mosi_pin, int32_t sensor_id,
                                 uint32_t frequency) {
+  _bus = NULL;
+  delete i2c_dev; // remove old interfaces
+  delete spi_dev;
   i2c_dev = NULL;
 
-  delete spi_dev; // remove old interface
-
   spi_dev = new Adafruit_SPIDevice(cs_pin, sck_pin, miso_pin, mosi_pin,
                                    frequency,             // frequency
                                    SPI_BITORDER_MSBFIRST, // bit order
                                    SPI_MODE0);            // data mode
+  _spi = NULL;
+  _spi_cs = cs_pin;
+  _spi_sck = sck_pin;
+  _spi_miso = miso_pin;
+  _spi_mosi = mosi_pin;
+  _spi_frequency = frequency;
   if (!spi_dev->begin()) {
     return false;
   }
 
-  return _init(sensor_id);
+  return _begun(_init(sensor_id));
 }
 
+/*!
+ *    @brief  Sets up the sensor on a bus backend instead of an Arduino I2C or
+ *            SPI device, e.g. Adafruit_LSM6DS_LinuxI2C. The backend is not
+ *            owned and must outlive the sensor object.
+ *    @param  bus The bus backend the sensor is connected to
+ *    @param  sensor_id
+ *            The user-defined ID to differentiate different sensors
+ *    @return True if initialization was successful, otherwise false.
+ */
+bool Adafruit_LSM6DS::begin_Bus(Adafruit_LSM6DS_Bus *bus, int32_t sensor_id) {
+  delete i2c_dev; // remove old interfaces
+  delete spi_dev;
+  i2c_dev = NULL;
+  spi_dev = NULL;
+
+  _bus = bus;
+  if (!_bus->begin()) {
+    return false;
+  }
+
+  return _begun(_init(sensor_id));
+}
+
+/*!
+ *    @brief  Raises the SPI clock as far as the sensor reliably answers.
+ *            Starting at `max_frequency`, capped at LSM6DS_SPI_MAX_HZ, the
+ *            clock is halved until WHOAMI reads back correctly twice in a
+ *            row. Only for sensors started with begin_SPI().
+ *    @param  max_frequency The fastest clock to try, in Hz
+ *    @returns The clock now in use, or 0 if the sensor did not answer at
+ *             any clock down to LSM6DS_SPI_MIN_HZ
+ */
+uint32_t Adafruit_LSM6DS::setSPIFrequency(uint32_t max_frequency) {
+  if (!spi_dev || !_chip_id) {
+    return 0;
+  }
+
+  uint32_t frequency = max_frequency;
+  if (frequency > LSM6DS_SPI_MAX_HZ) {
+    frequency = LSM6DS_SPI_MAX_HZ;
+  }
+  for (; frequency >= LSM6DS_SPI_MIN_HZ; frequency /= 2) {
+    delete spi_dev;
+    if (_spi) {
+      spi_dev = new Adafruit_SPIDevice(_spi_cs, frequency,
+                                       SPI_BITORDER_MSBFIRST, SPI_MODE0, _spi);
+    } else {
+      spi_dev = new Adafruit_SPIDevice(_spi_cs, _spi_sck, _spi_miso,
+                                       _spi_mosi, frequency,
+                                       SPI_BITORDER_MSBFIRST, SPI_MODE0);
+    }
+    _spi_frequency = frequency;
+    if (spi_dev->begin() && (chipID() == _chip_id) &&
+        (chipID() == _chip_id)) {
+      return frequency;
+    }
+  }
+  return 0;
+}
+
+/*!
+ *    @brief  Switches the sensor between 4-wire SPI and 3-wire SPI, where
+ *            SDI/SDO is one bidirectional data line. Once 3-wire is on, the
+ *            sensor only answers a bus that drives the shared line half
+ *            duplex, such as Adafruit_LSM6DS_LinuxSPI in 3-wire mode.
+ *    @param  enable True for 3-wire SPI, false for 4-wire
+ */
+void Adafruit_LSM6DS::enable3WireSPI(bool enable) {
+  writeBits(LSM6DS_CTRL3_C, 1, 3, enable);
+  _config_dirty = true;
+}
+
+/*!
+ *    @brief  Holds the chip's data-ready flags and interrupts low after a
+ *            configuration change until the filters have settled, so
+ *            DRDY-driven reads never see unsettled samples. Off by default,
+ *            as on the chip, so STATUS_REG and the INT pins keep their
+ *            usual timing unless asked.
+ *    @param  enable True to mask data-ready while settling
+ */
+void Adafruit_LSM6DS::setDataReadyMask(bool enable) {
+  writeBits(LSM6DS_CTRL4_C, 1, 3, enable);
+  _config_dirty = true;
+}
+
+/*!
+ *    @brief  Checks whether the accelerometer output has settled since the
+ *            last data rate, range or filter change. The driver tracks this
+ *            itself, so it holds whatever the chip supports.
+ *    @returns True once samples are valid again
+ */
+bool Adafruit_LSM6DS::accelSettled(void) { return settledAt(true, millis()); }
+
+/*!
+ *    @brief  Checks whether the gyro output has settled since the last data
+ *            rate or range change, including the start-up time from power
+ *            down
+ *    @returns True once samples are valid again
+ */
+bool Adafruit_LSM6DS::gyroSettled(void) { return settledAt(false, millis()); }
+
+/*!
+ *    @brief  Starts a settling window after a configuration change. An
+ *            earlier window that would end later is kept.
+ *    @param  accel True for the accelerometer, false for the gyro
+ *    @param  samples The samples at the current data rate to skip
+ *    @param  extra_ms Additional time to wait, eg. for the gyro to start
+ */
+void Adafruit_LSM6DS::startSettling(bool accel, uint16_t samples,
+                                    uint16_t extra_ms) {
+  lsm6ds_data_rate_t rate = accel ? accelRateBuffered : gyroRateBuffered;
+  uint32_t now = millis();
+  uint32_t settle_ms = extra_ms;
+  if (rate != LSM6DS_RATE_SHUTDOWN) {
+    settle_ms += (uint32_t)(samples * 1000.0f / _data_rate_arr[rate]) + 1;
+  }
+
+  uint32_t elapsed = now - _settle_start_ms[accel];
+  if ((elapsed < _settle_ms[accel]) &&
+      (_settle_ms[accel] - elapsed > settle_ms)) {
+    settle_ms = _settle_ms[accel] - elapsed;
+  }
+  if (settle_ms > 0xFFFF) {
+    settle_ms = 0xFFFF;
+  }
+  _settle_start_ms[accel] = now;
+  _settle_ms[accel] = settle_ms;
+
+#if LSM6DS_ENABLE_WINDOWS
+  // samples from before and after the change don't belong together
+  if (_windows[accel]) {
+    _windows[accel]->reset();
+  }
+#endif
+}
+
+/*!
+ *    @brief  Checks a sample time against the settling window. Samples
+ *            from before the last change were taken with the old settings
+ *            and count as settled.
+ *    @param  accel True for the accelerometer, false for the gyro
+ *    @param  ms The sample time in millis()
+ *    @returns True if a sample taken at `ms` is valid
+ */
+bool Adafruit_LSM6DS::settledAt(bool accel, uint32_t ms) {
+  return (uint32_t)(ms - _settle_start_ms[accel]) >= _settle_ms[accel];
+}
+
+#if LSM6DS_ENABLE_FIFO
+/*!
+ *    @brief  Sets up the FIFO. Both sensors are stored at the rate of the
+ *            faster one, with the slower one decimated to its own rate.
+ *            Switch to LSM6DS_FIFO_BYPASS first to empty the FIFO.
+ *    @param  mode The FIFO mode
+ *    @param  accel_batch The accelerometer rate to store, or
+ *            LSM6DS_RATE_SHUTDOWN to leave it out
+ *    @param  gyro_batch The gyro rate to store, or LSM6DS_RATE_SHUTDOWN to
+ *            leave it out
+ *    @returns True if the FIFO registers were written
+ */
+bool Adafruit_LSM6DS::configFIFO(lsm6ds_fifo_mode_t mode,
+                                 lsm6ds_data_rate_t accel_batch,
+                                 lsm6ds_data_rate_t gyro_batch) {
+  // DEC_FIFO codes for decimation by 1, 2, 4, 8, 16 and 32
+  static const uint8_t dec_codes[] = {1, 2, 4, 5, 6, 7};
+  uint8_t fifo_rate = (accel_batch > gyro_batch) ? accel_batch : gyro_batch;
+  uint8_t dec[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    uint8_t rate = i ? gyro_batch : accel_batch;
+    uint8_t step = fifo_rate - rate;
+    if (step > 5) {
+      step = 5;
+    }
+    dec[i] = (rate == LSM6DS_RATE_SHUTDOWN) ? 0 : dec_codes[step];
+  }
+
+  // FIFO_CTRL3, FIFO_CTRL4 (kept) and FIFO_CTRL5
+  uint8_t ctrl[3];
+  if (!readRegisters(LSM6DS_FIFO_CTRL3, ctrl, 3)) {
+    return false;
+  }
+  ctrl[0] = (ctrl[0] & 0xC0) | (dec[1] << 3) | dec[0];
+  ctrl[2] = (ctrl[2] & 0x80) | (fifo_rate << 3) | mode;
+  _config_dirty = true;
+  _fifo_accel_rate = accel_batch;
+  _fifo_gyro_rate = gyro_batch;
+  return writeRegisters(LSM6DS_FIFO_CTRL3, ctrl, 3);
+}
+
+/*!
+ *    @brief  Reads how much data is waiting in the FIFO
+ *    @returns The number of unread FIFO words, see fifoWordSize(), 0 on a
+ *             bus error
+ */
+uint16_t Adafruit_LSM6DS::fifoLevel(void) {
+  uint16_t level = 0;
+  readFIFOLevel(&level);
+  return level;
+}
+
+/*!
+ *    @brief  Reads how much data is waiting in the FIFO, telling a bus
+ *            error apart from an empty FIFO
+ *    @param  level Set to the number of unread FIFO words, see
+ *            fifoWordSize()
+ *    @returns False on a bus error
+ */
+bool Adafruit_LSM6DS::readFIFOLevel(uint16_t *level) {
+  uint8_t status[2];
+  if (!readRegisters(LSM6DS_FIFO_STATUS1, status, 2)) {
+    return false;
+  }
+  if (status[1] & 0x40) { // OVER_RUN
+    fifoOverrun();
+  }
+  *level = ((status[1] & 0x0F) << 8) | status[0];
+  return true;
+}
+
+/*!
+ *    @brief  Called when a FIFO status read finds that the FIFO overran,
+ *            so the oldest unread samples were overwritten. Counts it in
+ *            the stats.
+ */
+void Adafruit_LSM6DS::fifoOverrun(void) {
+#if LSM6DS_ENABLE_STATS
+  _stats.overruns++;
+#endif
+}
+
+/*!
+ *    @brief  The size of one FIFO word. On the LSM6DS3 family each word is
+ *            one 16-bit axis reading; sensors are stored as consecutive
+ *            X, Y, Z words, gyro before accelerometer.
+ *    @returns The number of bytes in a FIFO word
+ */
+uint8_t Adafruit_LSM6DS::fifoWordSize(void) { return 2; }
+
+/*!
+ *    @brief  The register FIFO words are read from
+ *    @returns The FIFO output register address
+ */
+uint8_t Adafruit_LSM6DS::fifoDataRegister(void) {
+  return LSM6DS_FIFO_DATA_OUT_L;
+}
+
+/*!
+ *    @brief  Reads waiting FIFO words into memory with one burst, in a
+ *            single chip select window on SPI. The output register address
+ *            rolls over inside the burst, so it can be any length.
+ *    @param  buffer Buffer for at least `max_words` * fifoWordSize() bytes
+ *    @param  max_words The most FIFO words to read
+ *    @returns The number of FIFO words read, 0 if none or on a bus error
+ */
+size_t Adafruit_LSM6DS::readFIFO(uint8_t *buffer, size_t max_words) {
+  size_t words = fifoLevel();
+  if (words > max_words) {
+    words = max_words;
+  }
+  if (!words) {
+    return 0;
+  }
+  return readFIFOData(buffer, words * fifoWordSize()) ? words : 0;
+}
+
+/*!
+ *    @brief  Reads waiting FIFO words straight into a ring buffer, with
+ *            one burst per contiguous run of free space: two when the
+ *            words wrap around the end of the ring. Words that don't fit
+ *            stay in the FIFO for the next call.
+ *    @param  ring The ring to fill, set up with this sensor's
+ *            fifoWordSize()
+ *    @returns The number of FIFO words added, 0 if none, if the word sizes
+ *            differ or on a bus error
+ */
+size_t Adafruit_LSM6DS::drainFIFO(Adafruit_LSM6DS_FIFORing *ring) {
+  uint8_t word_size = fifoWordSize();
+  if (ring->wordSize() != word_size) {
+    return 0;
+  }
+  size_t words = ring->space();
+  if (!words) {
+    return 0;
+  }
+  size_t level = fifoLevel();
+  if (words > level) {
+    words = level;
+  }
+
+  size_t done = 0;
+  while (done < words) {
+    size_t run;
+    uint8_t *dest = ring->reserve(&run);
+    if (run > words - done) {
+      run = words - done;
+    }
+    if (!readFIFOData(dest, run * word_size)) {
+      break;
+    }
+    ring->commit(run);
+    done += run;
+  }
+  return done;
+}
+
+/*!
+ *    @brief  Reads bytes from the FIFO output port in one burst, through
+ *            the bulk reader if one is set
+ *    @param  buffer Buffer for `len` bytes
+ *    @param  len The number of bytes, a whole number of FIFO words
+ *    @returns True if the read succeeded
+ */
+bool Adafruit_LSM6DS::readFIFOData(uint8_t *buffer, size_t len) {
+  if (!_bulk_reader) {
+    bool ok = readRegisters(fifoDataRegister(), buffer, len);
+    if (ok) {
+      _fifo_bytes_read += len;
+    }
+    return ok;
+  }
+  bool ok = _bulk_reader(_bulk_context, fifoDataRegister(), buffer, len);
+  if (ok) {
+    _fifo_bytes_read += len;
+  }
+#if LSM6DS_ENABLE_STATS
+  _stats.transactions++;
+  if (ok) {
+    _stats.bytes += len;
+  } else {
+    _stats.failures++;
+  }
+#endif
+  return ok;
+}
+
+/*!
+ *    @brief  Sets a function to move FIFO bursts in place of the driver's own
+ *            bus read, so a large FIFO read can run on DMA
+ *    @param  reader The function to call, or NULL to use the bus
+ *    @param  context Passed through to `reader`
+ */
+void Adafruit_LSM6DS::setBulkReader(lsm6ds_bulk_read_t reader,
+                                    void *context) {
+  _bulk_reader = reader;
+  _bulk_context = context;
+}
+
+/*!
+ *    @brief  Sets the FIFO level that raises the watermark flag and, once
+ *            routed with configFIFOInt1(), the INT1 pin
+ *    @param  words The level in FIFO words, see fifoWordSize(). Capped at
+ *            2047.
+ *    @returns True if the registers were written
+ */
+bool Adafruit_LSM6DS::setFIFOWatermark(uint16_t words) {
+  if (words > 0x7FF) {
+    words = 0x7FF;
+  }
+  uint8_t fth = words & 0xFF;
+  _config_dirty = true;
+  return writeRegisters(LSM6DS_FIFO_CTRL1, &fth, 1) &&
+         writeBits(LSM6DS_FIFO_CTRL2, 3, 0, words >> 8);
+}
+
+/*!
+ *    @brief  Routes the FIFO flags to the INT1 pin. configInt1() clears
+ *            these, so call this after it.
+ *    @param  watermark True to signal a FIFO level at or above the
+ *            watermark
+ *    @param  overrun True to signal that unread data was overwritten
+ *    @param  full True to signal that the FIFO is full
+ */
+void Adafruit_LSM6DS::configFIFOInt1(bool watermark, bool overrun, bool full) {
+  writeBits(LSM6DS_INT1_CTRL, 3, 3, (full << 2) | (overrun << 1) | watermark);
+  _config_dirty = true;
+}
+
+/*!
+ *    @brief  Lets the sensor collect samples in the FIFO while the host
+ *            sleeps. Empties the FIFO, sets the watermark and routes it to
+ *            INT1, then starts continuous batching. The INT1 level stays
+ *            high until the FIFO is drained below the watermark, so it can
+ *            wake the host from a level-triggered sleep. The sensors' own
+ *            data rates must be at least the batch rates.
+ *    @param  accel_batch The accelerometer rate to store, or
+ *            LSM6DS_RATE_SHUTDOWN to leave it out
+ *    @param  gyro_batch The gyro rate to store, or LSM6DS_RATE_SHUTDOWN to
+ *            leave it out
+ *    @param  watermark The FIFO level in words that wakes the host, or 0 to
+ *            wake only when the FIFO is full
+ *    @returns True if the registers were written
+ */
+bool Adafruit_LSM6DS::startBatching(lsm6ds_data_rate_t accel_batch,
+                                    lsm6ds_data_rate_t gyro_batch,
+                                    uint16_t watermark) {
+  if (!configFIFO(LSM6DS_FIFO_BYPASS, accel_batch, gyro_batch) ||
+      !setFIFOWatermark(watermark)) {
+    return false;
+  }
+  configFIFOInt1(watermark, false, !watermark);
+  return configFIFO(LSM6DS_FIFO_CONTINUOUS, accel_batch, gyro_batch);
+}
+
+/*!
+ *    @brief  Drains everything batched since startBatching() in one call,
+ *            handing the events to `callback` a chunk at a time. Samples
+ *            left in the FIFO after a chunk are counted into its
+ *            timestamps, so every chunk is timed from when it was sampled.
+ *            It stops once as many words as were waiting on entry have
+ *            been read, so a FIFO that refills as fast as it is read
+ *            can't keep the call going. Chunks that settling after a
+ *            configuration change leaves empty are read but not handed
+ *            over.
+ *    @param  accel Scratch array for the accelerometer events, or NULL to
+ *            discard them
+ *    @param  gyro Scratch array for the gyro events, or NULL to discard them
+ *    @param  count The size of each array, at least 1
+ *    @param  callback Called with each chunk of events
+ *    @returns The number of events drained, 0 if `count` is 0 or
+ *            `callback` is NULL
+ */
+size_t Adafruit_LSM6DS::resumeBatch(sensors_event_t *accel,
+                                    sensors_event_t *gyro, size_t count,
+                                    lsm6ds_batch_callback_t callback) {
+  uint8_t fifo_rate = (_fifo_accel_rate > _fifo_gyro_rate) ? _fifo_accel_rate
+                                                           : _fifo_gyro_rate;
+  if ((fifo_rate == LSM6DS_RATE_SHUTDOWN) || (!accel && !gyro) || !count ||
+      !callback) {
+    return 0;
+  }
+  // FIFO words stored per tick of the fastest batched sensor
+  uint8_t words_per_sample = (6 + fifoWordSize() - 1) / fifoWordSize();
+  float words_per_tick = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    uint8_t rate = i ? _fifo_accel_rate : _fifo_gyro_rate;
+    if (rate != LSM6DS_RATE_SHUTDOWN) {
+      words_per_tick += (float)words_per_sample / (1 << (fifo_rate - rate));
+    }
+  }
+  float ms_per_word = 1000.0f / _data_rate_arr[fifo_rate] / words_per_tick;
+
+  prepareEvents(accel, gyro, count);
+  size_t drained = 0;
+  uint32_t backlog = (uint32_t)fifoLevel() * fifoWordSize();
+  while (backlog) {
+    size_t n_accel = count, n_gyro = count;
+    uint32_t bytes_before = _fifo_bytes_read;
+    _resuming = true; // finished below, once the times are corrected
+    bool ok = getEvents(accel, &n_accel, gyro, &n_gyro);
+    _resuming = false;
+    uint32_t bytes = _fifo_bytes_read - bytes_before;
+    backlog = (bytes < backlog) ? backlog - bytes : 0;
+    if (!accel) {
+      n_accel = 0;
+    }
+    if (!gyro) {
+      n_gyro = 0;
+    }
+
+    // getEvents() times the newest sample read as now, but anything still
+    // in the FIFO was sampled after it
+    uint16_t left = fifoLevel();
+    int32_t shift = (int32_t)(left * ms_per_word + 0.5f);
+    for (size_t i = 0; i < n_accel; i++) {
+      accel[i].timestamp -= shift;
+    }
+    for (size_t i = 0; i < n_gyro; i++) {
+      gyro[i].timestamp -= shift;
+    }
+    n_accel = finishEvents(accel, n_accel, true);
+    n_gyro = finishEvents(gyro, n_gyro, false);
+    // a chunk of settling samples can finish empty with backlog left
+    if (n_accel || n_gyro) {
+      callback(accel, n_accel, gyro, n_gyro);
+      drained += n_accel + n_gyro;
+    }
+
+    if (!ok || !bytes || !left) {
+      break;
+    }
+  }
+  return drained;
+}
+
+/*!
+ *    @brief  Steps to the next data set in the LSM6DS3 family FIFO pattern.
+ *            Sets are numbered tick * 2 + sensor, gyro (0) before accel (1)
+ *            within a tick of the FIFO rate, and the pattern repeats every
+ *            `cycle` ticks.
+ *    @param  set The current set
+ *    @param  dec The gyro and accel decimation factors, 0 if not stored
+ *    @param  cycle The pattern length in ticks, the largest factor
+ *    @param  ticks Incremented by the ticks between the two sets
+ *    @returns The next set
+ */
+static uint8_t nextFIFOSet(uint8_t set, const uint8_t *dec, uint8_t cycle,
+                           uint32_t *ticks) {
+  uint8_t next = set;
+  do {
+    next = (next + 1) % (cycle * 2);
+  } while (!dec[next & 1] || ((next >> 1) % dec[next & 1]));
+  *ticks += (next > set) ? (next >> 1) - (set >> 1)
+                         : (next >> 1) + cycle - (set >> 1);
+  return next;
+}
+
+/*!
+ *    @brief  Drains the FIFO into arrays of Unified Sensor events, with one
+ *            status read and a burst per LSM6DS_EVENTS_CHUNK bytes. Only
+ *            the timestamps and readings are written, so call
+ *            prepareEvents() on the arrays first. With
+ *            enableTempCompensation() on, the bias for the latest
+ *            temperature is removed, see compensateEvents().
+ *    @param  accel Array for the accelerometer events, or NULL to discard
+ *            them
+ *    @param  accel_count Holds the size of `accel`, set to the number of
+ *            events stored
+ *    @param  gyro Array for the gyro events, or NULL to discard them
+ *    @param  gyro_count Holds the size of `gyro`, set to the number of
+ *            events stored
+ *    @returns False on a bus error; the events read before it are kept
+ */
+bool Adafruit_LSM6DS::getEvents(sensors_event_t *accel, size_t *accel_count,
+                                sensors_event_t *gyro, size_t *gyro_count) {
+  size_t max_accel = accel ? *accel_count : 0;
+  size_t max_gyro = gyro ? *gyro_count : 0;
+  size_t n_accel = 0, n_gyro = 0;
+
+  uint8_t fifo_rate = (_fifo_accel_rate > _fifo_gyro_rate) ? _fifo_accel_rate
+                                                           : _fifo_gyro_rate;
+  if ((fifo_rate == LSM6DS_RATE_SHUTDOWN) || (!accel && !gyro)) {
+    if (accel) {
+      *accel_count = 0;
+    }
+    if (gyro) {
+      *gyro_count = 0;
+    }
+    return true;
+  }
+  // the same decimation configFIFO() set up, gyro first
+  uint8_t dec[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    uint8_t rate = i ? _fifo_accel_rate : _fifo_gyro_rate;
+    uint8_t step = fifo_rate - rate;
+    if (step > 5) {
+      step = 5;
+    }
+    dec[i] = (rate == LSM6DS_RATE_SHUTDOWN) ? 0 : 1 << step;
+  }
+  uint8_t cycle = (dec[0] > dec[1]) ? dec[0] : dec[1];
+
+  uint32_t now = millis();
+  uint8_t status[4];
+  if (!readRegisters(LSM6DS_FIFO_STATUS1, status, 4)) {
+    return false;
+  }
+  if (status[1] & 0x40) { // OVER_RUN
+    fifoOverrun();
+  }
+  uint16_t level = ((status[1] & 0x0F) << 8) | status[0];
+  uint16_t pattern = ((status[3] & 0x03) << 8) | status[2];
+
+  // find the set holding the next word, and drop the rest of a set that
+  // was partly read before
+  uint32_t tick = 0;
+  uint8_t set = nextFIFOSet(cycle * 2 - 1, dec, cycle, &tick);
+  for (; pattern >= 3; pattern -= 3) {
+    set = nextFIFOSet(set, dec, cycle, &tick);
+  }
+  uint8_t buffer[LSM6DS_EVENTS_CHUNK];
+  if (pattern) {
+    uint8_t rest = 3 - pattern;
+    if ((level < rest) || !readFIFOData(buffer, rest * 2)) {
+      level = 0;
+    } else {
+      level -= rest;
+      set = nextFIFOSet(set, dec, cycle, &tick);
+    }
+  }
+  tick = 0;
+
+  const float scale[2] = {gyroScale(), accelScale()};
+#if LSM6DS_ENABLE_WINDOWS
+  Adafruit_LSM6DS_Window *feed[2] = {gyroSettled() ? _windows[0] : NULL,
+                                     accelSettled() ? _windows[1] : NULL};
+#endif
+  size_t sets = level / 3;
+  uint32_t last_tick = 0;
+  bool ok = true;
+  while (sets) {
+    // a chunk holds at most `count` sets of either sensor
+    size_t count = sets;
+    if (count > LSM6DS_EVENTS_CHUNK / 6) {
+      count = LSM6DS_EVENTS_CHUNK / 6;
+    }
+    if (gyro && dec[0] && (count > max_gyro - n_gyro)) {
+      count = max_gyro - n_gyro;
+    }
+    if (accel && dec[1] && (count > max_accel - n_accel)) {
+      count = max_accel - n_accel;
+    }
+    if (!count) {
+      break;
+    }
+    if (!readFIFOData(buffer, count * 6)) {
+      ok = false;
+      break;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      int16_t xyz[3];
+      lsm6ds_decode_raw(buffer + i * 6, xyz, 3);
+#if LSM6DS_ENABLE_WINDOWS
+      if (feed[set & 1]) {
+        feed[set & 1]->push(xyz);
+      }
+#endif
+      sensors_event_t *event = NULL;
+      if ((set & 1) && accel) {
+        event = &accel[n_accel++];
+      } else if (!(set & 1) && gyro) {
+        event = &gyro[n_gyro++];
+      }
+      if (event) {
+        event->timestamp = tick;
+        for (uint8_t axis = 0; axis < 3; axis++) {
+          event->data[axis] = xyz[axis] * scale[set & 1];
+        }
+#if LSM6DS_ENABLE_CAPTURE
+        // kept raw until captureEvents() knows when it was sampled
+        if (_captures[set & 1]) {
+          _captures[set & 1]->stage(xyz);
+        }
+#endif
+      }
+      last_tick = tick;
+      set = nextFIFOSet(set, dec, cycle, &tick);
+    }
+    sets -= count;
+  }
+
+  if (accel) {
+    stampEvents(accel, n_accel, last_tick, now, (lsm6ds_data_rate_t)fifo_rate);
+    *accel_count = finishEvents(accel, n_accel, true);
+  }
+  if (gyro) {
+    stampEvents(gyro, n_gyro, last_tick, now, (lsm6ds_data_rate_t)fifo_rate);
+    *gyro_count = finishEvents(gyro, n_gyro, false);
+  }
+  return ok;
+}
+
+/*!
+ *    @brief  Turns FIFO tick counts, stored in the event timestamps, into
+ *            millisecond timestamps, with the newest tick at `now`
+ *    @param  events The events to update
+ *    @param  count The number of events
+ *    @param  last_tick The tick of the newest sample read
+ *    @param  now millis() when the FIFO was drained
+ *    @param  rate The rate ticks count at
+ */
+void Adafruit_LSM6DS::stampEvents(sensors_event_t *events, size_t count,
+                                  uint32_t last_tick, uint32_t now,
+                                  lsm6ds_data_rate_t rate) {
+  float period_ms = 1000.0f / _data_rate_arr[rate];
+  for (size_t i = 0; i < count; i++) {
+    uint32_t age = last_tick - (uint32_t)events[i].timestamp;
+    events[i].timestamp = now - (uint32_t)(age * period_ms + 0.5f);
+  }
+}
+
+/*!
+ *    @brief  Removes events sampled while the sensor was still settling
+ *            after a configuration change, keeping the rest in order
+ *    @param  events The timestamped events
+ *    @param  count The number of events
+ *    @param  accel True for accelerometer events, false for gyro events
+ *    @returns The number of events kept
+ */
+size_t Adafruit_LSM6DS::dropUnsettled(sensors_event_t *events, size_t count,
+                                      bool accel) {
+  size_t kept = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (settledAt(accel, events[i].timestamp)) {
+      if (kept != i) {
+        events[kept] = events[i];
+      }
+      kept++;
+    }
+  }
+  return kept;
+}
+
+/*!
+ *    @brief  Finishes timestamped events drained from the FIFO: removes
+ *            the temperature bias, records their raw samples into any
+ *            attached capture and drops the ones from a settling window.
+ *            Left to resumeBatch() while it drains, since it corrects the
+ *            times first.
+ *    @param  events The timestamped events
+ *    @param  count The number of events
+ *    @param  accel True for accelerometer events, false for gyro events
+ *    @returns The number of events kept
+ */
+size_t Adafruit_LSM6DS::finishEvents(sensors_event_t *events, size_t count,
+                                     bool accel) {
+  if (_resuming) {
+    return count;
+  }
+#if LSM6DS_ENABLE_TEMP_COMP
+  compensateEvents(events, count, accel);
+#endif
+#if LSM6DS_ENABLE_CAPTURE
+  captureEvents(events, count, accel);
+#endif
+  return dropUnsettled(events, count, accel);
+}
+
+#if LSM6DS_ENABLE_CAPTURE
+/*!
+ *    @brief  Records the raw samples staged while decoding drained events
+ *            into the attached capture, with the events' timestamps.
+ *            Samples from the settling window are dropped, so call it
+ *            before dropUnsettled().
+ *    @param  events The timestamped events, one per staged sample
+ *    @param  count The number of events
+ *    @param  accel True for accelerometer events, false for gyro events
+ */
+void Adafruit_LSM6DS::captureEvents(const sensors_event_t *events,
+                                    size_t count, bool accel) {
+  Adafruit_LSM6DS_Capture *capture = _captures[accel];
+  if (!capture) {
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    capture->stamp(events[i].timestamp,
+                   settledAt(accel, events[i].timestamp));
+  }
+}
+#endif
+#endif
+
 /**************************************************************************/
 /*!
     @brief Resets the sensor to its power-on state, clearing all registers and
    memory
 */
 void Adafruit_LSM6DS::reset(void) {
+  writeBits(LSM6DS_CTRL3_C, 1, 0, true);
 
-  Adafruit_BusIO_Register ctrl3 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL3_C);
-
-  Adafruit_BusIO_RegisterBits sw_reset =
-      Adafruit_BusIO_RegisterBits(&ctrl3, 1, 0);
-
-  // Adafruit_BusIO_RegisterBits boot = Adafruit_BusIO_RegisterBits(&ctrl3, 1,
-  // 7);
-
-  sw_reset.write(true);
-
-  while (sw_reset.read()) {
+  while (readBits(LSM6DS_CTRL3_C, 1, 0)) {
     delay(1);
   }
 }
@@ -213,6 +1364,10 @@ void Adafruit_LSM6DS::reset(void) {
     @return Adafruit_Sensor pointer to temperature sensor
  */
 Adafruit_Sensor *Adafruit_LSM6DS::getTemperatureSensor(void) {
+  // created on first use, so sketches that never ask pay no heap for it
+  if (!temp_sensor) {
+    temp_sensor = new Adafruit_LSM6DS_Temp(this);
+  }
   return temp_sensor;
 }
 
@@ -222,6 +1377,9 @@ Adafruit_Sensor *Adafruit_LSM6DS::getTemperatureSensor(void) {
     @return Adafruit_Sensor pointer to accelerometer sensor
  */
 Adafruit_Sensor *Adafruit_LSM6DS::getAccelerometerSensor(void) {
+  if (!accel_sensor) {
+    accel_sensor = new Adafruit_LSM6DS_Accelerometer(this);
+  }
   return accel_sensor;
 }
 
@@ -229,7 +1387,75 @@ Adafruit_Sensor *Adafruit_LSM6DS::getAccelerometerSensor(void) {
     @brief  Gets an Adafruit Unified Sensor object for the gyro sensor component
     @return Adafruit_Sensor pointer to gyro sensor
  */
-Adafruit_Sensor *Adafruit_LSM6DS::getGyroSensor(void) { return gyro_sensor; }
+Adafruit_Sensor *Adafruit_LSM6DS::getGyroSensor(void) {
+  if (!gyro_sensor) {
+    gyro_sensor = new Adafruit_LSM6DS_Gyro(this);
+  }
+  return gyro_sensor;
+}
+
+#if LSM6DS_ENABLE_STATS
+/*!
+    @brief  Gets the bus and sample counters collected since the last
+    resetStats()
+    @param  stats The struct to copy the counters to
+ */
+void Adafruit_LSM6DS::getStats(lsm6ds_stats_t *stats) { *stats = _stats; }
+
+/*!
+    @brief  Clears the bus and sample counters
+ */
+void Adafruit_LSM6DS::resetStats(void) {
+  memset(&_stats, 0, sizeof(_stats));
+  _last_sample_us = 0;
+}
+#endif
+
+#if LSM6DS_ENABLE_WINDOWS
+/*!
+    @brief  Feeds statistics windows with the raw samples of every
+    reading and every FIFO sample getEvents() drains. Samples taken while a
+    sensor settles are skipped, and a window is reset whenever its sensor's
+    data rate, range or filter changes.
+    @param  accel Window for the accelerometer, or NULL for none
+    @param  gyro Window for the gyro, or NULL for none
+ */
+void Adafruit_LSM6DS::attachWindows(Adafruit_LSM6DS_Window *accel,
+                                    Adafruit_LSM6DS_Window *gyro) {
+  _windows[0] = gyro;
+  _windows[1] = accel;
+}
+#endif
+
+#if LSM6DS_ENABLE_CAPTURE
+/*!
+    @brief  Records the raw samples of every reading and every FIFO event
+    getEvents() returns into capture buffers, and triggers them when
+    pollEvents() or shake() sees one of the given events
+    @param  accel Capture for the accelerometer, or NULL for none
+    @param  gyro Capture for the gyro, or NULL for none
+    @param  events lsm6ds_event_t flags of the events that trigger both
+ */
+void Adafruit_LSM6DS::attachCaptures(Adafruit_LSM6DS_Capture *accel,
+                                     Adafruit_LSM6DS_Capture *gyro,
+                                     uint8_t events) {
+  _captures[0] = gyro;
+  _captures[1] = accel;
+  _capture_events = events;
+}
+
+/*!
+    @brief  Triggers the attached captures
+    @param  cause The lsm6ds_event_t flags that fired
+ */
+void Adafruit_LSM6DS::triggerCaptures(uint8_t cause) {
+  for (uint8_t i = 0; i < 2; i++) {
+    if (_captures[i]) {
+      _captures[i]->trigger(cause);
+    }
+  }
+}
+#endif
 
 /**************************************************************************/
 /*!
@@ -252,7 +1478,9 @@ Adafruit_Sensor *Adafruit_LSM6DS::getGyroSensor(void) { return gyro_sensor; }
 bool Adafruit_LSM6DS::getEvent(sensors_event_t *accel, sensors_event_t *gyro,
                                sensors_event_t *temp) {
   uint32_t t = millis();
-  _read();
+  if (!readScaled()) {
+    return false;
+  }
 
   // use helpers to fill in the events
   fillAccelEvent(accel, t);
@@ -261,13 +1489,42 @@ bool Adafruit_LSM6DS::getEvent(sensors_event_t *accel, sensors_event_t *gyro,
   return true;
 }
 
+#if LSM6DS_ENABLE_FIFO
+/**************************************************************************/
+/*!
+    @brief  Fills in the parts of Unified Sensor events that are the same
+    for every reading, so getEvents() only has to write timestamps and
+    readings. Call once per array.
+    @param  accel Array of accelerometer events, or NULL
+    @param  gyro Array of gyro events, or NULL
+    @param  count The number of events in each array
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::prepareEvents(sensors_event_t *accel,
+                                    sensors_event_t *gyro, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (accel) {
+      fillAccelEvent(&accel[i], 0);
+    }
+    if (gyro) {
+      fillGyroEvent(&gyro[i], 0);
+    }
+  }
+}
+#endif
+
 void Adafruit_LSM6DS::fillTempEvent(sensors_event_t *temp, uint32_t timestamp) {
   memset(temp, 0, sizeof(sensors_event_t));
   temp->version = sizeof(sensors_event_t);
   temp->sensor_id = _sensorid_temp;
   temp->type = SENSOR_TYPE_AMBIENT_TEMPERATURE;
   temp->timestamp = timestamp;
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_TEMP);
   temp->temperature = temperature;
+#else
+  temp->temperature = (rawTemp / (float)temperature_sensitivity) + 25.0;
+#endif
 }
 
 void Adafruit_LSM6DS::fillGyroEvent(sensors_event_t *gyro, uint32_t timestamp) {
@@ -276,9 +1533,17 @@ void Adafruit_LSM6DS::fillGyroEvent(sensors_event_t *gyro, uint32_t timestamp) {
   gyro->sensor_id = _sensorid_gyro;
   gyro->type = SENSOR_TYPE_GYROSCOPE;
   gyro->timestamp = timestamp;
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_GYRO);
   gyro->gyro.x = gyroX;
   gyro->gyro.y = gyroY;
   gyro->gyro.z = gyroZ;
+#else
+  float scale = gyroScale();
+  gyro->gyro.x = rawGyroX * scale;
+  gyro->gyro.y = rawGyroY * scale;
+  gyro->gyro.z = rawGyroZ * scale;
+#endif
 }
 
 void Adafruit_LSM6DS::fillAccelEvent(sensors_event_t *accel,
@@ -288,9 +1553,17 @@ void Adafruit_LSM6DS::fillAccelEvent(sensors_event_t *accel,
   accel->sensor_id = _sensorid_accel;
   accel->type = SENSOR_TYPE_ACCELEROMETER;
   accel->timestamp = timestamp;
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_ACCEL);
   accel->acceleration.x = accX;
   accel->acceleration.y = accY;
   accel->acceleration.z = accZ;
+#else
+  float scale = accelScale();
+  accel->acceleration.x = rawAccX * scale;
+  accel->acceleration.y = rawAccY * scale;
+  accel->acceleration.z = rawAccZ * scale;
+#endif
 }
 
 /**************************************************************************/
@@ -299,14 +1572,9 @@ void Adafruit_LSM6DS::fillAccelEvent(sensors_event_t *accel,
     @returns The the accelerometer data rate.
 */
 lsm6ds_data_rate_t Adafruit_LSM6DS::getAccelDataRate(void) {
+  accelRateBuffered = (lsm6ds_data_rate_t)readBits(LSM6DS_CTRL1_XL, 4, 4);
 
-  Adafruit_BusIO_Register ctrl1 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL1_XL);
-
-  Adafruit_BusIO_RegisterBits accel_data_rate =
-      Adafruit_BusIO_RegisterBits(&ctrl1, 4, 4);
-
-  return (lsm6ds_data_rate_t)accel_data_rate.read();
+  return accelRateBuffered;
 }
 
 /**************************************************************************/
@@ -316,14 +1584,11 @@ lsm6ds_data_rate_t Adafruit_LSM6DS::getAccelDataRate(void) {
             The the accelerometer data rate. Must be a `lsm6ds_data_rate_t`.
 */
 void Adafruit_LSM6DS::setAccelDataRate(lsm6ds_data_rate_t data_rate) {
+  writeBits(LSM6DS_CTRL1_XL, 4, 4, data_rate);
+  _config_dirty = true;
 
-  Adafruit_BusIO_Register ctrl1 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL1_XL);
-
-  Adafruit_BusIO_RegisterBits accel_data_rate =
-      Adafruit_BusIO_RegisterBits(&ctrl1, 4, 4);
-
-  accel_data_rate.write(data_rate);
+  accelRateBuffered = data_rate;
+  startSettling(true, LSM6DS_SETTLE_SAMPLES);
 }
 
 /**************************************************************************/
@@ -332,14 +1597,7 @@ void Adafruit_LSM6DS::setAccelDataRate(lsm6ds_data_rate_t data_rate) {
     @returns The the accelerometer measurement range.
 */
 lsm6ds_accel_range_t Adafruit_LSM6DS::getAccelRange(void) {
-
-  Adafruit_BusIO_Register ctrl1 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL1_XL);
-
-  Adafruit_BusIO_RegisterBits accel_range =
-      Adafruit_BusIO_RegisterBits(&ctrl1, 2, 2);
-
-  accelRangeBuffered = (lsm6ds_accel_range_t)accel_range.read();
+  accelRangeBuffered = (lsm6ds_accel_range_t)readBits(LSM6DS_CTRL1_XL, 2, 2);
 
   return accelRangeBuffered;
 }
@@ -349,16 +1607,14 @@ lsm6ds_accel_range_t Adafruit_LSM6DS::getAccelRange(void) {
     @param new_range The `lsm6ds_accel_range_t` range to set.
 */
 void Adafruit_LSM6DS::setAccelRange(lsm6ds_accel_range_t new_range) {
-
-  Adafruit_BusIO_Register ctrl1 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL1_XL);
-
-  Adafruit_BusIO_RegisterBits accel_range =
-      Adafruit_BusIO_RegisterBits(&ctrl1, 2, 2);
-
-  accel_range.write(new_range);
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_ACCEL); // the last reading used the old range
+#endif
+  writeBits(LSM6DS_CTRL1_XL, 2, 2, new_range);
+  _config_dirty = true;
 
   accelRangeBuffered = new_range;
+  startSettling(true, 1);
 }
 
 /**************************************************************************/
@@ -367,14 +1623,9 @@ void Adafruit_LSM6DS::setAccelRange(lsm6ds_accel_range_t new_range) {
     @returns The the gyro data rate.
 */
 lsm6ds_data_rate_t Adafruit_LSM6DS::getGyroDataRate(void) {
+  gyroRateBuffered = (lsm6ds_data_rate_t)readBits(LSM6DS_CTRL2_G, 4, 4);
 
-  Adafruit_BusIO_Register ctrl2 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL2_G);
-
-  Adafruit_BusIO_RegisterBits gyro_data_rate =
-      Adafruit_BusIO_RegisterBits(&ctrl2, 4, 4);
-
-  return (lsm6ds_data_rate_t)gyro_data_rate.read();
+  return gyroRateBuffered;
 }
 
 /**************************************************************************/
@@ -384,14 +1635,13 @@ lsm6ds_data_rate_t Adafruit_LSM6DS::getGyroDataRate(void) {
             The the gyro data rate. Must be a `lsm6ds_data_rate_t`.
 */
 void Adafruit_LSM6DS::setGyroDataRate(lsm6ds_data_rate_t data_rate) {
+  writeBits(LSM6DS_CTRL2_G, 4, 4, data_rate);
+  _config_dirty = true;
 
-  Adafruit_BusIO_Register ctrl2 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL2_G);
-
-  Adafruit_BusIO_RegisterBits gyro_data_rate =
-      Adafruit_BusIO_RegisterBits(&ctrl2, 4, 4);
-
-  gyro_data_rate.write(data_rate);
+  bool was_off = (gyroRateBuffered == LSM6DS_RATE_SHUTDOWN);
+  gyroRateBuffered = data_rate;
+  startSettling(false, LSM6DS_SETTLE_SAMPLES,
+                was_off ? LSM6DS_GYRO_TURN_ON_MS : 0);
 }
 
 /**************************************************************************/
@@ -400,14 +1650,7 @@ void Adafruit_LSM6DS::setGyroDataRate(lsm6ds_data_rate_t data_rate) {
     @returns The the gyro range.
 */
 lsm6ds_gyro_range_t Adafruit_LSM6DS::getGyroRange(void) {
-
-  Adafruit_BusIO_Register ctrl2 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL2_G);
-
-  Adafruit_BusIO_RegisterBits gyro_range =
-      Adafruit_BusIO_RegisterBits(&ctrl2, 4, 0);
-
-  gyroRangeBuffered = (lsm6ds_gyro_range_t)gyro_range.read();
+  gyroRangeBuffered = (lsm6ds_gyro_range_t)readBits(LSM6DS_CTRL2_G, 4, 0);
 
   return gyroRangeBuffered;
 }
@@ -418,18 +1661,17 @@ lsm6ds_gyro_range_t Adafruit_LSM6DS::getGyroRange(void) {
     @param new_range The `lsm6ds_gyro_range_t` to set.
 */
 void Adafruit_LSM6DS::setGyroRange(lsm6ds_gyro_range_t new_range) {
-
-  Adafruit_BusIO_Register ctrl2 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL2_G);
-
-  Adafruit_BusIO_RegisterBits gyro_range =
-      Adafruit_BusIO_RegisterBits(&ctrl2, 4, 0);
-
-  gyro_range.write(new_range);
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_GYRO); // the last reading used the old range
+#endif
+  writeBits(LSM6DS_CTRL2_G, 4, 0, new_range);
+  _config_dirty = true;
 
   gyroRangeBuffered = new_range;
+  startSettling(false, 1);
 }
 
+#if LSM6DS_ENABLE_FILTERS
 /**************************************************************************/
 /*!
     @brief Enables the high pass filter and/or slope filter
@@ -439,40 +1681,71 @@ void Adafruit_LSM6DS::setGyroRange(lsm6ds_gyro_range_t new_range) {
 /**************************************************************************/
 void Adafruit_LSM6DS::highPassFilter(bool filter_enabled,
                                      lsm6ds_hp_filter_t filter) {
-  Adafruit_BusIO_Register ctrl8 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL8_XL);
-  Adafruit_BusIO_RegisterBits HPF_en =
-      Adafruit_BusIO_RegisterBits(&ctrl8, 1, 2);
-  Adafruit_BusIO_RegisterBits HPF_filter =
-      Adafruit_BusIO_RegisterBits(&ctrl8, 2, 5);
-  HPF_en.write(filter_enabled);
-  HPF_filter.write(filter);
+  writeBits(LSM6DS_CTRL8_XL, 1, 2, filter_enabled);
+  writeBits(LSM6DS_CTRL8_XL, 2, 5, filter);
+  _config_dirty = true;
+
+  // the filter output takes about one cutoff divisor of samples to settle
+  static const uint16_t divisors[] = {50, 100, 9, 400};
+  startSettling(true,
+                filter_enabled ? divisors[filter] : LSM6DS_SETTLE_SAMPLES);
 }
 
-/******************* Adafruit_Sensor functions *****************/
+/**************************************************************************/
 /*!
- *     @brief  Updates the measurement data for all sensors simultaneously
- */
+    @brief Enables the accelerometer's second digital low pass filter. Use it
+    as the on-chip anti-aliasing stage when decimating the output further
+    with Adafruit_LSM6DS_Decimator.
+    @param filter_enabled Whether to enable the LPF2 filter
+    @param filter The lsm6ds_hp_filter_t that sets the data rate divisor. The
+    cutoff setting is shared with highPassFilter()
+*/
 /**************************************************************************/
-void Adafruit_LSM6DS::_read(void) {
-  // get raw readings
-  Adafruit_BusIO_Register data_reg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_OUT_TEMP_L, 14);
-
-  uint8_t buffer[14];
-  data_reg.read(buffer, 14);
-
-  rawTemp = buffer[1] << 8 | buffer[0];
-  temperature = (rawTemp / temperature_sensitivity) + 25.0;
-
-  rawGyroX = buffer[3] << 8 | buffer[2];
-  rawGyroY = buffer[5] << 8 | buffer[4];
-  rawGyroZ = buffer[7] << 8 | buffer[6];
+void Adafruit_LSM6DS::lowPassFilter2(bool filter_enabled,
+                                     lsm6ds_hp_filter_t filter) {
+  writeBits(LSM6DS_CTRL8_XL, 2, 5, filter);
+  writeBits(LSM6DS_CTRL8_XL, 1, 7, filter_enabled);
+  _config_dirty = true;
+
+  // settling takes about a third of the cutoff divisor in samples
+  static const uint16_t divisors[] = {50, 100, 9, 400};
+  startSettling(true, filter_enabled ? divisors[filter] / 3 + 1
+                                     : LSM6DS_SETTLE_SAMPLES);
+}
+#endif
 
-  rawAccX = buffer[9] << 8 | buffer[8];
-  rawAccY = buffer[11] << 8 | buffer[10];
-  rawAccZ = buffer[13] << 8 | buffer[12];
+/**************************************************************************/
+/*!
+    @brief Gets the accelerometer scale factor for the current range
+    @returns The acceleration of one raw LSB in m/s^2
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS::accelScale(void) {
+  float accel_scale = 1; // range is in milli-g per bit!
+  switch (accelRangeBuffered) {
+  case LSM6DS_ACCEL_RANGE_16_G:
+    accel_scale = 0.488;
+    break;
+  case LSM6DS_ACCEL_RANGE_8_G:
+    accel_scale = 0.244;
+    break;
+  case LSM6DS_ACCEL_RANGE_4_G:
+    accel_scale = 0.122;
+    break;
+  case LSM6DS_ACCEL_RANGE_2_G:
+    accel_scale = 0.061;
+    break;
+  }
+  return accel_scale * SENSORS_GRAVITY_STANDARD / 1000;
+}
 
+/**************************************************************************/
+/*!
+    @brief Gets the gyro scale factor for the current range
+    @returns The rotation rate of one raw LSB in rad/s
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS::gyroScale(void) {
   float gyro_scale = 1; // range is in milli-dps per bit!
   switch (gyroRangeBuffered) {
   case ISM330DHCX_GYRO_RANGE_4000_DPS:
@@ -494,30 +1767,131 @@ void Adafruit_LSM6DS::_read(void) {
     gyro_scale = 4.375;
     break;
   }
+  return gyro_scale * SENSORS_DPS_TO_RADS / 1000;
+}
+
+/******************* Adafruit_Sensor functions *****************/
+/*!
+ *     @brief  Updates the measurement data for all sensors simultaneously.
+ *     Only the raw values are stored; decodeReading() scales them on demand.
+ *     @returns True on success. If the bus transfer fails after retries and
+ *     recovery, the previous readings are kept and false is returned.
+ */
+/**************************************************************************/
+bool Adafruit_LSM6DS::_read(void) {
+  // start at STATUS_REG so new vs. stale data is known for 2 more bytes
+#if LSM6DS_ENABLE_STATS
+  uint32_t start = micros();
+#endif
+  const uint8_t len = LSM6DS_OUTX_L_A + 6 - LSM6DS_STATUS_REG;
+  uint8_t burst[len];
+
+  if (!readRegisters(LSM6DS_STATUS_REG, burst, len)) {
+    // retries are used up, get the bus and chip back and try once more
+    if (!recover() || !readRegisters(LSM6DS_STATUS_REG, burst, len)) {
+      return false;
+    }
+  }
+  uint8_t *buffer = burst + (LSM6DS_OUTX_L_G - LSM6DS_STATUS_REG);
+
+  if (_config_dirty) {
+    captureConfig();
+  }
+
+#if LSM6DS_ENABLE_STATS
+  uint32_t now = micros();
+  uint32_t latency = now - start;
+  uint8_t bin = 0;
+  while ((latency >>= 1) && (bin < LSM6DS_STATS_LATENCY_BINS - 1)) {
+    bin++;
+  }
+  _stats.latency[bin]++;
+
+  if (burst[0] & 0x01) { // XLDA
+    _stats.samples++;
+    // any whole sample periods beyond the first were overwritten unread
+    float odr = _data_rate_arr[accelRateBuffered];
+    if (_last_sample_us && (odr > 0)) {
+      uint32_t periods = (now - _last_sample_us) * odr / 1000000;
+      if (periods > 1) {
+        _stats.missed += periods - 1;
+      }
+    }
+    _last_sample_us = now;
+  } else {
+    _stats.stale++;
+  }
+#endif
+
+  rawTemp = lsm6ds_raw(buffer - 2);
+  _temp_read_ms = millis();
+  _temp_due = false;
+  rawGyroX = lsm6ds_raw(buffer);
+  rawGyroY = lsm6ds_raw(buffer + 2);
+  rawGyroZ = lsm6ds_raw(buffer + 4);
+
+  rawAccX = lsm6ds_raw(buffer + 6);
+  rawAccY = lsm6ds_raw(buffer + 8);
+  rawAccZ = lsm6ds_raw(buffer + 10);
+
+#if LSM6DS_ENABLE_WINDOWS || LSM6DS_ENABLE_CAPTURE
+  const int16_t raw[2][3] = {{rawGyroX, rawGyroY, rawGyroZ},
+                             {rawAccX, rawAccY, rawAccZ}};
+  for (uint8_t i = 0; i < 2; i++) {
+    // only new samples, GDA or XLDA set: polling faster than the data
+    // rate reads repeats, which would skew the window statistics and
+    // count toward a capture's post-trigger samples
+    if (!(burst[0] & (i ? 0x01 : 0x02)) || !settledAt(i, millis())) {
+      continue;
+    }
+#if LSM6DS_ENABLE_WINDOWS
+    if (_windows[i]) {
+      _windows[i]->push(raw[i]);
+    }
+#endif
+#if LSM6DS_ENABLE_CAPTURE
+    if (_captures[i]) {
+      _captures[i]->record(raw[i], millis());
+    }
+#endif
+  }
+#endif
+
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  // scaling waits until something asks for the scaled values
+  _stale |= LSM6DS_DECODE_ALL;
+#endif
+
+  return true;
+}
 
-  gyroX = rawGyroX * gyro_scale * SENSORS_DPS_TO_RADS / 1000.0;
-  gyroY = rawGyroY * gyro_scale * SENSORS_DPS_TO_RADS / 1000.0;
-  gyroZ = rawGyroZ * gyro_scale * SENSORS_DPS_TO_RADS / 1000.0;
+/**************************************************************************/
+/*!
+    @brief Reads a sample into `rawAccX..rawGyroZ` and `rawTemp` without
+    scaling it, for callers that only use raw values. Nothing is converted
+    to floats until a scaled*() accessor asks for it, and the float fields
+    are left as they were.
+    @returns True on success, false on a bus error
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS::readRaw(void) { return _read(); }
 
-  float accel_scale = 1; // range is in milli-g per bit!
-  switch (accelRangeBuffered) {
-  case LSM6DS_ACCEL_RANGE_16_G:
-    accel_scale = 0.488;
-    break;
-  case LSM6DS_ACCEL_RANGE_8_G:
-    accel_scale = 0.244;
-    break;
-  case LSM6DS_ACCEL_RANGE_4_G:
-    accel_scale = 0.122;
-    break;
-  case LSM6DS_ACCEL_RANGE_2_G:
-    accel_scale = 0.061;
-    break;
+/**************************************************************************/
+/*!
+    @brief Reads a sample and scales every part of it into the float
+    fields, so code reading `accX..gyroZ` and `temperature` directly after
+    a getEvent() sees the new values
+    @returns True on success, false on a bus error
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS::readScaled(void) {
+  if (!_read()) {
+    return false;
   }
-
-  accX = rawAccX * accel_scale * SENSORS_GRAVITY_STANDARD / 1000;
-  accY = rawAccY * accel_scale * SENSORS_GRAVITY_STANDARD / 1000;
-  accZ = rawAccZ * accel_scale * SENSORS_GRAVITY_STANDARD / 1000;
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_ALL);
+#endif
+  return true;
 }
 
 /**************************************************************************/
@@ -529,13 +1903,8 @@ void Adafruit_LSM6DS::_read(void) {
    mode to push-pull
 */
 void Adafruit_LSM6DS::configIntOutputs(bool active_low, bool open_drain) {
-
-  Adafruit_BusIO_Register ctrl3 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL3_C);
-  Adafruit_BusIO_RegisterBits ppod_bits =
-      Adafruit_BusIO_RegisterBits(&ctrl3, 2, 4);
-
-  ppod_bits.write((active_low << 1) | open_drain);
+  writeBits(LSM6DS_CTRL3_C, 2, 4, (active_low << 1) | open_drain);
+  _config_dirty = true;
 }
 
 /**************************************************************************/
@@ -549,18 +1918,12 @@ void Adafruit_LSM6DS::configIntOutputs(bool active_low, bool open_drain) {
 */
 void Adafruit_LSM6DS::configInt1(bool drdy_temp, bool drdy_g, bool drdy_xl,
                                  bool step_detect, bool wakeup) {
+  uint8_t int1_ctrl = (step_detect << 7) | (drdy_temp << 2) | (drdy_g << 1) |
+                      drdy_xl;
+  writeRegisters(LSM6DS_INT1_CTRL, &int1_ctrl, 1);
 
-  Adafruit_BusIO_Register int1_ctrl = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_INT1_CTRL);
-
-  int1_ctrl.write((step_detect << 7) | (drdy_temp << 2) | (drdy_g << 1) |
-                  drdy_xl);
-
-  Adafruit_BusIO_Register md1cfg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_MD1_CFG);
-
-  Adafruit_BusIO_RegisterBits wu = Adafruit_BusIO_RegisterBits(&md1cfg, 1, 5);
-  wu.write(wakeup);
+  writeBits(LSM6DS_MD1_CFG, 1, 5, wakeup);
+  _config_dirty = true;
 }
 
 /**************************************************************************/
@@ -571,14 +1934,8 @@ void Adafruit_LSM6DS::configInt1(bool drdy_temp, bool drdy_g, bool drdy_xl,
     @param drdy_xl true to output the data ready accelerometer interrupt
 */
 void Adafruit_LSM6DS::configInt2(bool drdy_temp, bool drdy_g, bool drdy_xl) {
-
-  Adafruit_BusIO_Register int2_ctrl = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_INT2_CTRL);
-
-  Adafruit_BusIO_RegisterBits int2_drdy_bits =
-      Adafruit_BusIO_RegisterBits(&int2_ctrl, 3, 0);
-
-  int2_drdy_bits.write((drdy_temp << 2) | (drdy_g << 1) | drdy_xl);
+  writeBits(LSM6DS_INT2_CTRL, 3, 0, (drdy_temp << 2) | (drdy_g << 1) | drdy_xl);
+  _config_dirty = true;
 }
 
 /**************************************************************************/
@@ -606,11 +1963,13 @@ void Adafruit_LSM6DS_Gyro::getSensor(sensor_t *sensor) {
 /*!
     @brief  Gets the gyroscope as a standard sensor event
     @param  event Sensor event object that will be populated
-    @returns True
+    @returns True on successful read
 */
 /**************************************************************************/
 bool Adafruit_LSM6DS_Gyro::getEvent(sensors_event_t *event) {
-  _theLSM6DS->_read();
+  if (!_theLSM6DS->readScaled()) {
+    return false;
+  }
   _theLSM6DS->fillGyroEvent(event, millis());
 
   return true;
@@ -641,11 +2000,13 @@ void Adafruit_LSM6DS_Accelerometer::getSensor(sensor_t *sensor) {
 /*!
     @brief  Gets the accelerometer as a standard sensor event
     @param  event Sensor event object that will be populated
-    @returns True
+    @returns True on successful read
 */
 /**************************************************************************/
 bool Adafruit_LSM6DS_Accelerometer::getEvent(sensors_event_t *event) {
-  _theLSM6DS->_read();
+  if (!_theLSM6DS->readScaled()) {
+    return false;
+  }
   _theLSM6DS->fillAccelEvent(event, millis());
 
   return true;
@@ -676,16 +2037,19 @@ void Adafruit_LSM6DS_Temp::getSensor(sensor_t *sensor) {
 /*!
     @brief  Gets the temperature as a standard sensor event
     @param  event Sensor event object that will be populated
-    @returns True
+    @returns True on successful read
 */
 /**************************************************************************/
 bool Adafruit_LSM6DS_Temp::getEvent(sensors_event_t *event) {
-  _theLSM6DS->_read();
+  if (!_theLSM6DS->readScaled()) {
+    return false;
+  }
   _theLSM6DS->fillTempEvent(event, millis());
 
   return true;
 }
 
+#if LSM6DS_ENABLE_EVENTS
 /**************************************************************************/
 /*!
     @brief Enables and disables the pedometer function
@@ -694,18 +2058,11 @@ bool Adafruit_LSM6DS_Temp::getEvent(sensors_event_t *event) {
 /**************************************************************************/
 void Adafruit_LSM6DS::enablePedometer(bool enable) {
   // enable or disable step counter
-  Adafruit_BusIO_Register tapcfg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_TAP_CFG);
-  Adafruit_BusIO_RegisterBits pedo_en =
-      Adafruit_BusIO_RegisterBits(&tapcfg, 1, 6);
-  pedo_en.write(enable);
+  writeBits(LSM6DS_TAP_CFG, 1, 6, enable);
 
   // enable or disable functionality
-  Adafruit_BusIO_Register ctrl10 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL10_C);
-  Adafruit_BusIO_RegisterBits func_en =
-      Adafruit_BusIO_RegisterBits(&ctrl10, 1, 2);
-  func_en.write(enable);
+  writeBits(LSM6DS_CTRL10_C, 1, 2, enable);
+  _config_dirty = true;
 
   resetPedometer();
 }
@@ -721,27 +2078,13 @@ void Adafruit_LSM6DS::enablePedometer(bool enable) {
 void Adafruit_LSM6DS::enableWakeup(bool enable, uint8_t duration,
                                    uint8_t thresh) {
   // enable or disable functionality
-  Adafruit_BusIO_Register tapcfg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_TAP_CFG);
-  Adafruit_BusIO_RegisterBits slope_en =
-      Adafruit_BusIO_RegisterBits(&tapcfg, 1, 4);
-  Adafruit_BusIO_RegisterBits timer_en =
-      Adafruit_BusIO_RegisterBits(&tapcfg, 1, 7);
-  slope_en.write(enable);
-  timer_en.write(enable);
+  writeBits(LSM6DS_TAP_CFG, 1, 4, enable);
+  setEventEnabled(LSM6DS_EVENT_WAKEUP, enable);
   if (enable) {
-    Adafruit_BusIO_Register wake_dur = Adafruit_BusIO_Register(
-        i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_WAKEUP_DUR);
-    Adafruit_BusIO_RegisterBits durbits =
-        Adafruit_BusIO_RegisterBits(&wake_dur, 2, 5);
-    durbits.write(duration);
-
-    Adafruit_BusIO_Register wake_ths = Adafruit_BusIO_Register(
-        i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_WAKEUP_THS);
-    Adafruit_BusIO_RegisterBits thsbits =
-        Adafruit_BusIO_RegisterBits(&wake_ths, 6, 0);
-    thsbits.write(thresh);
+    writeBits(LSM6DS_WAKEUP_DUR, 2, 5, duration);
+    writeBits(LSM6DS_WAKEUP_THS, 6, 0, thresh);
   }
+  _config_dirty = true;
 }
 
 /**************************************************************************/
@@ -751,11 +2094,9 @@ void Adafruit_LSM6DS::enableWakeup(bool enable, uint8_t duration,
 */
 /**************************************************************************/
 bool Adafruit_LSM6DS::awake(void) {
-  Adafruit_BusIO_Register wakesrc = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_WAKEUP_SRC);
-  Adafruit_BusIO_RegisterBits wake_evt =
-      Adafruit_BusIO_RegisterBits(&wakesrc, 1, 3);
-  return wake_evt.read();
+  uint8_t wakesrc = 0;
+  readRegisters(LSM6DS_WAKEUP_SRC, &wakesrc, 1);
+  return wakesrc & 0x08; // WU_IA
 }
 
 /**************************************************************************/
@@ -765,19 +2106,270 @@ bool Adafruit_LSM6DS::awake(void) {
 */
 /**************************************************************************/
 bool Adafruit_LSM6DS::shake(void) {
-  Adafruit_BusIO_Register tapcfg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_TAP_CFG);
-  Adafruit_BusIO_RegisterBits slope_en =
-      Adafruit_BusIO_RegisterBits(&tapcfg, 1, 4);
-  Adafruit_BusIO_RegisterBits timer_en =
-      Adafruit_BusIO_RegisterBits(&tapcfg, 1, 7);
-  // only check if enabled
-  if (slope_en.read() && timer_en.read()) {
-    return awake();
+  uint8_t tapcfg = 0;
+  readRegisters(LSM6DS_TAP_CFG, &tapcfg, 1);
+  // only check if enabled (SLOPE_FDS and interrupt enable)
+  if ((tapcfg & 0x90) == 0x90) {
+    bool woke = awake();
+#if LSM6DS_ENABLE_CAPTURE
+    if (woke && (_capture_events & LSM6DS_EVENT_WAKEUP)) {
+      triggerCaptures(LSM6DS_EVENT_WAKEUP);
+    }
+#endif
+    return woke;
   }
   return false;
 }
 
+/**************************************************************************/
+/*!
+    @brief Records which embedded events are turned on and sets the shared
+    interrupt enable bit while any of them are
+    @param events The lsm6ds_event_t flags to change
+    @param enable True to turn the events on, false to turn them off
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::setEventEnabled(uint8_t events, bool enable) {
+  if (enable) {
+    _events_enabled |= events;
+  } else {
+    _events_enabled &= ~events;
+  }
+
+  // TAP_CFG bit 7 on the LSM6DS3 family, TAP_CFG2 bit 7 on the LSM6DSOX
+  writeBits(LSM6DS_TAP_CFG, 1, 7, _events_enabled != 0);
+  _config_dirty = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Enables and disables single and double tap detection
+    @param enable True to turn on tap detection, false to turn it off
+    @param axes The lsm6ds_axis_t flags of the axes to detect taps on
+    @param thresh Tap threshold, 0-31 in steps of full scale / 32
+    @param double_tap True to also detect double taps
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::enableTap(bool enable, uint8_t axes, uint8_t thresh,
+                                bool double_tap) {
+  // register order is Z, Y, X from bit 1 up
+  uint8_t tap_en = ((axes & LSM6DS_AXIS_X) << 2) | (axes & LSM6DS_AXIS_Y) |
+                   ((axes & LSM6DS_AXIS_Z) >> 2);
+  writeBits(LSM6DS_TAP_CFG, 3, 1, enable ? tap_en : 0);
+
+  if (enable) {
+    writeBits(LSM6DS_TAP_THS_6D, 5, 0, thresh);
+    writeBits(LSM6DS_WAKEUP_THS, 1, 7, double_tap);
+  }
+  setEventEnabled(LSM6DS_EVENT_SINGLE_TAP, enable);
+  setEventEnabled(LSM6DS_EVENT_DOUBLE_TAP, enable && double_tap);
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets the tap recognition windows. Zero selects each window's
+    default length.
+    @param shock Longest over-threshold pulse counted as a tap, 0-3 in steps
+    of 8 / ODR
+    @param quiet Time after a tap with no over-threshold samples, 0-3 in steps
+    of 4 / ODR
+    @param duration Longest gap between the taps of a double tap, 0-15 in
+    steps of 32 / ODR
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::setTapTiming(uint8_t shock, uint8_t quiet,
+                                   uint8_t duration) {
+  uint8_t dur2 = ((duration & 0x0F) << 4) | ((quiet & 0x03) << 2) |
+                 (shock & 0x03);
+  writeRegisters(LSM6DS_INT_DUR2, &dur2, 1);
+  _config_dirty = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Enables and disables free-fall detection
+    @param enable True to turn on free-fall detection, false to turn it off
+    @param thresh How close to 0g all axes must be to count as falling
+    @param duration How many samples, 0-63, the fall must last
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::enableFreeFall(bool enable, lsm6ds_ff_threshold_t thresh,
+                                     uint8_t duration) {
+  if (enable) {
+    uint8_t ff = ((duration & 0x1F) << 3) | (thresh & 0x07);
+    writeRegisters(LSM6DS_FREE_FALL, &ff, 1);
+
+    writeBits(LSM6DS_WAKEUP_DUR, 1, 7, duration >> 5);
+  }
+  setEventEnabled(LSM6DS_EVENT_FREE_FALL, enable);
+}
+
+/**************************************************************************/
+/*!
+    @brief Enables and disables 6D orientation detection
+    @param enable True to turn on orientation detection, false to turn it off
+    @param thresh How far past an axis the device must tilt to change position
+    @param only_4d True to ignore the Z axis and report portrait/landscape
+    positions only
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::enable6D(bool enable, lsm6ds_6d_threshold_t thresh,
+                               bool only_4d) {
+  if (enable) {
+    writeBits(LSM6DS_TAP_THS_6D, 3, 5, (only_4d << 2) | thresh);
+  }
+  setEventEnabled(LSM6DS_EVENT_6D, enable);
+}
+
+/**************************************************************************/
+/*!
+    @brief Selects latched event interrupts. Latched events stay set in the
+    source registers and on the interrupt pins until readEvents() is called,
+    so the host can poll far below the data rate without missing any.
+    @param latch True to latch events, false for pulsed events
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::latchEvents(bool latch) {
+  writeBits(LSM6DS_TAP_CFG, 1, 0, latch);
+  _config_dirty = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Routes embedded events to the interrupt pins. Other functions
+    routed through MD1_CFG/MD2_CFG are left as they are.
+    @param int1_events The lsm6ds_event_t flags to signal on INT1
+    @param int2_events The lsm6ds_event_t flags to signal on INT2
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::routeEvents(uint8_t int1_events, uint8_t int2_events) {
+  const uint8_t mask = LSM6DS_EVENT_6D | LSM6DS_EVENT_DOUBLE_TAP |
+                       LSM6DS_EVENT_FREE_FALL | LSM6DS_EVENT_WAKEUP |
+                       LSM6DS_EVENT_SINGLE_TAP;
+  uint8_t md[2];
+  if (!readRegisters(LSM6DS_MD1_CFG, md, 2)) {
+    return;
+  }
+  md[0] = (md[0] & ~mask) | (int1_events & mask);
+  md[1] = (md[1] & ~mask) | (int2_events & mask);
+  writeRegisters(LSM6DS_MD1_CFG, md, 2);
+  _config_dirty = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Reads and decodes the embedded event sources in one transfer.
+    Only events turned on with enableTap(), enableFreeFall(), enable6D() or
+    enableWakeup() are reported.
+    @param events Where to store the decoded events
+    @returns True if the sources were read, false on a bus error
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS::readEvents(lsm6ds_events_t *events) {
+  // WAKE_UP_SRC, TAP_SRC, D6D_SRC
+  uint8_t src[3];
+  if (!readRegisters(LSM6DS_WAKEUP_SRC, src, 3)) {
+    return false;
+  }
+
+  uint8_t fired = 0;
+  if (src[0] & 0x20) { // FF_IA
+    fired |= LSM6DS_EVENT_FREE_FALL;
+  }
+  if (src[0] & 0x08) { // WU_IA
+    fired |= LSM6DS_EVENT_WAKEUP;
+  }
+  if (src[1] & 0x20) { // SINGLE_TAP
+    fired |= LSM6DS_EVENT_SINGLE_TAP;
+  }
+  if (src[1] & 0x10) { // DOUBLE_TAP
+    fired |= LSM6DS_EVENT_DOUBLE_TAP;
+  }
+  if (src[2] & 0x40) { // D6D_IA
+    fired |= LSM6DS_EVENT_6D;
+  }
+
+  events->events = fired & _events_enabled;
+  events->tap_axes = ((src[1] & 0x04) >> 2) | (src[1] & 0x02) |
+                     ((src[1] & 0x01) << 2);
+  events->tap_negative = src[1] & 0x08;
+  events->orientation = src[2] & 0x3F;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets the function pollEvents() calls when an event fires
+    @param event The single lsm6ds_event_t to handle
+    @param callback The function to call, or NULL to stop calling one
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::setEventCallback(lsm6ds_event_t event,
+                                       lsm6ds_event_callback_t callback) {
+  for (uint8_t i = 0; i < 5; i++) {
+    if (event == (LSM6DS_EVENT_6D << i)) {
+      _event_callbacks[i] = callback;
+      return;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets the function pollEvents() calls when the step count changes.
+    Must call enablePedometer() first.
+    @param callback The function to call, or NULL to stop reading the step
+    counter in pollEvents()
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::setStepCallback(lsm6ds_step_callback_t callback) {
+  _step_callback = callback;
+  if (callback) {
+    _last_steps = readPedometer();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Checks all embedded event sources and calls the callbacks set with
+    setEventCallback() for each event that fired. The event sources come from
+    one burst read; the step counter is read in a second one only while a
+    step callback is set, since the registers between the two include the
+    data outputs and FIFO port, which a read would disturb.
+    @returns The lsm6ds_event_t flags that fired, 0 if none or on a bus error
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS::pollEvents(void) {
+  lsm6ds_events_t events;
+  if (!readEvents(&events)) {
+    return 0;
+  }
+
+#if LSM6DS_ENABLE_CAPTURE
+  if (events.events & _capture_events) {
+    triggerCaptures(events.events & _capture_events);
+  }
+#endif
+
+  for (uint8_t i = 0; i < 5; i++) {
+    if ((events.events & (LSM6DS_EVENT_6D << i)) && _event_callbacks[i]) {
+      _event_callbacks[i](&events);
+    }
+  }
+
+  if (_step_callback) {
+    uint8_t buf[2];
+    if (readRegisters(LSM6DS_STEPCOUNTER, buf, 2)) {
+      uint16_t steps = buf[1] << 8 | buf[0];
+      if (steps != _last_steps) {
+        _last_steps = steps;
+        _step_callback(steps);
+      }
+    }
+  }
+  return events.events;
+}
+
 /**************************************************************************/
 /*!
     @brief Reset the pedometer count
@@ -785,11 +2377,7 @@ bool Adafruit_LSM6DS::shake(void) {
 /**************************************************************************/
 void Adafruit_LSM6DS::resetPedometer(void) {
   // reset bit to clear counter
-  Adafruit_BusIO_Register ctrl10 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL10_C);
-  Adafruit_BusIO_RegisterBits ped_rst =
-      Adafruit_BusIO_RegisterBits(&ctrl10, 1, 1);
-  ped_rst.write(true);
+  writeBits(LSM6DS_CTRL10_C, 1, 1, true);
 }
 
 /**************************************************************************/
@@ -799,9 +2387,350 @@ void Adafruit_LSM6DS::resetPedometer(void) {
 */
 /**************************************************************************/
 uint16_t Adafruit_LSM6DS::readPedometer(void) {
-  Adafruit_BusIO_Register steps_reg = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_STEPCOUNTER, 2);
-  return steps_reg.read();
+  uint8_t steps[2] = {0, 0};
+  readRegisters(LSM6DS_STEPCOUNTER, steps, 2);
+  return steps[1] << 8 | steps[0];
+}
+#endif
+
+#if LSM6DS_ENABLE_TEMP_COMP
+/**************************************************************************/
+/*!
+    @brief Clears any accumulated temperature calibration samples. Call this
+    before collecting a new set of samples with addTempCalibrationSample()
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::beginTempCalibration(void) {
+  _tc_count = 0;
+  _tc_t0 = 0;
+  _tc_sum_t = _tc_sum_tt = 0;
+  for (uint8_t i = 0; i < 6; i++) {
+    _tc_sum_y[i] = _tc_sum_ty[i] = 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Takes a reading and adds it to the temperature calibration set.
+    The sensor must be held still and in the same orientation while samples
+    are collected, ideally over the full temperature span it will see in use.
+    @returns True if a reading was taken and added
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS::addTempCalibrationSample(void) {
+  bool was_enabled = _tc_enabled;
+  _tc_enabled = false; // calibrate against uncompensated readings
+  bool ok = _read();
+  decodeReading(LSM6DS_DECODE_ALL);
+  _tc_enabled = was_enabled;
+  if (!ok) {
+    return false;
+  }
+
+  if (_tc_count == 0) {
+    _tc_t0 = temperature;
+  }
+  // offset from the first sample keeps the float sums well conditioned
+  float t = temperature - _tc_t0;
+  float y[6] = {accX, accY, accZ, gyroX, gyroY, gyroZ};
+
+  _tc_count++;
+  _tc_sum_t += t;
+  _tc_sum_tt += t * t;
+  for (uint8_t i = 0; i < 6; i++) {
+    _tc_sum_y[i] += y[i];
+    _tc_sum_ty[i] += t * y[i];
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Fits a bias-vs-temperature line to each axis from the samples
+    collected with addTempCalibrationSample() and enables compensation.
+    The gyro model removes the full zero-rate bias. Since a still
+    accelerometer also measures gravity, only the accelerometer drift away
+    from the calibration mean temperature is removed.
+    @returns True if the samples spanned enough temperature to fit a slope,
+    false if only the offsets could be determined
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS::fitTempCompensation(void) {
+  if (_tc_count == 0) {
+    return false;
+  }
+
+  float n = _tc_count;
+  float mean_t = _tc_sum_t / n;
+  float var_t = _tc_sum_tt / n - mean_t * mean_t;
+  // less than ~0.5 C of spread can't tell drift from noise
+  bool have_slope = var_t > 0.25;
+
+  lsm6ds_temp_comp_t model;
+  model.ref_temp = _tc_t0 + mean_t;
+  for (uint8_t i = 0; i < 6; i++) {
+    float mean_y = _tc_sum_y[i] / n;
+    float slope = 0;
+    if (have_slope) {
+      slope = (_tc_sum_ty[i] / n - mean_t * mean_y) / var_t;
+    }
+    if (i < 3) {
+      model.accel_offset[i] = 0;
+      model.accel_slope[i] = slope;
+    } else {
+      model.gyro_offset[i - 3] = mean_y;
+      model.gyro_slope[i - 3] = slope;
+    }
+  }
+  setTempCompensation(&model, _tc_threshold);
+
+  return have_slope;
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets and enables a bias-vs-temperature compensation model. The
+    bias is only recalculated when the temperature moves by more than
+    `threshold` from the last update, not on every sample.
+    @param model The per-axis model to apply
+    @param threshold The temperature change in degrees C that triggers a bias
+    update
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::setTempCompensation(const lsm6ds_temp_comp_t *model,
+                                          float threshold) {
+  _tc_model = *model;
+  _tc_threshold = threshold;
+  _tc_applied_temp = NAN; // force an update on the next reading
+  _tc_enabled = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the current temperature compensation model, for example to
+    store a fitted model in non-volatile memory
+    @param model The model to fill in
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::getTempCompensation(lsm6ds_temp_comp_t *model) {
+  *model = _tc_model;
+}
+
+/**************************************************************************/
+/*!
+    @brief Enables or disables applying the temperature compensation model
+    to getEvent() readings and to events from getEvents() and resumeBatch()
+    @param enable True to apply the model to readings, false to disable
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::enableTempCompensation(bool enable) {
+  _tc_enabled = enable;
+  _tc_applied_temp = NAN;
+}
+
+/**************************************************************************/
+/*!
+    @brief Removes the modeled temperature bias from the scaled readings.
+    decodeReading() calls this after scaling, so a `_read()` override only
+    has to store the raw values and mark them in `_stale`.
+    @param sensors The lsm6ds_decode_t flags of the values just scaled. The
+    temperature must be up to date when accelerometer or gyro values are.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::applyTempCompensation(uint8_t sensors) {
+  if (!_tc_enabled || !(sensors & (LSM6DS_DECODE_ACCEL | LSM6DS_DECODE_GYRO))) {
+    return;
+  }
+  updateTempBias();
+
+  if (sensors & LSM6DS_DECODE_ACCEL) {
+    accX -= _tc_bias[0];
+    accY -= _tc_bias[1];
+    accZ -= _tc_bias[2];
+  }
+  if (sensors & LSM6DS_DECODE_GYRO) {
+    gyroX -= _tc_bias[3];
+    gyroY -= _tc_bias[4];
+    gyroZ -= _tc_bias[5];
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Re-evaluates the bias model for the current `temperature`, once
+    it has moved by the threshold since the last update
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::updateTempBias(void) {
+  if (!isnan(_tc_applied_temp) &&
+      (fabs(temperature - _tc_applied_temp) < _tc_threshold)) {
+    return;
+  }
+  float dt = temperature - _tc_model.ref_temp;
+  for (uint8_t i = 0; i < 3; i++) {
+    _tc_bias[i] = _tc_model.accel_offset[i] + _tc_model.accel_slope[i] * dt;
+    _tc_bias[i + 3] = _tc_model.gyro_offset[i] + _tc_model.gyro_slope[i] * dt;
+  }
+  _tc_applied_temp = temperature;
+}
+
+#if LSM6DS_ENABLE_FIFO
+/**************************************************************************/
+/*!
+    @brief Removes the modeled temperature bias from events drained from
+    the FIFO. The FIFO holds no temperature, so the bias is for the last
+    temperature read, refreshed here with a 2 byte read as often as
+    setTemperatureInterval() allows.
+    @param events The scaled events
+    @param count The number of events
+    @param accel True for accelerometer events, false for gyro events
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::compensateEvents(sensors_event_t *events, size_t count,
+                                       bool accel) {
+  if (!_tc_enabled || !count) {
+    return;
+  }
+  if (_temp_due || (millis() - _temp_read_ms >= _temp_interval_ms)) {
+    uint8_t buffer[2];
+    if (readRegisters(LSM6DS_OUT_TEMP_L, buffer, 2)) {
+      rawTemp = lsm6ds_raw(buffer);
+      _temp_read_ms = millis();
+      _temp_due = false;
+      _stale |= LSM6DS_DECODE_TEMP;
+    }
+  }
+  decodeReading(LSM6DS_DECODE_TEMP);
+  updateTempBias();
+
+  const float *bias = accel ? _tc_bias : _tc_bias + 3;
+  for (size_t i = 0; i < count; i++) {
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      events[i].data[axis] -= bias[axis];
+    }
+  }
+}
+#endif
+#endif
+
+#if LSM6DS_ENABLE_FLOAT_CACHE
+/**************************************************************************/
+/*!
+    @brief Scales the parts of the last reading that haven't been yet into
+    `temperature` and `accX..gyroZ`. Anything already decoded is left alone,
+    so calling this again costs nothing until the next reading.
+    @param sensors The lsm6ds_decode_t flags of the values wanted
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::decodeReading(uint8_t sensors) {
+#if LSM6DS_ENABLE_TEMP_COMP
+  // the bias model needs the temperature the reading was taken at
+  if (_tc_enabled && (sensors & (LSM6DS_DECODE_ACCEL | LSM6DS_DECODE_GYRO))) {
+    sensors |= LSM6DS_DECODE_TEMP;
+  }
+#endif
+  sensors &= _stale;
+  if (!sensors) {
+    return;
+  }
+  _stale &= ~sensors;
+
+  if (sensors & LSM6DS_DECODE_TEMP) {
+    temperature = (rawTemp / (float)temperature_sensitivity) + 25.0;
+  }
+
+  // same expression as lsm6ds_decode_float() so bulk decodes match exactly
+  if (sensors & LSM6DS_DECODE_GYRO) {
+    float gyro_scale = gyroScale();
+    gyroX = rawGyroX * gyro_scale;
+    gyroY = rawGyroY * gyro_scale;
+    gyroZ = rawGyroZ * gyro_scale;
+  }
+  if (sensors & LSM6DS_DECODE_ACCEL) {
+    float accel_scale = accelScale();
+    accX = rawAccX * accel_scale;
+    accY = rawAccY * accel_scale;
+    accZ = rawAccZ * accel_scale;
+  }
+
+#if LSM6DS_ENABLE_TEMP_COMP
+  applyTempCompensation(sensors);
+#endif
+}
+#endif
+
+/**************************************************************************/
+/*!
+    @brief Gets one axis of the last reading's acceleration, scaling it on
+    first use
+    @param axis 0 for X, 1 for Y, 2 for Z
+    @returns The acceleration in m/s^2, NAN for an invalid axis
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS::scaledAccel(uint8_t axis) {
+  if (axis > 2) {
+    return NAN;
+  }
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_ACCEL);
+  const float scaled[3] = {accX, accY, accZ};
+  return scaled[axis];
+#else
+  const int16_t raw[3] = {rawAccX, rawAccY, rawAccZ};
+  return raw[axis] * accelScale();
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets one axis of the last reading's rotation rate, scaling it on
+    first use
+    @param axis 0 for X, 1 for Y, 2 for Z
+    @returns The rotation rate in rad/s, NAN for an invalid axis
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS::scaledGyro(uint8_t axis) {
+  if (axis > 2) {
+    return NAN;
+  }
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_GYRO);
+  const float scaled[3] = {gyroX, gyroY, gyroZ};
+  return scaled[axis];
+#else
+  const int16_t raw[3] = {rawGyroX, rawGyroY, rawGyroZ};
+  return raw[axis] * gyroScale();
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the last temperature reading, scaling it on first use
+    @returns The temperature in C
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS::scaledTemperature(void) {
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  decodeReading(LSM6DS_DECODE_TEMP);
+  return temperature;
+#else
+  return (rawTemp / (float)temperature_sensitivity) + 25.0;
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief Reads the temperature less often for FIFO temperature
+    compensation, which needs a read of its own. Polled readings always
+    include it, since it sits between STATUS_REG and the outputs in their
+    burst.
+    @param interval_ms Least time between temperature reads, 0 to read it
+    every time. The next drain always includes it.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS::setTemperatureInterval(uint32_t interval_ms) {
+  _temp_interval_ms = interval_ms;
+  _temp_due = true;
 }
 
 /**************************************************************************/
@@ -815,7 +2744,9 @@ float Adafruit_LSM6DS::accelerationSampleRate(void) {
 
 /**************************************************************************/
 /*!
-    @brief Check for available data from accelerometer
+    @brief Check for available data from accelerometer, as STATUS_REG reports
+    it. Use accelSettled() to tell whether the sample is past a
+    settling window.
     @returns 1 if available, 0 if not
 */
 int Adafruit_LSM6DS::accelerationAvailable(void) {
@@ -833,10 +2764,7 @@ int Adafruit_LSM6DS::accelerationAvailable(void) {
 int Adafruit_LSM6DS::readAcceleration(float &x, float &y, float &z) {
   int16_t data[3];
 
-  Adafruit_BusIO_Register accel_data = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_OUTX_L_A, 6);
-
-  if (!accel_data.read((uint8_t *)data, sizeof(data))) {
+  if (!readRegisters(LSM6DS_OUTX_L_A, (uint8_t *)data, sizeof(data))) {
     x = y = z = NAN;
     return 0;
   }
@@ -860,7 +2788,9 @@ float Adafruit_LSM6DS::gyroscopeSampleRate(void) {
 
 /**************************************************************************/
 /*!
-    @brief Check for available data from gyroscope
+    @brief Check for available data from gyroscope, as STATUS_REG reports
+    it. Use gyroSettled() to tell whether the sample is past a
+    settling window.
     @returns 1 if available, 0 if not
 */
 int Adafruit_LSM6DS::gyroscopeAvailable(void) {
@@ -878,10 +2808,7 @@ int Adafruit_LSM6DS::gyroscopeAvailable(void) {
 int Adafruit_LSM6DS::readGyroscope(float &x, float &y, float &z) {
   int16_t data[3];
 
-  Adafruit_BusIO_Register gyro_data = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_OUTX_L_G, 6);
-
-  if (!gyro_data.read((uint8_t *)data, sizeof(data))) {
+  if (!readRegisters(LSM6DS_OUTX_L_G, (uint8_t *)data, sizeof(data))) {
     x = y = z = NAN;
     return 0;
   }
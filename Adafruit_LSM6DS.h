@@ -14,6 +14,7 @@
 #ifndef _ADAFRUIT_LSM6DS_H
 #define _ADAFRUIT_LSM6DS_H
 
+#include "Adafruit_LSM6DS_Bus.h"
 #include "Arduino.h"
 #include <Adafruit_BusIO_Register.h>
 #include <Adafruit_I2CDevice.h>
@@ -22,27 +23,105 @@
 
 #define LSM6DS_I2CADDR_DEFAULT 0x6A ///< LSM6DS default i2c address
 
-#define LSM6DS_FUNC_CFG_ACCESS 0x1 ///< Enable embedded functions register
-#define LSM6DS_INT1_CTRL 0x0D      ///< Interrupt control for INT 1
-#define LSM6DS_INT2_CTRL 0x0E      ///< Interrupt control for INT 2
-#define LSM6DS_WHOAMI 0x0F         ///< Chip ID register
-#define LSM6DS_CTRL1_XL 0x10       ///< Main accelerometer config register
-#define LSM6DS_CTRL2_G 0x11        ///< Main gyro config register
-#define LSM6DS_CTRL3_C 0x12        ///< Main configuration register
-#define LSM6DS_CTRL8_XL 0x17       ///< High and low pass for accel
-#define LSM6DS_CTRL10_C 0x19       ///< Main configuration register
-#define LSM6DS_WAKEUP_SRC 0x1B     ///< Why we woke up
-#define LSM6DS_STATUS_REG 0X1E     ///< Status register
-#define LSM6DS_OUT_TEMP_L 0x20     ///< First data register (temperature low)
-#define LSM6DS_OUTX_L_G 0x22       ///< First gyro data register
-#define LSM6DS_OUTX_L_A 0x28       ///< First accel data register
-#define LSM6DS_STEPCOUNTER 0x4B    ///< 16-bit step counter
-#define LSM6DS_TAP_CFG 0x58        ///< Tap/pedometer configuration
+#define LSM6DS_FUNC_CFG_ACCESS 0x1  ///< Enable embedded functions register
+#define LSM6DS_FIFO_CTRL1 0x06      ///< FIFO threshold low bits
+#define LSM6DS_FIFO_CTRL2 0x07      ///< FIFO threshold high bits
+#define LSM6DS_FIFO_CTRL3 0x08      ///< FIFO decimation per sensor
+#define LSM6DS_FIFO_CTRL5 0x0A      ///< FIFO data rate and mode
+#define LSM6DS_INT1_CTRL 0x0D       ///< Interrupt control for INT 1
+#define LSM6DS_INT2_CTRL 0x0E       ///< Interrupt control for INT 2
+#define LSM6DS_WHOAMI 0x0F          ///< Chip ID register
+#define LSM6DS_CTRL1_XL 0x10        ///< Main accelerometer config register
+#define LSM6DS_CTRL2_G 0x11         ///< Main gyro config register
+#define LSM6DS_CTRL3_C 0x12         ///< Main configuration register
+#define LSM6DS_CTRL4_C 0x13         ///< Includes the data-ready mask bit
+#define LSM6DS_CTRL8_XL 0x17        ///< High and low pass for accel
+#define LSM6DS_CTRL10_C 0x19        ///< Main configuration register
+#define LSM6DS_WAKEUP_SRC 0x1B      ///< Why we woke up
+#define LSM6DS_TAP_SRC 0x1C         ///< Tap event source
+#define LSM6DS_D6D_SRC 0x1D         ///< 6D orientation event source
+#define LSM6DS_STATUS_REG 0X1E      ///< Status register
+#define LSM6DS_OUT_TEMP_L 0x20      ///< First data register (temperature low)
+#define LSM6DS_OUTX_L_G 0x22        ///< First gyro data register
+#define LSM6DS_OUTX_L_A 0x28        ///< First accel data register
+#define LSM6DS_FIFO_STATUS1 0x3A    ///< FIFO unread word count low bits
+#define LSM6DS_FIFO_STATUS3 0x3C    ///< FIFO pattern index of the next word
+#define LSM6DS_FIFO_DATA_OUT_L 0x3E ///< FIFO output port
+#define LSM6DS_STEPCOUNTER 0x4B     ///< 16-bit step counter
+#define LSM6DS_TAP_CFG 0x58         ///< Tap/pedometer configuration
+#define LSM6DS_TAP_THS_6D 0x59      ///< Tap threshold and 6D configuration
+#define LSM6DS_INT_DUR2 0x5A        ///< Tap shock, quiet and duration windows
 #define LSM6DS_WAKEUP_THS                                                      \
   0x5B ///< Single and double-tap function threshold register
 #define LSM6DS_WAKEUP_DUR                                                      \
   0x5C ///< Free-fall, wakeup, timestamp and sleep mode duration
-#define LSM6DS_MD1_CFG 0x5E ///< Functions routing on INT1 register
+#define LSM6DS_FREE_FALL 0x5D ///< Free-fall duration and threshold
+#define LSM6DS_MD1_CFG 0x5E   ///< Functions routing on INT1 register
+#define LSM6DS_MD2_CFG 0x5F   ///< Functions routing on INT2 register
+
+#ifndef LSM6DS_ENABLE_STATS
+#define LSM6DS_ENABLE_STATS                                                    \
+  0 ///< Set to 1 to compile in bus and sample counters, see getStats()
+#endif
+#ifndef LSM6DS_LEAN
+#define LSM6DS_LEAN                                                            \
+  0 ///< Set to 1 to turn the LSM6DS_ENABLE_* feature options below off
+#endif
+#ifndef LSM6DS_ENABLE_FLOAT_CACHE
+#define LSM6DS_ENABLE_FLOAT_CACHE                                              \
+  !LSM6DS_LEAN ///< Keep scaled copies of each reading: accX..gyroZ, temperature
+#endif
+#ifndef LSM6DS_ENABLE_EVENTS
+#define LSM6DS_ENABLE_EVENTS                                                   \
+  !LSM6DS_LEAN ///< Wakeup, tap, free-fall, 6D and pedometer functions
+#endif
+#ifndef LSM6DS_ENABLE_FILTERS
+#define LSM6DS_ENABLE_FILTERS                                                  \
+  !LSM6DS_LEAN ///< highPassFilter() and lowPassFilter2()
+#endif
+#ifndef LSM6DS_ENABLE_FIFO
+#define LSM6DS_ENABLE_FIFO                                                     \
+  !LSM6DS_LEAN ///< FIFO configuration, readFIFO() and getEvents()
+#endif
+#ifndef LSM6DS_ENABLE_WINDOWS
+#define LSM6DS_ENABLE_WINDOWS                                                  \
+  !LSM6DS_LEAN ///< attachWindows() statistics fed by every reading
+#endif
+#ifndef LSM6DS_ENABLE_CAPTURE
+#define LSM6DS_ENABLE_CAPTURE                                                  \
+  LSM6DS_ENABLE_EVENTS ///< attachCaptures() pre/post-trigger recording
+#endif
+#ifndef LSM6DS_ENABLE_TEMP_COMP
+#define LSM6DS_ENABLE_TEMP_COMP                                                \
+  LSM6DS_ENABLE_FLOAT_CACHE ///< Temperature bias calibration and compensation
+#endif
+#if LSM6DS_ENABLE_TEMP_COMP && !LSM6DS_ENABLE_FLOAT_CACHE
+#error "LSM6DS_ENABLE_TEMP_COMP needs LSM6DS_ENABLE_FLOAT_CACHE"
+#endif
+#if LSM6DS_ENABLE_CAPTURE && !LSM6DS_ENABLE_EVENTS
+#error "LSM6DS_ENABLE_CAPTURE needs LSM6DS_ENABLE_EVENTS"
+#endif
+#ifndef LSM6DS_BUS_RETRIES
+#define LSM6DS_BUS_RETRIES 2 ///< Extra attempts for a failed bus transfer
+#endif
+#define LSM6DS_BUS_RETRY_US                                                    \
+  50 ///< Delay before the first retry, doubled for each one after
+#define LSM6DS_CONFIG_CACHE_SIZE                                               \
+  (12 + 8 * LSM6DS_ENABLE_EVENTS) ///< Control registers kept for recover()
+#define LSM6DS_SAVED_CONFIG_SIZE                                               \
+  48 ///< Register bytes in an lsm6ds_config_t, enough for every variant
+#define LSM6DS_STATS_LATENCY_BINS                                              \
+  12 ///< Read latency histogram bins, bin N counts 2^N to 2^(N+1)-1 us
+#define LSM6DS_SPI_MAX_HZ 10000000 ///< Fastest SPI clock the chips support
+#define LSM6DS_SPI_MIN_HZ                                                      \
+  125000 ///< Slowest clock setSPIFrequency() falls back to
+#define LSM6DS_SETTLE_SAMPLES                                                  \
+  2 ///< Samples to skip after a data rate or range change
+#define LSM6DS_GYRO_TURN_ON_MS 70 ///< Gyro start-up time from power down
+#ifndef LSM6DS_EVENTS_CHUNK
+#define LSM6DS_EVENTS_CHUNK                                                    \
+  96 ///< Bytes getEvents() reads from the FIFO per burst, on the stack
+#endif
 
 /** The accelerometer data rate */
 typedef enum data_rate {
@@ -85,7 +164,139 @@ typedef enum hpf_range {
   LSM6DS_HPF_ODR_DIV_400 = 3,
 } lsm6ds_hp_filter_t;
 
+/** The FIFO operating mode */
+typedef enum fifo_mode {
+  LSM6DS_FIFO_BYPASS = 0,
+  LSM6DS_FIFO_STOP_WHEN_FULL = 1,
+  LSM6DS_FIFO_CONTINUOUS_TO_FIFO = 3,
+  LSM6DS_FIFO_BYPASS_TO_CONTINUOUS = 4,
+  LSM6DS_FIFO_CONTINUOUS = 6,
+} lsm6ds_fifo_mode_t;
+
+/** Moves a FIFO burst into memory in place of the driver's own bus read,
+    e.g. with a DMA-driven SPI transfer. `reg` is the register address
+    without the SPI read bit; return true once `len` bytes are in `buffer`. */
+typedef bool (*lsm6ds_bulk_read_t)(void *context, uint8_t reg,
+                                   uint8_t *buffer, size_t len);
+
+/** Receives one chunk of events drained by resumeBatch(), oldest first */
+typedef void (*lsm6ds_batch_callback_t)(const sensors_event_t *accel,
+                                        size_t accel_count,
+                                        const sensors_event_t *gyro,
+                                        size_t gyro_count);
+
+/** Embedded motion events, valued as their MD1_CFG/MD2_CFG routing bits */
+typedef enum motion_event {
+  LSM6DS_EVENT_6D = 0x04,
+  LSM6DS_EVENT_DOUBLE_TAP = 0x08,
+  LSM6DS_EVENT_FREE_FALL = 0x10,
+  LSM6DS_EVENT_WAKEUP = 0x20,
+  LSM6DS_EVENT_SINGLE_TAP = 0x40,
+} lsm6ds_event_t;
+
+/** Axis flags for tap detection */
+typedef enum axis_flag {
+  LSM6DS_AXIS_X = 0x01,
+  LSM6DS_AXIS_Y = 0x02,
+  LSM6DS_AXIS_Z = 0x04,
+  LSM6DS_AXIS_ALL = 0x07,
+} lsm6ds_axis_t;
+
+/** Parts of a reading whose scaled values decodeReading() brings up to date */
+typedef enum decode_flag {
+  LSM6DS_DECODE_ACCEL = 0x01,
+  LSM6DS_DECODE_GYRO = 0x02,
+  LSM6DS_DECODE_TEMP = 0x04,
+  LSM6DS_DECODE_ALL = 0x07,
+} lsm6ds_decode_t;
+
+/** 6D orientation flags, set for each axis direction past the threshold */
+typedef enum orientation_flag {
+  LSM6DS_ORIENT_X_LOW = 0x01,
+  LSM6DS_ORIENT_X_HIGH = 0x02,
+  LSM6DS_ORIENT_Y_LOW = 0x04,
+  LSM6DS_ORIENT_Y_HIGH = 0x08,
+  LSM6DS_ORIENT_Z_LOW = 0x10,
+  LSM6DS_ORIENT_Z_HIGH = 0x20,
+} lsm6ds_orientation_t;
+
+/** The free-fall detection threshold */
+typedef enum ff_threshold {
+  LSM6DS_FF_THS_156_MG,
+  LSM6DS_FF_THS_219_MG,
+  LSM6DS_FF_THS_250_MG,
+  LSM6DS_FF_THS_312_MG,
+  LSM6DS_FF_THS_344_MG,
+  LSM6DS_FF_THS_406_MG,
+  LSM6DS_FF_THS_469_MG,
+  LSM6DS_FF_THS_500_MG,
+} lsm6ds_ff_threshold_t;
+
+/** The 6D orientation threshold angle */
+typedef enum sixd_threshold {
+  LSM6DS_6D_THS_80_DEG,
+  LSM6DS_6D_THS_70_DEG,
+  LSM6DS_6D_THS_60_DEG,
+  LSM6DS_6D_THS_50_DEG,
+} lsm6ds_6d_threshold_t;
+
+/** Decoded embedded motion events, see readEvents() */
+typedef struct {
+  uint8_t events;      ///< lsm6ds_event_t flags of the events that fired
+  uint8_t tap_axes;    ///< lsm6ds_axis_t flags of the axes that saw the tap
+  bool tap_negative;   ///< True if the tap was toward the negative direction
+  uint8_t orientation; ///< lsm6ds_orientation_t flags of the current position
+} lsm6ds_events_t;
+
+/** Function pollEvents() calls for each event that fired */
+typedef void (*lsm6ds_event_callback_t)(const lsm6ds_events_t *events);
+
+/** Function pollEvents() calls when the step count changes */
+typedef void (*lsm6ds_step_callback_t)(uint16_t steps);
+
+/** Per-axis linear bias-vs-temperature model, in engineering units */
+typedef struct {
+  float ref_temp;        ///< Temperature (C) the model is centered on
+  float accel_offset[3]; ///< Accel bias at `ref_temp` in m/s^2
+  float accel_slope[3];  ///< Accel bias drift in m/s^2 per degree C
+  float gyro_offset[3];  ///< Gyro bias at `ref_temp` in rad/s
+  float gyro_slope[3];   ///< Gyro bias drift in rad/s per degree C
+} lsm6ds_temp_comp_t;
+
+/** Bus and sample counters, collected when LSM6DS_ENABLE_STATS is 1 */
+typedef struct {
+  uint32_t transactions; ///< Register bus transactions
+  uint32_t bytes;        ///< Data bytes transferred, excluding addressing
+  uint32_t failures;     ///< Transactions the bus reported as failed
+  uint32_t samples;      ///< New samples delivered by readings
+  uint32_t stale;        ///< Readings that returned an already-read sample
+  uint32_t missed;       ///< Samples overwritten before a reading, estimated
+                         ///< from the time between new ones
+  uint32_t overruns;     ///< FIFO status reads that found the FIFO overrun
+  uint32_t recoveries;   ///< Bus/chip recoveries attempted
+  uint32_t latency[LSM6DS_STATS_LATENCY_BINS]; ///< Reading latency histogram
+} lsm6ds_stats_t;
+
+/** A run of registers saved and restored as one burst */
+typedef struct {
+  uint8_t reg;  ///< First register of the run
+  uint8_t len;  ///< Number of registers
+  uint8_t bank; ///< 0 for the main registers, 1 for the embedded functions
+} lsm6ds_reg_block_t;
+
+/** Configuration snapshot from saveConfig(). Plain bytes, so it can be kept
+ * in RTC memory, EEPROM or flash and restored later. */
+typedef struct {
+  uint8_t chip_id;    ///< WHOAMI value of the chip it was taken from
+  uint8_t length;     ///< Bytes used in `regs`
+  uint8_t fifo_rates; ///< FIFO accel rate in bits 3:0, gyro rate in bits 7:4
+  uint8_t regs[LSM6DS_SAVED_CONFIG_SIZE]; ///< Register values, block by block
+} lsm6ds_config_t;
+
 class Adafruit_LSM6DS;
+class Adafruit_LSM6DS_Window;
+class Adafruit_LSM6DS_Capture;
+class Adafruit_LSM6DS_FIFORing;
 
 /** Adafruit Unified Sensor interface for temperature component of LSM6DS */
 class Adafruit_LSM6DS_Temp : public Adafruit_Sensor {
@@ -150,9 +361,24 @@ public:
   bool begin_SPI(int8_t cs_pin, int8_t sck_pin, int8_t miso_pin,
                  int8_t mosi_pin, int32_t sensorID = 0,
                  uint32_t frequency = 1000000);
+  bool begin_Bus(Adafruit_LSM6DS_Bus *bus, int32_t sensorID = 0);
+
+  uint32_t setSPIFrequency(uint32_t max_frequency = LSM6DS_SPI_MAX_HZ);
+  void enable3WireSPI(bool enable);
+  void setDataReadyMask(bool enable);
+  bool accelSettled(void);
+  bool gyroSettled(void);
 
   bool getEvent(sensors_event_t *accel, sensors_event_t *gyro,
                 sensors_event_t *temp);
+  bool readRaw(void);
+  bool readStatus(uint8_t *status);
+#if LSM6DS_ENABLE_FIFO
+  void prepareEvents(sensors_event_t *accel, sensors_event_t *gyro,
+                     size_t count);
+  virtual bool getEvents(sensors_event_t *accel, size_t *accel_count,
+                         sensors_event_t *gyro, size_t *gyro_count);
+#endif
 
   lsm6ds_data_rate_t getAccelDataRate(void);
   void setAccelDataRate(lsm6ds_data_rate_t data_rate);
@@ -171,15 +397,72 @@ public:
   void configInt1(bool drdy_temp, bool drdy_g, bool drdy_xl,
                   bool step_detect = false, bool wakeup = false);
   void configInt2(bool drdy_temp, bool drdy_g, bool drdy_xl);
+  virtual float accelScale(void);
+  float gyroScale(void);
+
+#if LSM6DS_ENABLE_FILTERS
   void highPassFilter(bool enabled, lsm6ds_hp_filter_t filter);
+  virtual void lowPassFilter2(bool enabled, lsm6ds_hp_filter_t filter);
+#endif
 
+#if LSM6DS_ENABLE_EVENTS
   void enableWakeup(bool enable, uint8_t duration = 0, uint8_t thresh = 20);
   bool awake(void);
   bool shake(void);
 
+  virtual void enableTap(bool enable, uint8_t axes = LSM6DS_AXIS_ALL,
+                         uint8_t thresh = 8, bool double_tap = false);
+  void setTapTiming(uint8_t shock = 0, uint8_t quiet = 0, uint8_t duration = 0);
+  void enableFreeFall(bool enable,
+                      lsm6ds_ff_threshold_t thresh = LSM6DS_FF_THS_312_MG,
+                      uint8_t duration = 6);
+  void enable6D(bool enable,
+                lsm6ds_6d_threshold_t thresh = LSM6DS_6D_THS_60_DEG,
+                bool only_4d = false);
+  virtual void latchEvents(bool latch);
+  void routeEvents(uint8_t int1_events, uint8_t int2_events);
+  bool readEvents(lsm6ds_events_t *events);
+  void setEventCallback(lsm6ds_event_t event, lsm6ds_event_callback_t callback);
+  void setStepCallback(lsm6ds_step_callback_t callback);
+  uint8_t pollEvents(void);
+
   void enablePedometer(bool enable);
   void resetPedometer(void);
   uint16_t readPedometer(void);
+#endif
+
+#if LSM6DS_ENABLE_FIFO
+  virtual bool configFIFO(lsm6ds_fifo_mode_t mode,
+                          lsm6ds_data_rate_t accel_batch,
+                          lsm6ds_data_rate_t gyro_batch);
+  uint16_t fifoLevel(void);
+  virtual bool readFIFOLevel(uint16_t *level);
+  virtual uint8_t fifoWordSize(void);
+  size_t readFIFO(uint8_t *buffer, size_t max_words);
+  size_t drainFIFO(Adafruit_LSM6DS_FIFORing *ring);
+  void setBulkReader(lsm6ds_bulk_read_t reader, void *context = NULL);
+  virtual bool setFIFOWatermark(uint16_t words);
+  void configFIFOInt1(bool watermark, bool overrun, bool full);
+  bool startBatching(lsm6ds_data_rate_t accel_batch,
+                     lsm6ds_data_rate_t gyro_batch, uint16_t watermark);
+  size_t resumeBatch(sensors_event_t *accel, sensors_event_t *gyro,
+                     size_t count, lsm6ds_batch_callback_t callback);
+#endif
+
+  void setI2CRecoveryPins(int8_t scl_pin, int8_t sda_pin);
+  bool recover(void);
+  bool saveConfig(lsm6ds_config_t *config);
+  bool restoreConfig(const lsm6ds_config_t *config);
+
+#if LSM6DS_ENABLE_TEMP_COMP
+  void beginTempCalibration(void);
+  bool addTempCalibrationSample(void);
+  bool fitTempCompensation(void);
+  void setTempCompensation(const lsm6ds_temp_comp_t *model,
+                           float threshold = 0.5);
+  void getTempCompensation(lsm6ds_temp_comp_t *model);
+  void enableTempCompensation(bool enable);
+#endif
 
   // Arduino compatible API
   int readAcceleration(float &x, float &y, float &z);
@@ -190,6 +473,11 @@ public:
   float gyroscopeSampleRate(void);
   int gyroscopeAvailable(void);
 
+  float scaledAccel(uint8_t axis);
+  float scaledGyro(uint8_t axis);
+  float scaledTemperature(void);
+  void setTemperatureInterval(uint32_t interval_ms);
+
   int16_t rawAccX, ///< Last reading's raw accelerometer X axis
       rawAccY,     ///< Last reading's raw accelerometer Y axis
       rawAccZ,     ///< Last reading's raw accelerometer Z axis
@@ -198,6 +486,10 @@ public:
       rawGyroY,    ///< Last reading's raw gyro Y axis
       rawGyroZ;    ///< Last reading's raw gyro Z axis
 
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  // up to date after getEvent() and the Unified Sensor getEvent()s. After
+  // readRaw() they keep the previous reading until a scaled*() accessor
+  // decodes the part it returns.
   float temperature, ///< Last reading's temperature (C)
       accX,          ///< Last reading's accelerometer X axis m/s^2
       accY,          ///< Last reading's accelerometer Y axis m/s^2
@@ -205,26 +497,72 @@ public:
       gyroX,         ///< Last reading's gyro X axis in rad/s
       gyroY,         ///< Last reading's gyro Y axis in rad/s
       gyroZ;         ///< Last reading's gyro Z axis in rad/s
+#endif
 
   Adafruit_Sensor *getTemperatureSensor(void);
   Adafruit_Sensor *getAccelerometerSensor(void);
   Adafruit_Sensor *getGyroSensor(void);
 
+#if LSM6DS_ENABLE_STATS
+  void getStats(lsm6ds_stats_t *stats);
+  void resetStats(void);
+#endif
+
+#if LSM6DS_ENABLE_WINDOWS
+  void attachWindows(Adafruit_LSM6DS_Window *accel,
+                     Adafruit_LSM6DS_Window *gyro);
+#endif
+
+#if LSM6DS_ENABLE_CAPTURE
+  void attachCaptures(Adafruit_LSM6DS_Capture *accel,
+                      Adafruit_LSM6DS_Capture *gyro,
+                      uint8_t events = LSM6DS_EVENT_WAKEUP);
+#endif
+
 protected:
   uint8_t chipID(void);
   uint8_t status(void);
-  virtual void _read(void);
+  virtual bool _read(void);
+  bool readScaled(void);
   virtual bool _init(int32_t sensor_id);
 
+  bool readRegisters(uint8_t reg, uint8_t *buffer, size_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, size_t len);
+  uint8_t readBits(uint8_t reg, uint8_t bits, uint8_t shift);
+  bool writeBits(uint8_t reg, uint8_t bits, uint8_t shift, uint8_t value);
+  bool captureConfig(void);
+  void startSettling(bool accel, uint16_t samples, uint16_t extra_ms = 0);
+  bool settledAt(bool accel, uint32_t ms);
+  virtual const lsm6ds_reg_block_t *configBlocks(uint8_t *count);
+  virtual void restoreState(const lsm6ds_config_t *config);
+  bool savedRegister(const lsm6ds_config_t *config, uint8_t reg,
+                     uint8_t bank, uint8_t *value);
+#if LSM6DS_ENABLE_FIFO
+  virtual uint8_t fifoDataRegister(void);
+  virtual void fifoOverrun(void);
+  bool readFIFOData(uint8_t *buffer, size_t len);
+  void stampEvents(sensors_event_t *events, size_t count, uint32_t last_tick,
+                   uint32_t now, lsm6ds_data_rate_t rate);
+  size_t dropUnsettled(sensors_event_t *events, size_t count, bool accel);
+  size_t finishEvents(sensors_event_t *events, size_t count, bool accel);
+#if LSM6DS_ENABLE_CAPTURE
+  void captureEvents(const sensors_event_t *events, size_t count, bool accel);
+#endif
+#endif
+#if LSM6DS_ENABLE_CAPTURE
+  void triggerCaptures(uint8_t cause);
+#endif
+
   uint16_t _sensorid_accel, ///< ID number for accelerometer
       _sensorid_gyro,       ///< ID number for gyro
       _sensorid_temp;       ///< ID number for temperature
 
   Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to I2C bus interface
   Adafruit_SPIDevice *spi_dev = NULL; ///< Pointer to SPI bus interface
+  Adafruit_LSM6DS_Bus *_bus = NULL;   ///< Bus backend from begin_Bus()
 
-  float temperature_sensitivity =
-      256.0; ///< Temp sensor sensitivity in LSB/degC
+  uint16_t temperature_sensitivity =
+      256; ///< Temp sensor sensitivity in LSB/degC
   Adafruit_LSM6DS_Temp *temp_sensor = NULL; ///< Temp sensor data object
   Adafruit_LSM6DS_Accelerometer *accel_sensor =
       NULL;                                 ///< Accelerometer data object
@@ -234,6 +572,51 @@ protected:
   lsm6ds_accel_range_t accelRangeBuffered = LSM6DS_ACCEL_RANGE_2_G;
   //! buffer for the gyroscope range
   lsm6ds_gyro_range_t gyroRangeBuffered = LSM6DS_GYRO_RANGE_250_DPS;
+  //! buffer for the accelerometer data rate
+  lsm6ds_data_rate_t accelRateBuffered = LSM6DS_RATE_SHUTDOWN;
+  //! buffer for the gyroscope data rate
+  lsm6ds_data_rate_t gyroRateBuffered = LSM6DS_RATE_SHUTDOWN;
+  //! millis() when the gyro (0) and accelerometer (1) outputs started to
+  //! settle
+  uint32_t _settle_start_ms[2] = {0, 0};
+  //! time the gyro (0) and accelerometer (1) outputs need to settle, in ms
+  uint16_t _settle_ms[2] = {0, 0};
+#if LSM6DS_ENABLE_WINDOWS
+  //! statistics windows fed raw gyro (0) and accelerometer (1) samples
+  Adafruit_LSM6DS_Window *_windows[2] = {NULL, NULL};
+#endif
+#if LSM6DS_ENABLE_CAPTURE
+  //! capture buffers fed raw gyro (0) and accelerometer (1) samples
+  Adafruit_LSM6DS_Capture *_captures[2] = {NULL, NULL};
+  uint8_t _capture_events = 0; ///< lsm6ds_event_t flags that trigger them
+#endif
+
+  //! set when a setter changed the registers kept by captureConfig()
+  bool _config_dirty = true;
+
+#if LSM6DS_ENABLE_FIFO
+  //! accelerometer rate stored in the FIFO, from configFIFO()
+  lsm6ds_data_rate_t _fifo_accel_rate = LSM6DS_RATE_SHUTDOWN;
+  //! gyroscope rate stored in the FIFO, from configFIFO()
+  lsm6ds_data_rate_t _fifo_gyro_rate = LSM6DS_RATE_SHUTDOWN;
+  uint32_t _fifo_bytes_read = 0; ///< Bytes readFIFOData() has moved
+  //! set while resumeBatch() drains, which finishes the events itself
+  bool _resuming = false;
+#endif
+
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  void decodeReading(uint8_t sensors);
+#endif
+#if LSM6DS_ENABLE_TEMP_COMP
+  void applyTempCompensation(uint8_t sensors = LSM6DS_DECODE_ALL);
+  void updateTempBias(void);
+#if LSM6DS_ENABLE_FIFO
+  void compensateEvents(sensors_event_t *events, size_t count, bool accel);
+#endif
+#endif
+#if LSM6DS_ENABLE_EVENTS
+  void setEventEnabled(uint8_t events, bool enable);
+#endif
 
 private:
   friend class Adafruit_LSM6DS_Temp; ///< Gives access to private members to
@@ -243,10 +626,67 @@ private:
                                               ///< object
   friend class Adafruit_LSM6DS_Gyro; ///< Gives access to private members to
                                      ///< Gyro data object
+  friend class Adafruit_LSM6DS_AutoDetect; ///< Hands a probed bus device
+                                           ///< to the driver it selects
 
   void fillTempEvent(sensors_event_t *temp, uint32_t timestamp);
   void fillAccelEvent(sensors_event_t *accel, uint32_t timestamp);
   void fillGyroEvent(sensors_event_t *gyro, uint32_t timestamp);
+
+  bool _begun(bool init_ok);
+
+  uint8_t _chip_id = 0;       ///< WHOAMI value seen by begin, for recover()
+  int8_t _scl_pin = -1,       ///< SCL pin for I2C bus clearing
+      _sda_pin = -1;          ///< SDA pin for I2C bus clearing
+  bool _config_valid = false; ///< True once `_config` holds a capture
+  uint8_t _config[LSM6DS_CONFIG_CACHE_SIZE]; ///< Cached control registers
+
+  SPIClass *_spi = NULL;       ///< Hardware SPI port, NULL for software SPI
+  int8_t _spi_cs = -1,         ///< SPI chip select pin
+      _spi_sck = -1,           ///< Software SPI clock pin
+      _spi_miso = -1,          ///< Software SPI MISO pin
+      _spi_mosi = -1;          ///< Software SPI MOSI pin
+  uint32_t _spi_frequency = 0; ///< SPI clock in use
+
+#if LSM6DS_ENABLE_FIFO
+  lsm6ds_bulk_read_t _bulk_reader = NULL; ///< FIFO burst override
+  void *_bulk_context = NULL;             ///< Passed to `_bulk_reader`
+#endif
+
+#if LSM6DS_ENABLE_EVENTS
+  lsm6ds_event_callback_t _event_callbacks[5] = {}; ///< By routing bit - 2
+  lsm6ds_step_callback_t _step_callback = NULL;     ///< Step count callback
+  uint16_t _last_steps = 0;    ///< Step count at the last pollEvents()
+  uint8_t _events_enabled = 0; ///< lsm6ds_event_t flags turned on
+#endif
+
+#if LSM6DS_ENABLE_FLOAT_CACHE
+  uint8_t _stale = 0; ///< lsm6ds_decode_t flags not decoded since `_read()`
+#endif
+  uint32_t _temp_interval_ms = 0; ///< Least time between temperature reads
+  uint32_t _temp_read_ms = 0;     ///< millis() of the last temperature read
+  bool _temp_due = true;          ///< Read temperature on the next drain
+
+#if LSM6DS_ENABLE_STATS
+  lsm6ds_stats_t _stats = {};   ///< Counters reported by getStats()
+  uint32_t _last_sample_us = 0; ///< Time of the last new sample
+#endif
+
+#if LSM6DS_ENABLE_TEMP_COMP
+  lsm6ds_temp_comp_t _tc_model = {}; ///< Active compensation model
+  bool _tc_enabled = false;          ///< Apply `_tc_model` to readings
+
+  float _tc_threshold = 0.5;    ///< Temp change (C) that triggers an update
+  float _tc_applied_temp = NAN; ///< Temperature the current bias is for
+  float _tc_bias[6] = {0};      ///< Current accel XYZ, gyro XYZ bias
+
+  uint32_t _tc_count = 0; ///< Calibration samples accumulated
+  float _tc_t0 = 0;       ///< Temperature of the first calibration sample
+  float _tc_sum_t = 0,    ///< Sum of (T - t0)
+      _tc_sum_tt = 0;     ///< Sum of (T - t0)^2
+  float _tc_sum_y[6],     ///< Sum of each axis reading
+      _tc_sum_ty[6];      ///< Sum of each axis reading times (T - t0)
+#endif
 };
 
 #endif
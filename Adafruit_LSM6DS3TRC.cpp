@@ -33,14 +33,12 @@ bool Adafruit_LSM6DS3TRC::_init(int32_t sensor_id) {
 
   // set the Block Data Update bit
   // this prevents MSB/LSB data registers from being updated until both are read
-  Adafruit_BusIO_Register ctrl3 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL3_C);
-  Adafruit_BusIO_RegisterBits bdu = Adafruit_BusIO_RegisterBits(&ctrl3, 1, 6);
-  bdu.write(1);
+  writeBits(LSM6DS_CTRL3_C, 1, 6, 1);
 
   return true;
 }
 
+#if LSM6DS_ENABLE_EVENTS
 /**************************************************************************/
 /*!
     @brief Enables and disables the pedometer function
@@ -49,19 +47,13 @@ bool Adafruit_LSM6DS3TRC::_init(int32_t sensor_id) {
 /**************************************************************************/
 void Adafruit_LSM6DS3TRC::enablePedometer(bool enable) {
   // enable or disable functionality
-  Adafruit_BusIO_Register ctrl10 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_CTRL10_C);
-
-  Adafruit_BusIO_RegisterBits ped_en =
-      Adafruit_BusIO_RegisterBits(&ctrl10, 1, 4);
-  ped_en.write(enable);
-
-  Adafruit_BusIO_RegisterBits func_en =
-      Adafruit_BusIO_RegisterBits(&ctrl10, 1, 2);
-  func_en.write(enable);
+  writeBits(LSM6DS_CTRL10_C, 1, 4, enable);
+  writeBits(LSM6DS_CTRL10_C, 1, 2, enable);
+  _config_dirty = true;
 
   resetPedometer();
 }
+#endif
 
 /**************************************************************************/
 /*!
@@ -69,10 +61,5 @@ void Adafruit_LSM6DS3TRC::enablePedometer(bool enable) {
     @param enable_pullups true to enable the I2C pullups, false to disable.
 */
 void Adafruit_LSM6DS3TRC::enableI2CMasterPullups(bool enable_pullups) {
-  Adafruit_BusIO_Register master_config = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS3TRC_MASTER_CONFIG);
-  Adafruit_BusIO_RegisterBits i2c_master_pu_en =
-      Adafruit_BusIO_RegisterBits(&master_config, 1, 3);
-
-  i2c_master_pu_en.write(enable_pullups);
+  writeBits(LSM6DS3TRC_MASTER_CONFIG, 1, 3, enable_pullups);
 }
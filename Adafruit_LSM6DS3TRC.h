@@ -34,7 +34,9 @@ public:
   ~Adafruit_LSM6DS3TRC(){};
 
   void enableI2CMasterPullups(bool enable_pullups);
+#if LSM6DS_ENABLE_EVENTS
   void enablePedometer(bool enable);
+#endif
 
 private:
   bool _init(int32_t sensor_id);
@@ -40,10 +40,5 @@ bool Adafruit_LSM6DSL::_init(int32_t sensor_id) {
     @param enable_pullups true to enable the I2C pullups, false to disable.
 */
 void Adafruit_LSM6DSL::enableI2CMasterPullups(bool enable_pullups) {
-  Adafruit_BusIO_Register master_config = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DSL_MASTER_CONFIG);
-  Adafruit_BusIO_RegisterBits i2c_master_pu_en =
-      Adafruit_BusIO_RegisterBits(&master_config, 1, 3);
-
-  i2c_master_pu_en.write(enable_pullups);
+  writeBits(LSM6DSL_MASTER_CONFIG, 1, 3, enable_pullups);
 }
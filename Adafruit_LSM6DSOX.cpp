@@ -11,6 +11,20 @@
 #include <Wire.h>
 
 #include "Adafruit_LSM6DSOX.h"
+#include "Adafruit_LSM6DS_Capture.h"
+#include "Adafruit_LSM6DS_Window.h"
+
+// saveConfig() blocks: PIN_CTRL, FIFO_CTRL1 to INT2_CTRL, TAP_CFG0 to
+// MD2_CFG, the user offsets, then in the embedded bank the function enables,
+// interrupt routing, FIFO batching and FSM enables, then CTRL1_XL to
+// CTRL10_C last so the sensors restart fully configured
+static const lsm6ds_reg_block_t _saved_blocks[] = {
+    {LSM6DSOX_PIN_CTRL, 1, 0},  {LSM6DSOX_FIFO_CTRL1, 8, 0},
+    {LSM6DSOX_TAP_CFG0, 10, 0}, {0x73, 3, 0},
+    {0x04, 2, 1},               {0x0A, 3, 1},
+    {0x0E, 3, 1},               {0x44, 1, 1},
+    {0x46, 2, 1},               {LSM6DSOX_CTRL1_XL, 10, 0},
+};
 
 /*!
  *    @brief  Instantiates a new LSM6DSOX class
@@ -18,11 +32,8 @@
 Adafruit_LSM6DSOX::Adafruit_LSM6DSOX(void) {}
 
 bool Adafruit_LSM6DSOX::_init(int32_t sensor_id) {
-  Adafruit_BusIO_Register chip_id = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DS_WHOAMI);
-
   // make sure we're talking to the right chip
-  if (chip_id.read() != LSM6DSOX_CHIP_ID) {
+  if (chipID() != LSM6DSOX_CHIP_ID) {
     return false;
   }
   _sensorid_accel = sensor_id;
@@ -33,18 +44,10 @@ bool Adafruit_LSM6DSOX::_init(int32_t sensor_id) {
 
   // Block Data Update
   // this prevents MSB/LSB data registers from being updated until both are read
-  Adafruit_BusIO_Register ctrl3 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DSOX_CTRL3_C);
-  Adafruit_BusIO_RegisterBits bdu = Adafruit_BusIO_RegisterBits(&ctrl3, 1, 6);
-  bdu.write(true);
+  writeBits(LSM6DSOX_CTRL3_C, 1, 6, true);
 
   // Disable I3C
-  Adafruit_BusIO_Register ctrl_9 = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DSOX_CTRL9_XL);
-  Adafruit_BusIO_RegisterBits i3c_disable_bit =
-      Adafruit_BusIO_RegisterBits(&ctrl_9, 1, 1);
-
-  i3c_disable_bit.write(true);
+  writeBits(LSM6DSOX_CTRL9_XL, 1, 1, true);
 
   // call base class _init()
   Adafruit_LSM6DS::_init(sensor_id);
@@ -58,14 +61,7 @@ bool Adafruit_LSM6DSOX::_init(int32_t sensor_id) {
     @param disable_pullups true to **disable** the I2C pullups, false to enable.
 */
 void Adafruit_LSM6DSOX::disableSPIMasterPullups(bool disable_pullups) {
-
-  Adafruit_BusIO_Register pin_config = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DSOX_PIN_CTRL);
-
-  Adafruit_BusIO_RegisterBits disable_ois_pu =
-      Adafruit_BusIO_RegisterBits(&pin_config, 1, 7);
-
-  disable_ois_pu.write(disable_pullups);
+  writeBits(LSM6DSOX_PIN_CTRL, 1, 7, disable_pullups);
 }
 
 /**************************************************************************/
@@ -74,18 +70,353 @@ void Adafruit_LSM6DSOX::disableSPIMasterPullups(bool disable_pullups) {
     @param enable_pullups true to enable the I2C pullups, false to disable.
 */
 void Adafruit_LSM6DSOX::enableI2CMasterPullups(bool enable_pullups) {
+  writeBits(LSM6DSOX_FUNC_CFG_ACCESS, 1, 6, true);
+  writeBits(LSM6DSOX_MASTER_CONFIG, 1, 3, enable_pullups);
+  writeBits(LSM6DSOX_FUNC_CFG_ACCESS, 1, 6, false);
+}
+
+#if LSM6DS_ENABLE_FILTERS
+/**************************************************************************/
+/*!
+    @brief Enables the accelerometer's second digital low pass filter. On the
+    LSM6DSOX the enable bit lives in CTRL1_XL and the bandwidth field in
+    CTRL8_XL is three bits wide; the lsm6ds_hp_filter_t values select its
+    four widest settings (ODR/4, ODR/10, ODR/20 and ODR/45).
+    @param filter_enabled Whether to enable the LPF2 filter
+    @param filter The bandwidth setting
+*/
+void Adafruit_LSM6DSOX::lowPassFilter2(bool filter_enabled,
+                                       lsm6ds_hp_filter_t filter) {
+  writeBits(LSM6DSOX_CTRL8_XL, 3, 5, filter);
+  writeBits(LSM6DSOX_CTRL1_XL, 1, 1, filter_enabled);
+  _config_dirty = true;
+
+  // settling takes about a third of the cutoff divisor in samples
+  static const uint16_t divisors[] = {4, 10, 20, 45};
+  startSettling(true, filter_enabled ? divisors[filter] / 3 + 1
+                                     : LSM6DS_SETTLE_SAMPLES);
+}
+#endif
+
+#if LSM6DS_ENABLE_EVENTS
+/**************************************************************************/
+/*!
+    @brief Enables and disables single and double tap detection. The
+    LSM6DSOX has a separate threshold per axis; all enabled axes get `thresh`.
+    @param enable True to turn on tap detection, false to turn it off
+    @param axes The lsm6ds_axis_t flags of the axes to detect taps on
+    @param thresh Tap threshold, 0-31 in steps of full scale / 32
+    @param double_tap True to also detect double taps
+*/
+/**************************************************************************/
+void Adafruit_LSM6DSOX::enableTap(bool enable, uint8_t axes, uint8_t thresh,
+                                  bool double_tap) {
+  // register order is Z, Y, X from bit 1 up
+  uint8_t tap_en = ((axes & LSM6DS_AXIS_X) << 2) | (axes & LSM6DS_AXIS_Y) |
+                   ((axes & LSM6DS_AXIS_Z) >> 2);
+  writeBits(LSM6DSOX_TAP_CFG0, 3, 1, enable ? tap_en : 0);
+
+  if (enable) {
+    // TAP_CFG1, TAP_CFG2 and TAP_THS_6D hold the X, Y and Z thresholds
+    uint8_t ths[3];
+    if (readRegisters(LSM6DSOX_TAP_CFG1, ths, 3)) {
+      for (uint8_t i = 0; i < 3; i++) {
+        ths[i] = (ths[i] & 0xE0) | (thresh & 0x1F);
+      }
+      writeRegisters(LSM6DSOX_TAP_CFG1, ths, 3);
+    }
+
+    writeBits(LSM6DS_WAKEUP_THS, 1, 7, double_tap);
+  }
+  setEventEnabled(LSM6DS_EVENT_SINGLE_TAP, enable);
+  setEventEnabled(LSM6DS_EVENT_DOUBLE_TAP, enable && double_tap);
+}
+
+/**************************************************************************/
+/*!
+    @brief Selects latched event interrupts. Latched events are cleared as
+    soon as readEvents() reads their source register.
+    @param latch True to latch events, false for pulsed events
+*/
+/**************************************************************************/
+void Adafruit_LSM6DSOX::latchEvents(bool latch) {
+  writeBits(LSM6DSOX_TAP_CFG0, 1, 0, latch);
+  writeBits(LSM6DSOX_TAP_CFG0, 1, 6, latch);
+  _config_dirty = true;
+}
+#endif
+
+#if LSM6DS_ENABLE_FIFO
+/**************************************************************************/
+/*!
+    @brief Sets up the FIFO. Each sensor is batched at its own rate.
+    Switch to LSM6DS_FIFO_BYPASS first to empty the FIFO.
+    @param mode The FIFO mode
+    @param accel_batch The accelerometer rate to store, or
+    LSM6DS_RATE_SHUTDOWN to leave it out
+    @param gyro_batch The gyro rate to store, or LSM6DS_RATE_SHUTDOWN to
+    leave it out
+    @returns True if the FIFO registers were written
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DSOX::configFIFO(lsm6ds_fifo_mode_t mode,
+                                   lsm6ds_data_rate_t accel_batch,
+                                   lsm6ds_data_rate_t gyro_batch) {
+  // FIFO_CTRL3 and FIFO_CTRL4, keeping the temperature and timestamp batching
+  uint8_t ctrl[2];
+  if (!readRegisters(LSM6DSOX_FIFO_CTRL3, ctrl, 2)) {
+    return false;
+  }
+  ctrl[0] = (gyro_batch << 4) | accel_batch;
+  ctrl[1] = (ctrl[1] & 0xF8) | mode;
+  _config_dirty = true;
+  _fifo_accel_rate = accel_batch;
+  _fifo_gyro_rate = gyro_batch;
+  _fifo_decoder.reset();
+  return writeRegisters(LSM6DSOX_FIFO_CTRL3, ctrl, 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets the FIFO level that raises the watermark flag and, once
+    routed with configFIFOInt1(), the INT1 pin
+    @param words The level in FIFO words, see fifoWordSize(). Capped at 511.
+    @returns True if the registers were written
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DSOX::setFIFOWatermark(uint16_t words) {
+  if (words > 0x1FF) {
+    words = 0x1FF;
+  }
+  uint8_t wtm = words & 0xFF;
+  _config_dirty = true;
+  return writeRegisters(LSM6DSOX_FIFO_CTRL1, &wtm, 1) &&
+         writeBits(LSM6DSOX_FIFO_CTRL2, 1, 0, words >> 8);
+}
 
-  Adafruit_BusIO_Register func_cfg_access = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DSOX_FUNC_CFG_ACCESS);
-  Adafruit_BusIO_RegisterBits master_cfg_enable_bit =
-      Adafruit_BusIO_RegisterBits(&func_cfg_access, 1, 6);
+/**************************************************************************/
+/*!
+    @brief Turns FIFO compression on or off. Compressed words pack two or
+    three accel or gyro samples as differences from the previous one, so
+    slowly changing data takes up to a third of the FIFO space and bus
+    time. Decode the words with Adafruit_LSM6DS_FIFODecoder.
+    @param enable True to compress
+    @param uncompressed How often to force a full sample, which lets a
+    decoder that starts mid-stream or misses words resynchronize
+    @returns True if the registers were written
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DSOX::setFIFOCompression(
+    bool enable, lsm6dsox_uncompressed_t uncompressed) {
+  // FIFO_COMPR_EN in the embedded function bank makes compression
+  // available, FIFO_COMPR_RT_EN turns it on
+  bool ok = writeBits(LSM6DSOX_FUNC_CFG_ACCESS, 1, 7, true);
+  ok = ok && writeBits(LSM6DSOX_EMB_FUNC_EN_B, 1, 3, enable);
+  ok = writeBits(LSM6DSOX_FUNC_CFG_ACCESS, 1, 7, false) && ok;
 
-  Adafruit_BusIO_Register master_config = Adafruit_BusIO_Register(
-      i2c_dev, spi_dev, ADDRBIT8_HIGH_TOREAD, LSM6DSOX_MASTER_CONFIG);
-  Adafruit_BusIO_RegisterBits i2c_master_pu_en =
-      Adafruit_BusIO_RegisterBits(&master_config, 1, 3);
+  uint8_t ctrl2;
+  if (!ok || !readRegisters(LSM6DSOX_FIFO_CTRL2, &ctrl2, 1)) {
+    return false;
+  }
+  ctrl2 &= ~0x46;
+  if (enable) {
+    ctrl2 |= 0x40 | (uncompressed << 1);
+  }
+  _config_dirty = true;
+  _fifo_compressed = enable;
+  return writeRegisters(LSM6DSOX_FIFO_CTRL2, &ctrl2, 1);
+}
 
-  master_cfg_enable_bit.write(true);
-  i2c_master_pu_en.write(enable_pullups);
-  master_cfg_enable_bit.write(false);
+/**************************************************************************/
+/*!
+    @brief Drains the FIFO into arrays of Unified Sensor events. Tagged
+    words are decoded as they are read, compressed or not, and each sample
+    is timestamped from its time slot. Only the timestamps and readings are
+    written, so call prepareEvents() on the arrays first.
+    @param accel Array for the accelerometer events, or NULL to discard them
+    @param accel_count Holds the size of `accel`, set to the number of
+    events stored
+    @param gyro Array for the gyro events, or NULL to discard them
+    @param gyro_count Holds the size of `gyro`, set to the number of events
+    stored
+    @returns False on a bus error; the events read before it are kept
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DSOX::getEvents(sensors_event_t *accel, size_t *accel_count,
+                                  sensors_event_t *gyro, size_t *gyro_count) {
+  size_t max_accel = accel ? *accel_count : 0;
+  size_t max_gyro = gyro ? *gyro_count : 0;
+  size_t n_accel = 0, n_gyro = 0;
+  lsm6ds_data_rate_t rate = (_fifo_accel_rate > _fifo_gyro_rate)
+                                ? _fifo_accel_rate
+                                : _fifo_gyro_rate;
+
+  uint32_t now = millis();
+  uint16_t words = 0;
+  if ((rate != LSM6DS_RATE_SHUTDOWN) && (accel || gyro)) {
+    words = fifoLevel();
+  }
+
+  const uint8_t per_word = _fifo_compressed ? LSM6DS_FIFO_MAX_SAMPLES : 1;
+  const float accel_scale = accelScale();
+  const float gyro_scale = gyroScale();
+#if LSM6DS_ENABLE_WINDOWS
+  Adafruit_LSM6DS_Window *accel_window = accelSettled() ? _windows[1] : NULL;
+  Adafruit_LSM6DS_Window *gyro_window = gyroSettled() ? _windows[0] : NULL;
+#endif
+  uint8_t buffer[LSM6DS_EVENTS_CHUNK];
+  uint32_t last_slot = 0;
+  bool ok = true;
+  while (words) {
+    // stop before a word could expand past the end of an array
+    size_t count = LSM6DS_EVENTS_CHUNK / LSM6DS_FIFO_TAGGED_WORD;
+    if (count > words) {
+      count = words;
+    }
+    if (accel && (count > (max_accel - n_accel) / per_word)) {
+      count = (max_accel - n_accel) / per_word;
+    }
+    if (gyro && (count > (max_gyro - n_gyro) / per_word)) {
+      count = (max_gyro - n_gyro) / per_word;
+    }
+    if (!count) {
+      break;
+    }
+    if (!readFIFOData(buffer, count * LSM6DS_FIFO_TAGGED_WORD)) {
+      ok = false;
+      break;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      lsm6ds_fifo_sample_t samples[LSM6DS_FIFO_MAX_SAMPLES];
+      uint8_t decoded = _fifo_decoder.decodeWord(
+          buffer + i * LSM6DS_FIFO_TAGGED_WORD, samples);
+      for (uint8_t s = 0; s < decoded; s++) {
+#if LSM6DS_ENABLE_WINDOWS
+        if ((samples[s].tag == LSM6DS_FIFO_TAG_ACCEL_NC) && accel_window) {
+          accel_window->push(samples[s].data);
+        } else if ((samples[s].tag == LSM6DS_FIFO_TAG_GYRO_NC) &&
+                   gyro_window) {
+          gyro_window->push(samples[s].data);
+        }
+#endif
+        sensors_event_t *event;
+        float scale;
+        bool is_accel = (samples[s].tag == LSM6DS_FIFO_TAG_ACCEL_NC);
+        if (is_accel && accel) {
+          event = &accel[n_accel++];
+          scale = accel_scale;
+        } else if ((samples[s].tag == LSM6DS_FIFO_TAG_GYRO_NC) && gyro) {
+          event = &gyro[n_gyro++];
+          scale = gyro_scale;
+        } else {
+          continue;
+        }
+        event->timestamp = samples[s].slot;
+        for (uint8_t axis = 0; axis < 3; axis++) {
+          event->data[axis] = samples[s].data[axis] * scale;
+        }
+#if LSM6DS_ENABLE_CAPTURE
+        // kept raw until captureEvents() knows when it was sampled
+        if (_captures[is_accel]) {
+          _captures[is_accel]->stage(samples[s].data);
+        }
+#endif
+        if ((n_accel + n_gyro == 1) ||
+            ((int32_t)(samples[s].slot - last_slot) > 0)) {
+          last_slot = samples[s].slot;
+        }
+      }
+    }
+    words -= count;
+  }
+
+  if (accel) {
+    stampEvents(accel, n_accel, last_slot, now, rate);
+    *accel_count = finishEvents(accel, n_accel, true);
+  }
+  if (gyro) {
+    stampEvents(gyro, n_gyro, last_slot, now, rate);
+    *gyro_count = finishEvents(gyro, n_gyro, false);
+  }
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief Reads how much data is waiting in the FIFO
+    @param level Set to the number of unread FIFO words, see fifoWordSize()
+    @returns False on a bus error
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DSOX::readFIFOLevel(uint16_t *level) {
+  uint8_t status[2];
+  if (!readRegisters(LSM6DSOX_FIFO_STATUS1, status, 2)) {
+    return false;
+  }
+  if (status[1] & 0x40) { // FIFO_OVR_IA
+    fifoOverrun();
+  }
+  *level = ((status[1] & 0x03) << 8) | status[0];
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief The size of one FIFO word. On the LSM6DSOX each word is a tag
+    byte naming the sensor followed by its X, Y and Z readings.
+    @returns The number of bytes in a FIFO word
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DSOX::fifoWordSize(void) { return 7; }
+
+/**************************************************************************/
+/*!
+    @brief The register FIFO words are read from
+    @returns The FIFO output register address
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DSOX::fifoDataRegister(void) {
+  return LSM6DSOX_FIFO_DATA_OUT_TAG;
+}
+
+/**************************************************************************/
+/*!
+    @brief Counts a FIFO overrun and restarts the getEvents() decoder. The
+    overwritten words broke its chain of compressed samples, so it waits
+    for the next uncompressed word instead of decoding against a lost one.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DSOX::fifoOverrun(void) {
+  Adafruit_LSM6DS::fifoOverrun();
+  _fifo_decoder.reset();
+}
+
+/**************************************************************************/
+/*!
+    @brief Brings the driver's copies of the chip settings, including the
+    FIFO compression state, in line with a restored snapshot
+    @param config The snapshot that was written
+*/
+/**************************************************************************/
+void Adafruit_LSM6DSOX::restoreState(const lsm6ds_config_t *config) {
+  Adafruit_LSM6DS::restoreState(config);
+
+  uint8_t ctrl2 = 0;
+  savedRegister(config, LSM6DSOX_FIFO_CTRL2, 0, &ctrl2);
+  _fifo_compressed = ctrl2 & 0x40;
+  _fifo_decoder.reset();
+}
+#endif
+
+/**************************************************************************/
+/*!
+    @brief Lists the register blocks saveConfig() keeps for this chip
+    @param count Set to the number of blocks
+    @returns The blocks, in the order they are restored
+*/
+/**************************************************************************/
+const lsm6ds_reg_block_t *Adafruit_LSM6DSOX::configBlocks(uint8_t *count) {
+  *count = sizeof(_saved_blocks) / sizeof(_saved_blocks[0]);
+  return _saved_blocks;
 }
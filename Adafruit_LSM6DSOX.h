@@ -19,22 +19,47 @@
 #define _ADAFRUIT_LSM6DSOX_H
 
 #include "Adafruit_LSM6DS.h"
+#include "Adafruit_LSM6DS_FIFODecoder.h"
 
 #define LSM6DSOX_CHIP_ID 0x6C ///< LSM6DSOX default device id from WHOAMI
 
 #define LSM6DSOX_FUNC_CFG_ACCESS 0x1 ///< Enable embedded functions register
 #define LSM6DSOX_PIN_CTRL 0x2        ///< Pin control register
+#define LSM6DSOX_FIFO_CTRL1 0x07     ///< FIFO watermark low bits
+#define LSM6DSOX_FIFO_CTRL2 0x08     ///< FIFO compression settings
+#define LSM6DSOX_FIFO_CTRL3 0x09     ///< FIFO batch data rates
+#define LSM6DSOX_FIFO_CTRL4 0x0A     ///< FIFO mode
 
-#define LSM6DSOX_INT1_CTRL 0x0D ///< Interrupt enable for data ready
-#define LSM6DSOX_CTRL1_XL 0x10  ///< Main accelerometer config register
-#define LSM6DSOX_CTRL2_G 0x11   ///< Main gyro config register
-#define LSM6DSOX_CTRL3_C 0x12   ///< Main configuration register
-#define LSM6DSOX_CTRL9_XL 0x18  ///< Includes i3c disable bit
+#define LSM6DSOX_INT1_CTRL 0x0D    ///< Interrupt enable for data ready
+#define LSM6DSOX_CTRL1_XL 0x10     ///< Main accelerometer config register
+#define LSM6DSOX_CTRL2_G 0x11      ///< Main gyro config register
+#define LSM6DSOX_CTRL3_C 0x12      ///< Main configuration register
+#define LSM6DSOX_CTRL8_XL 0x17     ///< High and low pass for accel
+#define LSM6DSOX_CTRL9_XL 0x18     ///< Includes i3c disable bit
+#define LSM6DSOX_TAP_CFG0 0x56     ///< Tap axis enables and interrupt latching
+#define LSM6DSOX_TAP_CFG1 0x57     ///< Tap X threshold and axis priority
+#define LSM6DSOX_TAP_CFG2 0x58     ///< Tap Y threshold and interrupt enable
+#define LSM6DSOX_TAP_THS_6D 0x59   ///< Tap Z threshold and 6D configuration
+#define LSM6DSOX_FIFO_STATUS1 0x3A ///< FIFO unread word count low bits
+#define LSM6DSOX_FIFO_DATA_OUT_TAG                                             \
+  0x78 ///< FIFO output port, tag byte followed by 6 data bytes
+
+#define LSM6DSOX_EMB_FUNC_EN_B 0x05
+///< Embedded functions enable, including FIFO compression; access must be
+///< enabled with bit FUNC_CFG_EN set to '1' in FUNC_CFG_ACCESS (01h).
 
 #define LSM6DSOX_MASTER_CONFIG 0x14
 ///< I2C Master config; access must be enabled with  bit SHUB_REG_ACCESS
 ///< is set to '1' in FUNC_CFG_ACCESS (01h).
 
+/** How often the FIFO stores an uncompressed word while compressing */
+typedef enum fifo_uncompressed {
+  LSM6DSOX_UNCOMPRESSED_NEVER,    ///< Only when the data does not compress
+  LSM6DSOX_UNCOMPRESSED_EVERY_8,  ///< At least every 8 batch periods
+  LSM6DSOX_UNCOMPRESSED_EVERY_16, ///< At least every 16 batch periods
+  LSM6DSOX_UNCOMPRESSED_EVERY_32, ///< At least every 32 batch periods
+} lsm6dsox_uncompressed_t;
+
 /*!
  *    @brief  Class that stores state and functions for interacting with
  *            the LSM6DSOX I2C Digital Potentiometer
@@ -45,9 +70,43 @@ public:
 
   void enableI2CMasterPullups(bool enable_pullups);
   void disableSPIMasterPullups(bool disable_pullups);
+#if LSM6DS_ENABLE_FILTERS
+  void lowPassFilter2(bool enabled, lsm6ds_hp_filter_t filter);
+#endif
+#if LSM6DS_ENABLE_EVENTS
+  void enableTap(bool enable, uint8_t axes = LSM6DS_AXIS_ALL,
+                 uint8_t thresh = 8, bool double_tap = false);
+  void latchEvents(bool latch);
+#endif
+
+#if LSM6DS_ENABLE_FIFO
+  bool configFIFO(lsm6ds_fifo_mode_t mode, lsm6ds_data_rate_t accel_batch,
+                  lsm6ds_data_rate_t gyro_batch);
+  bool readFIFOLevel(uint16_t *level);
+  uint8_t fifoWordSize(void);
+  bool setFIFOWatermark(uint16_t words);
+  bool setFIFOCompression(
+      bool enable,
+      lsm6dsox_uncompressed_t uncompressed = LSM6DSOX_UNCOMPRESSED_NEVER);
+  bool getEvents(sensors_event_t *accel, size_t *accel_count,
+                 sensors_event_t *gyro, size_t *gyro_count);
+#endif
+
+protected:
+  const lsm6ds_reg_block_t *configBlocks(uint8_t *count);
+#if LSM6DS_ENABLE_FIFO
+  void restoreState(const lsm6ds_config_t *config);
+  uint8_t fifoDataRegister(void);
+  void fifoOverrun(void);
+#endif
 
 private:
   bool _init(int32_t sensor_id);
+
+#if LSM6DS_ENABLE_FIFO
+  Adafruit_LSM6DS_FIFODecoder _fifo_decoder; ///< State for getEvents()
+  bool _fifo_compressed = false;             ///< Words may hold several samples
+#endif
 };
 
 #endif
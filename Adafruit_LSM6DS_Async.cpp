@@ -0,0 +1,313 @@
+/*!
+ *  @file Adafruit_LSM6DS_Async.cpp
+ *  C++20 coroutine interface for reading LSM6DS sensors from a
+ *  single-threaded event loop on Linux hosts
+ *
+ *  Register transfers on i2c-dev and spidev are short ioctls that finish
+ *  in well under a sample period, so they are made in place. What would
+ *  block is waiting for data, and that is where a coroutine parks: it
+ *  checks the sensor, and if there is nothing yet it sleeps in the loop's
+ *  timer heap until the next poll. The loop waits for the soonest timer or
+ *  any watched descriptor in a single ppoll(), which is also how other
+ *  async I/O on the same thread gets serviced.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#if defined(__linux__) && defined(__cpp_impl_coroutine)
+
+#include "Adafruit_LSM6DS_Async.h"
+#include <algorithm>
+#include <chrono>
+
+/*!
+ *    @brief  Instantiates an empty loop
+ */
+Adafruit_LSM6DS_EventLoop::Adafruit_LSM6DS_EventLoop(void) {}
+
+/*!
+ *    @brief  Frees any spawned tasks that haven't finished
+ */
+Adafruit_LSM6DS_EventLoop::~Adafruit_LSM6DS_EventLoop() {
+  for (size_t i = 0; i < _spawned.size(); i++) {
+    _spawned[i].destroy();
+  }
+}
+
+/*!
+ *    @brief  Starts a top-level task on the loop. The loop owns it from
+ *            here and frees it when it returns.
+ *    @param  task The task, typically the result of calling a coroutine
+ */
+void Adafruit_LSM6DS_EventLoop::spawn(Adafruit_LSM6DS_Task<void> task) {
+  std::coroutine_handle<lsm6ds_task_promise<void>> handle = task.release();
+  handle.promise().loop = this;
+  _spawned.push_back(handle);
+  _ready.push_back(handle);
+}
+
+/*!
+ *    @brief  Waits without blocking the thread: `co_await loop.sleep(us)`
+ *    @param  us The delay in microseconds
+ *    @returns The awaiter
+ */
+Adafruit_LSM6DS_EventLoop::sleep_awaiter
+Adafruit_LSM6DS_EventLoop::sleep(uint32_t us) {
+  return sleep_awaiter{this, now() + us};
+}
+
+/*!
+ *    @brief  Waits for a file descriptor without blocking the thread:
+ *            `co_await loop.ready(fd)`
+ *    @param  fd The descriptor, eg. a socket or a GPIO line event
+ *    @param  events The poll() events to wait for
+ *    @returns The awaiter, which gives the poll() revents
+ */
+Adafruit_LSM6DS_EventLoop::fd_awaiter
+Adafruit_LSM6DS_EventLoop::ready(int fd, short events) {
+  return fd_awaiter{this, fd, events};
+}
+
+/*!
+ *    @brief  Runs until every spawned task has returned or stop() is
+ *            called, or until the tasks left wait on nothing the loop
+ *            knows about
+ */
+void Adafruit_LSM6DS_EventLoop::run(void) {
+  _stopping = false;
+  while (!_stopping && !_spawned.empty() && runOnce(-1)) {
+  }
+}
+
+/*!
+ *    @brief  Resumes the coroutines that are ready, first waiting up to a
+ *            given time for one to become ready
+ *    @param  timeout_us The longest wait, or -1 to wait as long as needed
+ *    @returns False if nothing ran because nothing was ready or parked
+ */
+bool Adafruit_LSM6DS_EventLoop::runOnce(int32_t timeout_us) {
+  if (_ready.empty() && _timers.empty() && _watches.empty()) {
+    return false;
+  }
+
+  int64_t wait_us = _ready.empty() ? timeout_us : 0;
+  if (!_timers.empty()) {
+    uint64_t now_us = now();
+    uint64_t due_us = _timers.top().due_us;
+    int64_t until = (due_us > now_us) ? (int64_t)(due_us - now_us) : 0;
+    if ((wait_us < 0) || (until < wait_us)) {
+      wait_us = until;
+    }
+  }
+
+  _fds.clear();
+  for (size_t i = 0; i < _watches.size(); i++) {
+    _fds.push_back(
+        pollfd{_watches[i].awaiter->fd, _watches[i].awaiter->events, 0});
+  }
+  if (wait_us || !_fds.empty()) {
+    timespec timeout = {(time_t)(wait_us / 1000000),
+                        (long)(wait_us % 1000000) * 1000};
+    int fired = ppoll(_fds.data(), _fds.size(),
+                      (wait_us < 0) ? NULL : &timeout, NULL);
+    // take every watch that fired, newest first so indices stay valid
+    for (size_t i = _watches.size(); fired > 0 && i-- > 0;) {
+      if (_fds[i].revents) {
+        _watches[i].awaiter->revents = _fds[i].revents;
+        _ready.push_back(_watches[i].waiter);
+        _watches.erase(_watches.begin() + i);
+        fired--;
+      }
+    }
+  }
+
+  uint64_t now_us = now();
+  while (!_timers.empty() && (_timers.top().due_us <= now_us)) {
+    _ready.push_back(_timers.top().waiter);
+    _timers.pop();
+  }
+
+  // only what is ready now; coroutines that park again wait their turn
+  size_t count = _ready.size();
+  for (size_t i = 0; (i < count) && !_stopping; i++) {
+    std::coroutine_handle<> next = _ready.front();
+    _ready.pop_front();
+    next.resume();
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Makes run() return once the coroutine running now suspends
+ */
+void Adafruit_LSM6DS_EventLoop::stop(void) { _stopping = true; }
+
+/*!
+ *    @brief  Counts the spawned tasks that haven't returned yet
+ *    @returns The number of live top-level tasks
+ */
+size_t Adafruit_LSM6DS_EventLoop::tasks(void) { return _spawned.size(); }
+
+/*!
+ *    @brief  The loop's clock, which never goes backwards
+ *    @returns Microseconds since an arbitrary point
+ */
+uint64_t Adafruit_LSM6DS_EventLoop::now(void) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*!
+ *    @brief  Frees a spawned task that has returned
+ *    @param  task The task, suspended at its end
+ */
+void Adafruit_LSM6DS_EventLoop::_finished(std::coroutine_handle<> task) {
+  std::vector<std::coroutine_handle<>>::iterator it =
+      std::find(_spawned.begin(), _spawned.end(), task);
+  if (it != _spawned.end()) {
+    _spawned.erase(it);
+  }
+  task.destroy();
+}
+
+/*!
+ *    @brief  Parks a coroutine until a time
+ *    @param  due_us When to resume it, see now()
+ *    @param  waiter The coroutine
+ */
+void Adafruit_LSM6DS_EventLoop::_addTimer(uint64_t due_us,
+                                          std::coroutine_handle<> waiter) {
+  _timers.push(timer{due_us, _order++, waiter});
+}
+
+/*!
+ *    @brief  Parks a coroutine until a file descriptor is ready
+ *    @param  watch The awaiter holding the descriptor and events
+ *    @param  waiter The coroutine
+ */
+void Adafruit_LSM6DS_EventLoop::_addWatch(fd_awaiter *watch,
+                                          std::coroutine_handle<> waiter) {
+  _watches.push_back({watch, waiter});
+}
+
+/*!
+ *    @brief  Instantiates the awaitable interface of a sensor
+ *    @param  sensor The sensor, already started with begin_Bus() or similar
+ *    @param  loop The loop its coroutines park in while waiting for data
+ *    @param  poll_us Wait between polls of the sensor
+ */
+Adafruit_LSM6DS_Async::Adafruit_LSM6DS_Async(Adafruit_LSM6DS *sensor,
+                                             Adafruit_LSM6DS_EventLoop *loop,
+                                             uint32_t poll_us)
+    : _sensor(sensor), _loop(loop), _poll_us(poll_us) {}
+
+/*!
+ *    @brief  Sets how often a waiting coroutine polls the sensor. Longer
+ *            waits cost fewer bus transfers and more latency; about one
+ *            sample period suits read(), and the time to fill a batch
+ *            suits readBatch().
+ *    @param  poll_us Wait between polls in microseconds
+ */
+void Adafruit_LSM6DS_Async::setPollInterval(uint32_t poll_us) {
+  _poll_us = poll_us;
+}
+
+/*!
+ *    @brief  Waits for a new sample and reads it, like getEvent():
+ *            `bool ok = co_await imu.read(&accel, &gyro, &temp)`
+ *    @param  accel Event to fill with acceleration data
+ *    @param  gyro Event to fill with gyro data
+ *    @param  temp Event to fill with temperature data
+ *    @returns A task giving true once the sample was read, false on a bus
+ *            error
+ */
+Adafruit_LSM6DS_Task<bool> Adafruit_LSM6DS_Async::read(sensors_event_t *accel,
+                                                       sensors_event_t *gyro,
+                                                       sensors_event_t *temp) {
+  for (;;) {
+    uint8_t status;
+    if (!_sensor->readStatus(&status)) {
+      co_return false;
+    }
+    if (status & 0x03) {
+      break;
+    }
+    co_await _loop->sleep(_poll_us);
+  }
+  co_return _sensor->getEvent(accel, gyro, temp);
+}
+
+#if LSM6DS_ENABLE_FIFO
+/*!
+ *    @brief  Waits for the FIFO to fill and drains it, like getEvents():
+ *            `lsm6ds_batch_t batch = co_await imu.readBatch(a, g, 32)`.
+ *            Set the FIFO up with configFIFO(), and the arrays with
+ *            prepareEvents(), first.
+ *    @param  accel Array for up to `count` accelerometer events, or NULL
+ *    @param  gyro Array for up to `count` gyro events, or NULL
+ *    @param  count The size of each array
+ *    @param  min_words The FIFO level to wait for, in FIFO words
+ *    @returns A task giving the number of events stored in each array,
+ *             or `ok` false on a bus error
+ */
+Adafruit_LSM6DS_Task<lsm6ds_batch_t>
+Adafruit_LSM6DS_Async::readBatch(sensors_event_t *accel, sensors_event_t *gyro,
+                                 size_t count, uint16_t min_words) {
+  for (;;) {
+    uint16_t level;
+    if (!_sensor->readFIFOLevel(&level)) {
+      co_return lsm6ds_batch_t{false, 0, 0};
+    }
+    if (level >= min_words) {
+      break;
+    }
+    co_await _loop->sleep(_poll_us);
+  }
+  lsm6ds_batch_t batch = {false, count, count};
+  batch.ok = _sensor->getEvents(accel, &batch.accel_count, gyro,
+                                &batch.gyro_count);
+  co_return batch;
+}
+#endif
+
+#if LSM6DS_ENABLE_EVENTS
+/*!
+ *    @brief  Waits for an embedded motion event:
+ *            `lsm6ds_event_wait_t wait = co_await imu.nextEvent()`. Turn
+ *            the events on with enableWakeup(), enableTap() and so on
+ *            first. Callbacks set with setEventCallback() are not called.
+ *            Reading the event sources clears them on the chip, so events
+ *            outside `events` are kept here for a later nextEvent() that
+ *            asks for them, with the tap and orientation details of the
+ *            newest read.
+ *    @param  events The lsm6ds_event_t flags to wait for
+ *    @returns A task giving the events that fired, only those asked for,
+ *             or `ok` false on a bus error
+ */
+Adafruit_LSM6DS_Task<lsm6ds_event_wait_t>
+Adafruit_LSM6DS_Async::nextEvent(uint8_t events) {
+  for (;;) {
+    if (_unclaimed.events & events) {
+      lsm6ds_event_wait_t wait = {true, _unclaimed};
+      wait.fired.events &= events;
+      _unclaimed.events &= ~events;
+      co_return wait;
+    }
+
+    lsm6ds_events_t fired;
+    if (!_sensor->readEvents(&fired)) {
+      co_return lsm6ds_event_wait_t{false, {}};
+    }
+    if (fired.events) {
+      fired.events |= _unclaimed.events;
+      _unclaimed = fired;
+    }
+    if (!(_unclaimed.events & events)) {
+      co_await _loop->sleep(_poll_us);
+    }
+  }
+}
+#endif
+
+#endif
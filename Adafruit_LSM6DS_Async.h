@@ -0,0 +1,318 @@
+/*!
+ *  @file Adafruit_LSM6DS_Async.h
+ *
+ * 	C++20 coroutine interface for reading LSM6DS sensors from a
+ *      single-threaded event loop on Linux hosts
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_ASYNC_H
+#define _ADAFRUIT_LSM6DS_ASYNC_H
+
+#if defined(__linux__) && defined(__cpp_impl_coroutine)
+
+#include "Adafruit_LSM6DS.h"
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <poll.h>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+#define LSM6DS_ASYNC_POLL_US 1000 ///< Default wait between sensor polls
+
+class Adafruit_LSM6DS_EventLoop;
+
+/** Promise parts shared by every Adafruit_LSM6DS_Task */
+struct lsm6ds_task_promise_base {
+  std::coroutine_handle<> continuation;      ///< Awaiting coroutine, if any
+  Adafruit_LSM6DS_EventLoop *loop = nullptr; ///< Owner of a spawned task
+
+  /*!  @brief  Tasks start when awaited or spawned
+   *   @returns An awaiter that always suspends */
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  /** Resumes the awaiting coroutine, or frees a spawned task */
+  struct final_awaiter {
+    /*!  @brief  Always suspends, so the frame outlives the result
+     *   @returns False */
+    bool await_ready() noexcept { return false; }
+    /*!  @brief  Hands control to whoever waits on the finished task
+     *   @param  done The finished task
+     *   @returns The coroutine to run next */
+    template <typename P>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<P> done) noexcept;
+    /*!  @brief  Never resumed */
+    void await_resume() noexcept {}
+  };
+  /*!  @brief  Passes control on once the task returns
+   *   @returns The final awaiter */
+  final_awaiter final_suspend() noexcept { return {}; }
+  /*!  @brief  Exceptions can't cross the event loop */
+  void unhandled_exception() { std::terminate(); }
+};
+
+template <typename T> class Adafruit_LSM6DS_Task;
+
+/** Promise of a task producing a T */
+template <typename T> struct lsm6ds_task_promise : lsm6ds_task_promise_base {
+  T value{}; ///< The co_return value
+
+  /*!  @brief  Wraps the coroutine in its task
+   *   @returns The task */
+  Adafruit_LSM6DS_Task<T> get_return_object();
+  /*!  @brief  Keeps the result for the awaiting coroutine
+   *   @param  result The co_return value */
+  void return_value(T result) { value = result; }
+};
+
+/** Promise of a task producing nothing */
+template <> struct lsm6ds_task_promise<void> : lsm6ds_task_promise_base {
+  /*!  @brief  Wraps the coroutine in its task
+   *   @returns The task */
+  Adafruit_LSM6DS_Task<void> get_return_object();
+  /*!  @brief  Ends the task */
+  void return_void() {}
+};
+
+/*!
+ *    @brief  A lazily started coroutine. co_await it from another task, or
+ *            hand a top-level Adafruit_LSM6DS_Task<> to
+ *            Adafruit_LSM6DS_EventLoop::spawn().
+ */
+template <typename T = void> class Adafruit_LSM6DS_Task {
+public:
+  using promise_type = lsm6ds_task_promise<T>; ///< Coroutine promise
+
+  /*!  @brief  Takes ownership of a coroutine
+   *   @param  handle The coroutine */
+  explicit Adafruit_LSM6DS_Task(std::coroutine_handle<promise_type> handle)
+      : _handle(handle) {}
+  /*!  @brief  Moves a task
+   *   @param  other The task to take the coroutine from */
+  Adafruit_LSM6DS_Task(Adafruit_LSM6DS_Task &&other) noexcept
+      : _handle(other._handle) {
+    other._handle = nullptr;
+  }
+  Adafruit_LSM6DS_Task(const Adafruit_LSM6DS_Task &) = delete;
+  Adafruit_LSM6DS_Task &operator=(const Adafruit_LSM6DS_Task &) = delete;
+  /*!  @brief  Frees the coroutine unless it was released */
+  ~Adafruit_LSM6DS_Task() {
+    if (_handle) {
+      _handle.destroy();
+    }
+  }
+
+  /*!  @brief  Tasks only run once awaited
+   *   @returns False */
+  bool await_ready() noexcept { return false; }
+  /*!  @brief  Starts the task, to resume the caller when it returns
+   *   @param  caller The awaiting coroutine
+   *   @returns The task, to run right away */
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+    _handle.promise().continuation = caller;
+    return _handle;
+  }
+  /*!  @brief  Gets the task's result
+   *   @returns The co_return value */
+  T await_resume() {
+    if constexpr (!std::is_void_v<T>) {
+      return _handle.promise().value;
+    }
+  }
+
+  /*!  @brief  Gives up ownership of the coroutine
+   *   @returns The coroutine */
+  std::coroutine_handle<promise_type> release() {
+    std::coroutine_handle<promise_type> handle = _handle;
+    _handle = nullptr;
+    return handle;
+  }
+
+private:
+  std::coroutine_handle<promise_type> _handle; ///< The owned coroutine
+};
+
+template <typename T>
+Adafruit_LSM6DS_Task<T> lsm6ds_task_promise<T>::get_return_object() {
+  return Adafruit_LSM6DS_Task<T>(
+      std::coroutine_handle<lsm6ds_task_promise<T>>::from_promise(*this));
+}
+
+inline Adafruit_LSM6DS_Task<void>
+lsm6ds_task_promise<void>::get_return_object() {
+  return Adafruit_LSM6DS_Task<void>(
+      std::coroutine_handle<lsm6ds_task_promise<void>>::from_promise(*this));
+}
+
+/*!
+ *    @brief  Runs coroutines on the calling thread. A coroutine waiting on
+ *            time or on a file descriptor is parked in the loop, which
+ *            sleeps in one ppoll() until the next of them is due, so any
+ *            number of sensors and sockets share a thread. A stand-in for
+ *            the loop of a larger framework: run it on its own thread or
+ *            call runOnce() from another loop.
+ */
+class Adafruit_LSM6DS_EventLoop {
+public:
+  /** Awaiter that resumes after a delay */
+  struct sleep_awaiter {
+    Adafruit_LSM6DS_EventLoop *loop; ///< The loop to park in
+    uint64_t due_us;                 ///< When to resume, see now()
+    /*!  @brief  Skips suspending once the time has passed
+     *   @returns True if already due */
+    bool await_ready() { return due_us <= loop->now(); }
+    /*!  @brief  Parks the coroutine until it is due
+     *   @param  waiter The sleeping coroutine */
+    void await_suspend(std::coroutine_handle<> waiter) {
+      loop->_addTimer(due_us, waiter);
+    }
+    /*!  @brief  Nothing to return */
+    void await_resume() {}
+  };
+
+  /** Awaiter that resumes once a file descriptor is ready */
+  struct fd_awaiter {
+    Adafruit_LSM6DS_EventLoop *loop; ///< The loop to park in
+    int fd;                          ///< The descriptor to watch
+    short events;                    ///< poll() events to wait for
+    short revents = 0;               ///< poll() events seen
+    /*!  @brief  Always waits for the loop's next poll
+     *   @returns False */
+    bool await_ready() { return false; }
+    /*!  @brief  Parks the coroutine until the descriptor is ready
+     *   @param  waiter The waiting coroutine */
+    void await_suspend(std::coroutine_handle<> waiter) {
+      loop->_addWatch(this, waiter);
+    }
+    /*!  @brief  Gets what the descriptor is ready for
+     *   @returns The poll() revents, eg. POLLIN or POLLHUP */
+    short await_resume() { return revents; }
+  };
+
+  Adafruit_LSM6DS_EventLoop(void);
+  ~Adafruit_LSM6DS_EventLoop();
+
+  void spawn(Adafruit_LSM6DS_Task<void> task);
+  sleep_awaiter sleep(uint32_t us);
+  fd_awaiter ready(int fd, short events = POLLIN);
+
+  void run(void);
+  bool runOnce(int32_t timeout_us);
+  void stop(void);
+  size_t tasks(void);
+  uint64_t now(void);
+
+private:
+  friend struct lsm6ds_task_promise_base::final_awaiter; ///< Calls _finished()
+
+  /** A coroutine parked until a time */
+  struct timer {
+    uint64_t due_us;                ///< When to resume it
+    uint64_t order;                 ///< Keeps equal times first in, first out
+    std::coroutine_handle<> waiter; ///< The coroutine
+    /*!  @brief  Orders the heap soonest first
+     *   @param  other The timer to compare with
+     *   @returns True if this one is due later */
+    bool operator>(const timer &other) const {
+      return (due_us != other.due_us) ? (due_us > other.due_us)
+                                      : (order > other.order);
+    }
+  };
+  /** A coroutine parked on a file descriptor */
+  struct watch {
+    fd_awaiter *awaiter;            ///< Where to report the events
+    std::coroutine_handle<> waiter; ///< The coroutine
+  };
+
+  std::deque<std::coroutine_handle<>> _ready; ///< Coroutines to resume
+  //! parked coroutines, the soonest due on top
+  std::priority_queue<timer, std::vector<timer>, std::greater<timer>> _timers;
+  std::vector<watch> _watches;                   ///< Waiting on descriptors
+  std::vector<pollfd> _fds;                      ///< Scratch list for ppoll()
+  std::vector<std::coroutine_handle<>> _spawned; ///< Live spawned tasks
+  uint64_t _order = 0;                           ///< Timers added so far
+  bool _stopping = false;                        ///< Set by stop()
+
+  void _finished(std::coroutine_handle<> task);
+  void _addTimer(uint64_t due_us, std::coroutine_handle<> waiter);
+  void _addWatch(fd_awaiter *watch, std::coroutine_handle<> waiter);
+};
+
+template <typename P>
+std::coroutine_handle<>
+lsm6ds_task_promise_base::final_awaiter::await_suspend(
+    std::coroutine_handle<P> done) noexcept {
+  lsm6ds_task_promise_base &promise = done.promise();
+  if (promise.continuation) {
+    return promise.continuation;
+  }
+  if (promise.loop) {
+    promise.loop->_finished(done); // a spawned task frees itself
+  }
+  return std::noop_coroutine();
+}
+
+/** Result of Adafruit_LSM6DS_Async::readBatch() */
+typedef struct {
+  bool ok;            ///< False on a bus error
+  size_t accel_count; ///< Accelerometer events stored
+  size_t gyro_count;  ///< Gyro events stored
+} lsm6ds_batch_t;
+
+#if LSM6DS_ENABLE_EVENTS
+/** Result of Adafruit_LSM6DS_Async::nextEvent() */
+typedef struct {
+  bool ok;               ///< False on a bus error
+  lsm6ds_events_t fired; ///< The events waited for that fired
+} lsm6ds_event_wait_t;
+#endif
+
+/*!
+ *    @brief  Awaitable reads of one sensor. Each call polls the sensor with
+ *            short register reads and parks the coroutine in the event
+ *            loop between polls, so waiting for data never blocks the
+ *            thread. The blocking API on the sensor stays usable, from the
+ *            loop's thread only.
+ */
+class Adafruit_LSM6DS_Async {
+public:
+  Adafruit_LSM6DS_Async(Adafruit_LSM6DS *sensor,
+                        Adafruit_LSM6DS_EventLoop *loop,
+                        uint32_t poll_us = LSM6DS_ASYNC_POLL_US);
+
+  void setPollInterval(uint32_t poll_us);
+
+  Adafruit_LSM6DS_Task<bool> read(sensors_event_t *accel,
+                                  sensors_event_t *gyro,
+                                  sensors_event_t *temp);
+#if LSM6DS_ENABLE_FIFO
+  Adafruit_LSM6DS_Task<lsm6ds_batch_t>
+  readBatch(sensors_event_t *accel, sensors_event_t *gyro, size_t count,
+            uint16_t min_words = 1);
+#endif
+#if LSM6DS_ENABLE_EVENTS
+  Adafruit_LSM6DS_Task<lsm6ds_event_wait_t> nextEvent(uint8_t events = 0xFF);
+#endif
+
+private:
+  Adafruit_LSM6DS *_sensor;         ///< The sensor
+  Adafruit_LSM6DS_EventLoop *_loop; ///< The loop its coroutines park in
+  uint32_t _poll_us;                ///< Wait between polls
+#if LSM6DS_ENABLE_EVENTS
+  //! events read by nextEvent() that no caller has waited for yet
+  lsm6ds_events_t _unclaimed = {};
+#endif
+};
+
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+/*!
+ *  @file Adafruit_LSM6DS_AutoDetect.cpp
+ *  Single-probe factory that starts whichever LSM6DS family chip is connected
+ *
+ *  Trying each variant's begin in turn opens a new bus device and reads
+ *  WHOAMI for every miss. Here the device is opened and WHOAMI read once,
+ *  then the matching driver is built in place and given that device.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_AutoDetect.h"
+
+/** Tag selecting the placement allocator below */
+struct lsm6ds_placement_t {};
+
+/*!
+ *    @brief  Placement allocator for building drivers in the factory's
+ *            storage. Not every Arduino core ships <new>.
+ *    @param  size The object size, unused
+ *    @param  ptr The storage to build the object in
+ *    @returns `ptr`
+ */
+void *operator new(size_t size, void *ptr, lsm6ds_placement_t) {
+  (void)size;
+  return ptr;
+}
+
+/** WHOAMI value of each variant. Shared IDs list the default first. */
+static const struct {
+  uint8_t chip_id;          ///< WHOAMI value
+  lsm6ds_variant_t variant; ///< Driver class for the chip
+} lsm6ds_variants[] = {
+    {LSM6DS33_CHIP_ID, LSM6DS_VARIANT_LSM6DS33},
+    {LSM6DS3_CHIP_ID, LSM6DS_VARIANT_LSM6DS3},
+    {LSM6DS3TRC_CHIP_ID, LSM6DS_VARIANT_LSM6DS3TRC},
+    {LSM6DSL_CHIP_ID, LSM6DS_VARIANT_LSM6DSL},
+    {ISM330DHCX_CHIP_ID, LSM6DS_VARIANT_ISM330DHCX},
+    {LSM6DSOX_CHIP_ID, LSM6DS_VARIANT_LSM6DSOX},
+    {LSM6DSO32_CHIP_ID, LSM6DS_VARIANT_LSM6DSO32},
+};
+
+/*!
+ *    @brief  Instantiates a factory with no driver running
+ */
+Adafruit_LSM6DS_AutoDetect::Adafruit_LSM6DS_AutoDetect(void) {}
+
+/*!
+ *    @brief  Destroys the running driver, if any
+ */
+Adafruit_LSM6DS_AutoDetect::~Adafruit_LSM6DS_AutoDetect(void) { end(); }
+
+/*!
+ *    @brief  Picks a variant for a WHOAMI value that several chips share.
+ *            Call once per variant, before begin.
+ *    @param  variant The driver class to use when its chip ID is read
+ */
+void Adafruit_LSM6DS_AutoDetect::prefer(lsm6ds_variant_t variant) {
+  _preferred |= 1 << variant;
+}
+
+/*!
+ *    @brief  Probes an I2C address and starts the driver for the chip found
+ *    @param  i2c_addr The I2C address to probe
+ *    @param  wire The Wire object to be used for I2C connections.
+ *    @param  sensorID The user-defined ID to differentiate different sensors
+ *    @returns The running driver, or NULL if no known chip answered or it
+ *    failed to initialize
+ */
+Adafruit_LSM6DS *Adafruit_LSM6DS_AutoDetect::begin_I2C(uint8_t i2c_addr,
+                                                       TwoWire *wire,
+                                                       int32_t sensorID) {
+  end();
+
+  Adafruit_I2CDevice *i2c_dev = new Adafruit_I2CDevice(i2c_addr, wire);
+  uint8_t reg = LSM6DS_WHOAMI, chip_id = 0;
+  if (!i2c_dev->begin() || !i2c_dev->write_then_read(&reg, 1, &chip_id, 1) ||
+      !_construct(_select(chip_id))) {
+    delete i2c_dev;
+    return NULL;
+  }
+
+  _driver->i2c_dev = i2c_dev;
+  return _start(sensorID);
+}
+
+/*!
+ *    @brief  Probes a hardware SPI chip select and starts the driver for the
+ *            chip found
+ *    @param  cs_pin The arduino pin # connected to chip select
+ *    @param  theSPI The SPI object to be used for SPI connections.
+ *    @param  sensorID The user-defined ID to differentiate different sensors
+ *    @param  frequency The SPI bus frequency
+ *    @returns The running driver, or NULL if no known chip answered or it
+ *    failed to initialize
+ */
+Adafruit_LSM6DS *Adafruit_LSM6DS_AutoDetect::begin_SPI(uint8_t cs_pin,
+                                                       SPIClass *theSPI,
+                                                       int32_t sensorID,
+                                                       uint32_t frequency) {
+  end();
+
+  Adafruit_SPIDevice *spi_dev =
+      new Adafruit_SPIDevice(cs_pin, frequency, SPI_BITORDER_MSBFIRST,
+                             SPI_MODE0, theSPI);
+  uint8_t addr = LSM6DS_WHOAMI | 0x80, chip_id = 0;
+  if (!spi_dev->begin() || !spi_dev->write_then_read(&addr, 1, &chip_id, 1) ||
+      !_construct(_select(chip_id))) {
+    delete spi_dev;
+    return NULL;
+  }
+
+  _driver->spi_dev = spi_dev;
+  _driver->_spi = theSPI;
+  _driver->_spi_cs = cs_pin;
+  _driver->_spi_frequency = frequency;
+  return _start(sensorID);
+}
+
+/*!
+ *    @brief  Probes a bus backend and starts the driver for the chip found.
+ *            The backend is not owned and must outlive the driver.
+ *    @param  bus The bus backend the sensor is connected to
+ *    @param  sensorID The user-defined ID to differentiate different sensors
+ *    @returns The running driver, or NULL if no known chip answered or it
+ *    failed to initialize
+ */
+Adafruit_LSM6DS *Adafruit_LSM6DS_AutoDetect::begin_Bus(Adafruit_LSM6DS_Bus *bus,
+                                                       int32_t sensorID) {
+  end();
+
+  uint8_t chip_id = 0;
+  if (!bus->begin() || !bus->read(LSM6DS_WHOAMI, &chip_id, 1) ||
+      !_construct(_select(chip_id))) {
+    return NULL;
+  }
+
+  _driver->_bus = bus;
+  return _start(sensorID);
+}
+
+/*!
+ *    @brief  Destroys the running driver and closes its bus device, so the
+ *            storage can be used by the next begin
+ */
+void Adafruit_LSM6DS_AutoDetect::end(void) {
+  if (_driver) {
+    _driver->~Adafruit_LSM6DS();
+    _driver = NULL;
+  }
+  _variant = LSM6DS_VARIANT_NONE;
+}
+
+/*!
+ *    @brief  Gets a printable name for a variant
+ *    @param  variant The variant, eg. from variant()
+ *    @returns The chip's part number
+ */
+const char *Adafruit_LSM6DS_AutoDetect::variantName(lsm6ds_variant_t variant) {
+  switch (variant) {
+  case LSM6DS_VARIANT_LSM6DS3:
+    return "LSM6DS3";
+  case LSM6DS_VARIANT_LSM6DS33:
+    return "LSM6DS33";
+  case LSM6DS_VARIANT_LSM6DS3TRC:
+    return "LSM6DS3TR-C";
+  case LSM6DS_VARIANT_LSM6DSL:
+    return "LSM6DSL";
+  case LSM6DS_VARIANT_LSM6DSOX:
+    return "LSM6DSOX";
+  case LSM6DS_VARIANT_LSM6DSO32:
+    return "LSM6DSO32";
+  case LSM6DS_VARIANT_ISM330DHCX:
+    return "ISM330DHCX";
+  default:
+    return "none";
+  }
+}
+
+/*!
+ *    @brief  Finds the driver class for a WHOAMI value
+ *    @param  chip_id The WHOAMI value read from the chip
+ *    @returns The preferred variant with that ID, else the first one, or
+ *    LSM6DS_VARIANT_NONE for an unknown ID
+ */
+lsm6ds_variant_t Adafruit_LSM6DS_AutoDetect::_select(uint8_t chip_id) {
+  lsm6ds_variant_t found = LSM6DS_VARIANT_NONE;
+  for (uint8_t i = 0; i < sizeof(lsm6ds_variants) / sizeof(lsm6ds_variants[0]);
+       i++) {
+    if (lsm6ds_variants[i].chip_id != chip_id) {
+      continue;
+    }
+    lsm6ds_variant_t variant = lsm6ds_variants[i].variant;
+    if (_preferred & (1 << variant)) {
+      return variant;
+    }
+    if (found == LSM6DS_VARIANT_NONE) {
+      found = variant;
+    }
+  }
+  return found;
+}
+
+/*!
+ *    @brief  Builds a driver object in the factory's storage
+ *    @param  variant The driver class to build
+ *    @returns The new driver, or NULL for LSM6DS_VARIANT_NONE
+ */
+Adafruit_LSM6DS *Adafruit_LSM6DS_AutoDetect::_construct(
+    lsm6ds_variant_t variant) {
+  void *storage = &_storage;
+  lsm6ds_placement_t placement;
+
+  switch (variant) {
+  case LSM6DS_VARIANT_LSM6DS3:
+    _driver = new (storage, placement) Adafruit_LSM6DS3();
+    break;
+  case LSM6DS_VARIANT_LSM6DS33:
+    _driver = new (storage, placement) Adafruit_LSM6DS33();
+    break;
+  case LSM6DS_VARIANT_LSM6DS3TRC:
+    _driver = new (storage, placement) Adafruit_LSM6DS3TRC();
+    break;
+  case LSM6DS_VARIANT_LSM6DSL:
+    _driver = new (storage, placement) Adafruit_LSM6DSL();
+    break;
+  case LSM6DS_VARIANT_LSM6DSOX:
+    _driver = new (storage, placement) Adafruit_LSM6DSOX();
+    break;
+  case LSM6DS_VARIANT_LSM6DSO32:
+    _driver = new (storage, placement) Adafruit_LSM6DSO32();
+    break;
+  case LSM6DS_VARIANT_ISM330DHCX:
+    _driver = new (storage, placement) Adafruit_ISM330DHCX();
+    break;
+  default:
+    return NULL;
+  }
+  _variant = variant;
+  return _driver;
+}
+
+/*!
+ *    @brief  Runs the driver's chip setup on the bus device it was given
+ *    @param  sensor_id The user-defined ID to differentiate different sensors
+ *    @returns The running driver, or NULL if setup failed
+ */
+Adafruit_LSM6DS *Adafruit_LSM6DS_AutoDetect::_start(int32_t sensor_id) {
+  if (!_driver->_begun(_driver->_init(sensor_id))) {
+    end();
+    return NULL;
+  }
+  return _driver;
+}
@@ -0,0 +1,99 @@
+/*!
+ *  @file Adafruit_LSM6DS_AutoDetect.h
+ *
+ * 	Single-probe factory that starts whichever LSM6DS family chip is
+ *      connected
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_AUTODETECT_H
+#define _ADAFRUIT_LSM6DS_AUTODETECT_H
+
+#include "Adafruit_ISM330DHCX.h"
+#include "Adafruit_LSM6DS.h"
+#include "Adafruit_LSM6DS3.h"
+#include "Adafruit_LSM6DS33.h"
+#include "Adafruit_LSM6DS3TRC.h"
+#include "Adafruit_LSM6DSL.h"
+#include "Adafruit_LSM6DSO32.h"
+#include "Adafruit_LSM6DSOX.h"
+
+/** The driver classes the factory can select */
+typedef enum lsm6ds_variant {
+  LSM6DS_VARIANT_NONE,
+  LSM6DS_VARIANT_LSM6DS3,
+  LSM6DS_VARIANT_LSM6DS33,
+  LSM6DS_VARIANT_LSM6DS3TRC,
+  LSM6DS_VARIANT_LSM6DSL,
+  LSM6DS_VARIANT_LSM6DSOX,
+  LSM6DS_VARIANT_LSM6DSO32,
+  LSM6DS_VARIANT_ISM330DHCX,
+} lsm6ds_variant_t;
+
+/*!
+ *    @brief  Reads WHOAMI once and starts the matching driver in storage
+ *            held by this object, so a global instance needs no heap for the
+ *            driver. The bus device opened for the probe is handed to the
+ *            driver instead of being opened again.
+ *
+ *            Some chips share an ID: the LSM6DS33 and LSM6DS3 (0x69), the
+ *            LSM6DS3TR-C and LSM6DSL (0x6A) and the LSM6DSOX and LSM6DSO32
+ *            (0x6C). The first of each pair is used unless prefer() picks
+ *            the other one.
+ */
+class Adafruit_LSM6DS_AutoDetect {
+public:
+  Adafruit_LSM6DS_AutoDetect(void);
+  ~Adafruit_LSM6DS_AutoDetect(void);
+
+  void prefer(lsm6ds_variant_t variant);
+
+  Adafruit_LSM6DS *begin_I2C(uint8_t i2c_addr = LSM6DS_I2CADDR_DEFAULT,
+                             TwoWire *wire = &Wire, int32_t sensorID = 0);
+  Adafruit_LSM6DS *begin_SPI(uint8_t cs_pin, SPIClass *theSPI = &SPI,
+                             int32_t sensorID = 0,
+                             uint32_t frequency = 1000000);
+  Adafruit_LSM6DS *begin_Bus(Adafruit_LSM6DS_Bus *bus, int32_t sensorID = 0);
+  void end(void);
+
+  /*!  @brief  Gets the running driver
+   *   @returns The driver started by the last begin, or NULL */
+  Adafruit_LSM6DS *driver(void) { return _driver; }
+  /*!  @brief  Gets the class of the running driver, to cast driver() to
+   *   @returns The selected variant, or LSM6DS_VARIANT_NONE */
+  lsm6ds_variant_t variant(void) { return _variant; }
+
+  static const char *variantName(lsm6ds_variant_t variant);
+
+private:
+  lsm6ds_variant_t _select(uint8_t chip_id);
+  Adafruit_LSM6DS *_construct(lsm6ds_variant_t variant);
+  Adafruit_LSM6DS *_start(int32_t sensor_id);
+
+  /** Room for any one of the driver classes */
+  typedef union {
+    uint8_t lsm6ds3[sizeof(Adafruit_LSM6DS3)];       ///< LSM6DS3 driver
+    uint8_t lsm6ds33[sizeof(Adafruit_LSM6DS33)];     ///< LSM6DS33 driver
+    uint8_t lsm6ds3trc[sizeof(Adafruit_LSM6DS3TRC)]; ///< LSM6DS3TR-C driver
+    uint8_t lsm6dsl[sizeof(Adafruit_LSM6DSL)];       ///< LSM6DSL driver
+    uint8_t lsm6dsox[sizeof(Adafruit_LSM6DSOX)];     ///< LSM6DSOX driver
+    uint8_t lsm6dso32[sizeof(Adafruit_LSM6DSO32)];   ///< LSM6DSO32 driver
+    uint8_t ism330dhcx[sizeof(Adafruit_ISM330DHCX)]; ///< ISM330DHCX driver
+    void *align_pointer;                             ///< Pointer alignment
+    double align_double;                             ///< Float alignment
+    uint64_t align_long;                             ///< Integer alignment
+  } lsm6ds_driver_storage_t;
+
+  lsm6ds_driver_storage_t _storage; ///< Driver object memory
+  Adafruit_LSM6DS *_driver = NULL;   ///< Driver living in `_storage`
+  //! class of `_driver`
+  lsm6ds_variant_t _variant = LSM6DS_VARIANT_NONE;
+  uint8_t _preferred = 0; ///< Bit N set if variant N was passed to prefer()
+};
+
+#endif
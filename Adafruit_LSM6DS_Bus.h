@@ -0,0 +1,66 @@
+/*!
+ *  @file Adafruit_LSM6DS_Bus.h
+ *
+ * 	Register bus backends for LSM6DS sensors on hosts without Adafruit BusIO
+ *      devices
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_BUS_H
+#define _ADAFRUIT_LSM6DS_BUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ *    @brief  Moves runs of consecutive registers to and from the sensor.
+ *            Pass one to Adafruit_LSM6DS::begin_Bus() to use it in place of
+ *            an Arduino I2C or SPI device.
+ */
+class Adafruit_LSM6DS_Bus {
+public:
+  virtual ~Adafruit_LSM6DS_Bus() {}
+
+  /*!  @brief  Opens the bus, or reopens it after end()
+   *   @returns True if the bus is ready */
+  virtual bool begin(void) = 0;
+  /*!  @brief  Releases the bus */
+  virtual void end(void) {}
+
+  /*!  @brief  Reads registers with one auto-incrementing transfer
+   *   @param  reg The first register address
+   *   @param  buffer Buffer to hold the register values
+   *   @param  len The number of registers to read
+   *   @returns True if the transfer succeeded */
+  virtual bool read(uint8_t reg, uint8_t *buffer, size_t len) = 0;
+  /*!  @brief  Writes registers with one auto-incrementing transfer
+   *   @param  reg The first register address
+   *   @param  buffer The register values to write
+   *   @param  len The number of registers to write
+   *   @returns True if the transfer succeeded */
+  virtual bool write(uint8_t reg, const uint8_t *buffer, size_t len) = 0;
+};
+
+/*!
+ *    @brief  In-memory register file standing in for a sensor, for running
+ *            the driver without hardware
+ */
+class Adafruit_LSM6DS_FakeBus : public Adafruit_LSM6DS_Bus {
+public:
+  Adafruit_LSM6DS_FakeBus(uint8_t chip_id = 0);
+
+  bool begin(void);
+  bool read(uint8_t reg, uint8_t *buffer, size_t len);
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len);
+
+  uint8_t regs[256];  ///< Register contents, indexed by address
+  uint32_t transfers; ///< Transfers attempted, including failed ones
+  uint32_t fail_next; ///< Number of upcoming transfers to fail
+};
+
+#endif
@@ -0,0 +1,272 @@
+/*!
+ *  @file Adafruit_LSM6DS_Capture.cpp
+ *  Pre/post-trigger capture buffer of raw LSM6DS samples around motion
+ *  events
+ *
+ *  Samples go into a ring that overwrites its oldest entries while armed.
+ *  A trigger only records when it happened: samples stamped from then on
+ *  count toward the post-trigger window, and once that is full recording
+ *  stops with the pre-trigger samples still in the ring just before them.
+ *
+ *  FIFO samples are decoded before their times are known, so they can be
+ *  staged in the slots after the head and stamped later, in order. Samples
+ *  dropped while stamping leave a gap that later ones are moved down over.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Capture.h"
+
+/*!
+ *    @brief  Instantiates a capture. Call begin() to give it a buffer.
+ */
+Adafruit_LSM6DS_Capture::Adafruit_LSM6DS_Capture(void) {}
+
+/**************************************************************************/
+/*!
+    @brief Sets the buffer and window sizes and arms the capture
+    @param buffer Array of `size` samples to record into
+    @param size The number of samples `buffer` holds, at least `pre +
+    post`. Any extra room keeps pre-trigger samples that are still in the
+    FIFO when the trigger fires from being overwritten.
+    @param pre The samples to keep from before the trigger
+    @param post The samples to record from the trigger on
+    @returns False if the buffer is missing or too small
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Capture::begin(lsm6ds_capture_sample_t *buffer,
+                                    uint16_t size, uint16_t pre,
+                                    uint16_t post) {
+  if (!buffer || !size || ((uint32_t)pre + post > size)) {
+    return false;
+  }
+  _buffer = buffer;
+  _size = size;
+  _pre = pre;
+  _post = post;
+  rearm();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Drops the recorded samples and starts recording for the next
+    trigger
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::rearm(void) {
+  if (!_buffer) {
+    return;
+  }
+  _head = 0;
+  _count = 0;
+  _after = 0;
+  _captured = 0;
+  _trigger_index = 0;
+  _staged = 0;
+  _gap = 0;
+  _cause = 0;
+  _state = LSM6DS_CAPTURE_ARMED;
+}
+
+/**************************************************************************/
+/*!
+    @brief Records one sample, unless a capture is already complete
+    @param xyz The raw X, Y and Z sample
+    @param timestamp millis() when it was taken, eg. from an event
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::record(const int16_t *xyz, int32_t timestamp) {
+  if ((_state != LSM6DS_CAPTURE_ARMED) &&
+      (_state != LSM6DS_CAPTURE_TRIGGERED)) {
+    return;
+  }
+  memcpy(_buffer[_head].data, xyz, sizeof(_buffer[_head].data));
+  _store(timestamp);
+}
+
+/**************************************************************************/
+/*!
+    @brief Holds a sample whose time isn't known yet, eg. one just decoded
+    from the FIFO, until stamp() gives it one. Staged samples take the
+    ring's oldest slots, so leave room beyond `pre + post` for a FIFO
+    drain. At most the ring's size can wait at once.
+    @param xyz The raw X, Y and Z sample
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::stage(const int16_t *xyz) {
+  if (((_state != LSM6DS_CAPTURE_ARMED) &&
+       (_state != LSM6DS_CAPTURE_TRIGGERED)) ||
+      (_gap + _staged >= _size)) {
+    return;
+  }
+  uint16_t slot = ((uint32_t)_head + _gap + _staged) % _size;
+  memcpy(_buffer[slot].data, xyz, sizeof(_buffer[slot].data));
+  _staged++;
+}
+
+/**************************************************************************/
+/*!
+    @brief Records the oldest staged sample now that its time is known
+    @param timestamp millis() when it was taken
+    @param keep False to drop it instead, eg. while the sensor settles
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::stamp(int32_t timestamp, bool keep) {
+  if (!_staged) {
+    return;
+  }
+  _staged--;
+  if (!keep) {
+    _gap++;
+  } else if ((_state == LSM6DS_CAPTURE_ARMED) ||
+             (_state == LSM6DS_CAPTURE_TRIGGERED)) {
+    if (_gap) {
+      uint16_t slot = ((uint32_t)_head + _gap) % _size;
+      memcpy(_buffer[_head].data, _buffer[slot].data,
+             sizeof(_buffer[_head].data));
+    }
+    _store(timestamp);
+  }
+  if (!_staged) {
+    _gap = 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Triggers an armed capture now. Ignored while triggered or done.
+    @param cause Any value to tell triggers apart, eg. lsm6ds_event_t flags
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::trigger(uint8_t cause) {
+  trigger(cause, millis());
+}
+
+/**************************************************************************/
+/*!
+    @brief Triggers an armed capture at a given time. Ignored while
+    triggered or done.
+    @param cause Any value to tell triggers apart, eg. lsm6ds_event_t flags
+    @param timestamp millis() of the trigger. Samples stamped before it are
+    pre-trigger samples.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::trigger(uint8_t cause, int32_t timestamp) {
+  if (_state != LSM6DS_CAPTURE_ARMED) {
+    return;
+  }
+  _cause = cause;
+  _trigger_ms = timestamp;
+  _state = LSM6DS_CAPTURE_TRIGGERED;
+
+  // samples already recorded from the trigger time on are post-trigger
+  _after = 0;
+  while (_after < _count) {
+    uint16_t slot = ((uint32_t)_head + _size - 1 - _after) % _size;
+    if (_buffer[slot].timestamp - timestamp < 0) {
+      break;
+    }
+    _after++;
+  }
+  if (_after >= _post) {
+    // the window ends `_post` samples after the trigger, not at the newest
+    uint16_t newer = _after - _post;
+    _after = _post;
+    _freeze(newer);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets where the capture is in its cycle
+    @returns LSM6DS_CAPTURE_DONE once the samples can be read
+*/
+/**************************************************************************/
+lsm6ds_capture_state_t Adafruit_LSM6DS_Capture::state(void) { return _state; }
+
+/**************************************************************************/
+/*!
+    @brief Gets the number of samples in a completed capture
+    @returns The number of samples, 0 until the capture is done. Fewer than
+    `pre + post` if the trigger came before `pre` samples were recorded.
+*/
+/**************************************************************************/
+uint16_t Adafruit_LSM6DS_Capture::count(void) { return _captured; }
+
+/**************************************************************************/
+/*!
+    @brief Gets one sample of a completed capture
+    @param index The sample, 0 for the oldest, up to count() - 1
+    @returns Pointer to the sample, or NULL if `index` is out of range
+*/
+/**************************************************************************/
+const lsm6ds_capture_sample_t *
+Adafruit_LSM6DS_Capture::sample(uint16_t index) {
+  if (index >= _captured) {
+    return NULL;
+  }
+  return &_buffer[((uint32_t)_first + index) % _size];
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the index of the first sample taken at or after the trigger
+    @returns The number of pre-trigger samples in the capture
+*/
+/**************************************************************************/
+uint16_t Adafruit_LSM6DS_Capture::triggerIndex(void) { return _trigger_index; }
+
+/**************************************************************************/
+/*!
+    @brief Gets when the capture was triggered
+    @returns The trigger's millis() timestamp
+*/
+/**************************************************************************/
+int32_t Adafruit_LSM6DS_Capture::triggerTime(void) { return _trigger_ms; }
+
+/**************************************************************************/
+/*!
+    @brief Gets the cause passed to trigger()
+    @returns The cause, eg. lsm6ds_event_t flags when the driver triggered
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS_Capture::cause(void) { return _cause; }
+
+/**************************************************************************/
+/*!
+    @brief Stops recording and marks out the captured samples: `_after`
+    post-trigger samples and up to `_pre` samples right before them
+    @param newer Recorded samples newer than the last one captured
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::_freeze(uint16_t newer) {
+  uint16_t pre = _count - newer - _after;
+  if (pre > _pre) {
+    pre = _pre;
+  }
+  _trigger_index = pre;
+  _captured = pre + _after;
+  _first = ((uint32_t)_head + _size - newer - _captured) % _size;
+  _state = LSM6DS_CAPTURE_DONE;
+}
+
+/**************************************************************************/
+/*!
+    @brief Timestamps the sample at the head and moves past it, ending the
+    capture once the post-trigger window is full
+    @param timestamp millis() when the sample was taken
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Capture::_store(int32_t timestamp) {
+  _buffer[_head].timestamp = timestamp;
+  _head = (_head + 1) % _size;
+  if (_count < _size) {
+    _count++;
+  }
+
+  if ((_state == LSM6DS_CAPTURE_TRIGGERED) &&
+      (timestamp - _trigger_ms >= 0) && (++_after >= _post)) {
+    _freeze(0);
+  }
+}
@@ -0,0 +1,85 @@
+/*!
+ *  @file Adafruit_LSM6DS_Capture.h
+ *
+ * 	Pre/post-trigger capture buffer of raw LSM6DS samples around motion
+ *      events
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_CAPTURE_H
+#define _ADAFRUIT_LSM6DS_CAPTURE_H
+
+#include "Arduino.h"
+
+/** One recorded raw sample */
+typedef struct {
+  int32_t timestamp; ///< millis() when the sample was taken
+  int16_t data[3];   ///< Raw X, Y and Z
+} lsm6ds_capture_sample_t;
+
+/** Where a capture is in its cycle */
+typedef enum capture_state {
+  LSM6DS_CAPTURE_IDLE,      ///< No buffer set, see begin()
+  LSM6DS_CAPTURE_ARMED,     ///< Recording, waiting for a trigger
+  LSM6DS_CAPTURE_TRIGGERED, ///< Recording the samples after the trigger
+  LSM6DS_CAPTURE_DONE,      ///< Frozen, ready to read until rearm()
+} lsm6ds_capture_state_t;
+
+/*!
+ *    @brief  Records raw samples into a ring continuously and, once
+ *            triggered, keeps the samples from just before the trigger and
+ *            a set number after it. Samples are split by timestamp, so
+ *            FIFO samples drained after the trigger still land on the
+ *            right side of it. The buffer is the caller's, sized for the
+ *            pre and post windows plus any FIFO backlog.
+ */
+class Adafruit_LSM6DS_Capture {
+public:
+  Adafruit_LSM6DS_Capture(void);
+
+  bool begin(lsm6ds_capture_sample_t *buffer, uint16_t size, uint16_t pre,
+             uint16_t post);
+  void rearm(void);
+
+  void record(const int16_t *xyz, int32_t timestamp);
+  void stage(const int16_t *xyz);
+  void stamp(int32_t timestamp, bool keep = true);
+  void trigger(uint8_t cause);
+  void trigger(uint8_t cause, int32_t timestamp);
+
+  lsm6ds_capture_state_t state(void);
+  uint16_t count(void);
+  const lsm6ds_capture_sample_t *sample(uint16_t index);
+  uint16_t triggerIndex(void);
+  int32_t triggerTime(void);
+  uint8_t cause(void);
+
+private:
+  void _freeze(uint16_t newer);
+  void _store(int32_t timestamp);
+
+  //! the caller's ring of samples
+  lsm6ds_capture_sample_t *_buffer = NULL;
+  uint16_t _size = 0;          ///< Slots in `_buffer`
+  uint16_t _pre = 0;           ///< Samples to keep from before a trigger
+  uint16_t _post = 0;          ///< Samples to record after a trigger
+  uint16_t _head = 0;          ///< Next slot to write
+  uint16_t _count = 0;         ///< Slots holding samples
+  uint16_t _after = 0;         ///< Samples recorded since the trigger
+  uint16_t _first = 0;         ///< Slot of the oldest frozen sample
+  uint16_t _captured = 0;      ///< Frozen samples
+  uint16_t _trigger_index = 0; ///< Frozen samples before the trigger
+  uint16_t _staged = 0;        ///< Staged samples waiting for stamp()
+  uint16_t _gap = 0;           ///< Staged samples stamp() has dropped
+  int32_t _trigger_ms = 0;     ///< Timestamp of the trigger
+  uint8_t _cause = 0;          ///< Value passed to trigger()
+  //! where the capture is in its cycle
+  lsm6ds_capture_state_t _state = LSM6DS_CAPTURE_IDLE;
+};
+
+#endif
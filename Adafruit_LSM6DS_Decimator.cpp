@@ -0,0 +1,331 @@
+
+/*!
+ *  @file Adafruit_LSM6DS_Decimator.cpp
+ *  Multi-rate CIC decimation filter bank for LSM6DS raw sample streams
+ *
+ *  A CIC (cascaded integrator-comb) filter needs only integer adds per input
+ *  sample, with a single divide per output sample to remove the filter
+ *  gain, so it runs at full ODR on FPU-less MCUs. The integrators are
+ *  allowed to wrap: with modulo 2^32 arithmetic the combs recover the exact
+ *  result as long as the output itself fits, which LSM6DS_CIC_MAX_RATIO
+ *  guarantees.
+ *
+ *  The three axes are independent, so where the bulk decode kernels have
+ *  SIMD paths the integrators and combs of all three run as one vector
+ *  add or subtract per stage, with a spare fourth lane.
+ *
+ *  The droop compensator is the 3-tap FIR [-1, 10, -1] / 8 at the output
+ *  rate. Its gain 1 + (1 - cos w) / 4 cancels the (w^2 / 2) fall-off of
+ *  the 3-stage CIC's sinc^3 response to second order.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Decimator.h"
+
+#if defined(LSM6DS_DECODE_X86)
+#include <immintrin.h>
+#elif defined(LSM6DS_DECODE_NEON)
+#include <arm_neon.h>
+#endif
+
+/*!
+ *    @brief  Instantiates an empty filter bank
+ */
+Adafruit_LSM6DS_Decimator::Adafruit_LSM6DS_Decimator(void) {}
+
+/**************************************************************************/
+/*!
+    @brief Adds a decimated output stream to the bank
+    @param ratio The number of source samples per output sample, from 1 to
+    LSM6DS_CIC_MAX_RATIO
+    @param source The stream to decimate further, or -1 to decimate the
+    input samples directly. Must be a stream that was added earlier.
+    @returns The new stream's index, or -1 if the ratio or source is invalid
+    or the bank is full
+*/
+/**************************************************************************/
+int8_t Adafruit_LSM6DS_Decimator::addStream(uint8_t ratio, int8_t source) {
+  if ((ratio == 0) || (ratio > LSM6DS_CIC_MAX_RATIO) ||
+      (_num_streams >= LSM6DS_DECIMATOR_MAX_STREAMS) ||
+      (source >= (int8_t)_num_streams) || (source < -1)) {
+    return -1;
+  }
+
+  lsm6ds_cic_t *cic = &_streams[_num_streams];
+  memset(cic, 0, sizeof(lsm6ds_cic_t));
+  cic->ratio = ratio;
+  cic->source = source;
+  cic->gain = 1;
+  for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+    cic->gain *= ratio;
+  }
+
+  return _num_streams++;
+}
+
+/**************************************************************************/
+/*!
+    @brief Turns the passband droop compensator of a stream on or off
+    @param stream The stream index returned by addStream()
+    @param enable True to flatten the passband, delaying the stream's
+    output by one sample. Streams chained to it decimate the compensated
+    output.
+    @returns False if the stream doesn't exist
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Decimator::setCompensation(uint8_t stream, bool enable) {
+  if (stream >= _num_streams) {
+    return false;
+  }
+  _streams[stream].compensate = enable;
+  memset(_streams[stream].history, 0, sizeof(_streams[stream].history));
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Clears the filter history of every stream, keeping the streams
+    themselves. Call after a data rate change or a gap in the input.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Decimator::reset(void) {
+  for (uint8_t s = 0; s < _num_streams; s++) {
+    lsm6ds_cic_t *cic = &_streams[s];
+    memset(cic->integrator, 0, sizeof(cic->integrator));
+    memset(cic->comb, 0, sizeof(cic->comb));
+    memset(cic->history, 0, sizeof(cic->history));
+    cic->count = 0;
+    cic->ready = false;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets a function to be called with every decimated sample
+    @param callback The function to call, or NULL to only use read()
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Decimator::setCallback(
+    lsm6ds_decimator_callback_t callback) {
+  _callback = callback;
+}
+
+/**************************************************************************/
+/*!
+    @brief Runs one sample through a single CIC filter
+    @param cic The filter state
+    @param xyz The raw X, Y and Z sample
+    @returns True if the filter produced an output sample
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Decimator::_filter(lsm6ds_cic_t *cic,
+                                        const int16_t *xyz) {
+#if defined(LSM6DS_DECODE_X86)
+  __m128i acc = _mm_setr_epi32(xyz[0], xyz[1], xyz[2], 0);
+  for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+    __m128i *sum = (__m128i *)cic->integrator[i];
+    acc = _mm_add_epi32(_mm_loadu_si128(sum), acc);
+    _mm_storeu_si128(sum, acc);
+  }
+#elif defined(LSM6DS_DECODE_NEON)
+  int32x4_t in = {xyz[0], xyz[1], xyz[2], 0};
+  uint32x4_t acc = vreinterpretq_u32_s32(in);
+  for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+    acc = vaddq_u32(vld1q_u32(cic->integrator[i]), acc);
+    vst1q_u32(cic->integrator[i], acc);
+  }
+#else
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    uint32_t acc = (uint32_t)(int32_t)xyz[axis];
+    for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+      cic->integrator[i][axis] += acc;
+      acc = cic->integrator[i][axis];
+    }
+  }
+#endif
+
+  if (++cic->count < cic->ratio) {
+    return false;
+  }
+  cic->count = 0;
+
+  const uint32_t *last = cic->integrator[LSM6DS_CIC_STAGES - 1];
+  uint32_t diff[LSM6DS_CIC_LANES];
+#if defined(LSM6DS_DECODE_X86)
+  acc = _mm_loadu_si128((const __m128i *)last);
+  for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+    __m128i *comb = (__m128i *)cic->comb[i];
+    __m128i prev = _mm_loadu_si128(comb);
+    _mm_storeu_si128(comb, acc);
+    acc = _mm_sub_epi32(acc, prev);
+  }
+  _mm_storeu_si128((__m128i *)diff, acc);
+#elif defined(LSM6DS_DECODE_NEON)
+  acc = vld1q_u32(last);
+  for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+    uint32x4_t prev = vld1q_u32(cic->comb[i]);
+    vst1q_u32(cic->comb[i], acc);
+    acc = vsubq_u32(acc, prev);
+  }
+  vst1q_u32(diff, acc);
+#else
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    uint32_t acc = last[axis];
+    for (uint8_t i = 0; i < LSM6DS_CIC_STAGES; i++) {
+      uint32_t prev = cic->comb[i][axis];
+      cic->comb[i][axis] = acc;
+      acc -= prev;
+    }
+    diff[axis] = acc;
+  }
+#endif
+
+  // remove the DC gain, rounding to nearest
+  int32_t half = cic->gain / 2;
+  int32_t out[3];
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int32_t sum = (int32_t)diff[axis];
+    out[axis] =
+        (sum >= 0) ? (sum + half) / cic->gain : (sum - half) / cic->gain;
+  }
+  if (cic->compensate) {
+    _compensate(cic, out);
+  } else {
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      cic->output[axis] = out[axis];
+    }
+  }
+  cic->ready = true;
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Runs a new CIC output through the droop compensator
+    @param cic The filter state, whose `output` gets the result
+    @param xyz The CIC's X, Y and Z output, already divided by its gain
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Decimator::_compensate(lsm6ds_cic_t *cic,
+                                            const int32_t *xyz) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int32_t sum = 10 * (int32_t)cic->history[0][axis] - xyz[axis] -
+                  cic->history[1][axis];
+    int32_t out = (sum >= 0) ? (sum + 4) / 8 : (sum - 4) / 8;
+    // the FIR overshoots on full-scale steps
+    if (out > INT16_MAX) {
+      out = INT16_MAX;
+    } else if (out < INT16_MIN) {
+      out = INT16_MIN;
+    }
+    cic->output[axis] = out;
+    cic->history[1][axis] = cic->history[0][axis];
+    cic->history[0][axis] = xyz[axis];
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Feeds one input sample to every stream
+    @param xyz The raw X, Y and Z sample, as in `rawAccX..rawAccZ` or
+    `rawGyroX..rawGyroZ`
+    @returns A bitmask with bit N set if stream N produced a new sample
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS_Decimator::push(const int16_t *xyz) {
+  uint8_t produced = 0;
+
+  // sources always have a lower index, so one pass settles every chain
+  for (uint8_t s = 0; s < _num_streams; s++) {
+    lsm6ds_cic_t *cic = &_streams[s];
+    const int16_t *in = xyz;
+    if (cic->source >= 0) {
+      if (!(produced & (1 << cic->source))) {
+        continue;
+      }
+      in = _streams[cic->source].output;
+    }
+    if (_filter(cic, in)) {
+      produced |= 1 << s;
+      if (_callback) {
+        _callback(s, cic->output);
+      }
+    }
+  }
+
+  return produced;
+}
+
+/**************************************************************************/
+/*!
+    @brief Feeds a block of input samples to every stream, for example a
+    drained batch of samples
+    @param samples Packed X, Y, Z raw samples, `count * 3` values
+    @param count The number of XYZ samples
+    @returns A bitmask with bit N set if stream N produced any new sample.
+    Use setCallback() to receive every output of a block.
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS_Decimator::process(const int16_t *samples,
+                                           size_t count) {
+  uint8_t produced = 0;
+  for (size_t i = 0; i < count; i++) {
+    produced |= push(samples + i * 3);
+  }
+  return produced;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the latest decimated sample of a stream
+    @param stream The stream index returned by addStream()
+    @param xyz Array of three to hold the X, Y and Z values
+    @returns True if this sample had not been read before
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Decimator::read(uint8_t stream, int16_t *xyz) {
+  if (stream >= _num_streams) {
+    return false;
+  }
+  lsm6ds_cic_t *cic = &_streams[stream];
+  memcpy(xyz, cic->output, sizeof(cic->output));
+  bool fresh = cic->ready;
+  cic->ready = false;
+  return fresh;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the overall ratio of a stream relative to the input,
+    including any streams it is chained to
+    @param stream The stream index returned by addStream()
+    @returns The number of input samples per output sample
+*/
+/**************************************************************************/
+uint32_t Adafruit_LSM6DS_Decimator::totalRatio(uint8_t stream) {
+  if (stream >= _num_streams) {
+    return 0;
+  }
+  uint32_t ratio = 1; // 40^6 still fits, past the default stream count
+  for (int8_t s = stream; s >= 0; s = _streams[s].source) {
+    ratio *= _streams[s].ratio;
+  }
+  return ratio;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the sample rate of a stream
+    @param stream The stream index returned by addStream()
+    @param input_rate The input sample rate in Hz, eg. from
+    accelerationSampleRate()
+    @returns The output sample rate in Hz
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS_Decimator::outputRate(uint8_t stream,
+                                            float input_rate) {
+  uint32_t ratio = totalRatio(stream);
+  return ratio ? input_rate / ratio : 0;
+}
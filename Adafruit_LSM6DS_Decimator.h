@@ -0,0 +1,90 @@
+/*!
+ *  @file Adafruit_LSM6DS_Decimator.h
+ *
+ * 	Multi-rate CIC decimation filter bank for LSM6DS raw sample streams
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_DECIMATOR_H
+#define _ADAFRUIT_LSM6DS_DECIMATOR_H
+
+#include "Adafruit_LSM6DS_Decode.h"
+#include "Arduino.h"
+
+#ifndef LSM6DS_DECIMATOR_MAX_STREAMS
+#define LSM6DS_DECIMATOR_MAX_STREAMS 4 ///< Output streams per filter bank
+#endif
+
+#define LSM6DS_CIC_STAGES 3 ///< Integrator/comb pairs in each CIC filter
+#define LSM6DS_CIC_MAX_RATIO                                                   \
+  40 ///< Largest ratio whose gain (ratio^3 * 2^15) fits in 32 bits
+#if defined(LSM6DS_DECODE_X86) || defined(LSM6DS_DECODE_NEON)
+#define LSM6DS_CIC_LANES 4 ///< XYZ plus a pad lane, one SIMD vector per stage
+#else
+#define LSM6DS_CIC_LANES 3 ///< XYZ, updated one axis at a time
+#endif
+
+/** Called for each decimated sample a stream produces */
+typedef void (*lsm6ds_decimator_callback_t)(uint8_t stream,
+                                            const int16_t *xyz);
+
+/*!
+ *    @brief  Bank of fixed-point CIC decimators that turns one high-rate
+ *            stream of raw XYZ samples into several lower rate streams at
+ *            once. Outputs keep the LSB scaling of the input so the usual
+ *            range scale factors still apply. Streams can be chained to
+ *            reach ratios above LSM6DS_CIC_MAX_RATIO, eg. 6.66 kHz -> 104 Hz
+ *            as 8 x 8.
+ *
+ *            A 3-stage CIC droops across its passband: about -0.4 dB at a
+ *            tenth of the output rate and -2.7 dB at a quarter of it. Turn
+ *            on setCompensation() for a stream to flatten that to about
+ *            0 and -0.8 dB, at the cost of one output sample of delay.
+ */
+class Adafruit_LSM6DS_Decimator {
+public:
+  Adafruit_LSM6DS_Decimator(void);
+
+  int8_t addStream(uint8_t ratio, int8_t source = -1);
+  bool setCompensation(uint8_t stream, bool enable);
+  void reset(void);
+  void setCallback(lsm6ds_decimator_callback_t callback);
+
+  uint8_t push(const int16_t *xyz);
+  uint8_t process(const int16_t *samples, size_t count);
+  bool read(uint8_t stream, int16_t *xyz);
+
+  uint32_t totalRatio(uint8_t stream);
+  float outputRate(uint8_t stream, float input_rate);
+
+private:
+  /** State for a single decimating output stream */
+  typedef struct {
+    //! running sums, mod 2^32
+    uint32_t integrator[LSM6DS_CIC_STAGES][LSM6DS_CIC_LANES];
+    //! previous comb inputs
+    uint32_t comb[LSM6DS_CIC_STAGES][LSM6DS_CIC_LANES];
+    int32_t gain;          ///< ratio^LSM6DS_CIC_STAGES, the filter's DC gain
+    uint8_t ratio;         ///< Input samples per output sample
+    uint8_t count;         ///< Input samples since the last output
+    int8_t source;         ///< Stream this one decimates, -1 for the input
+    bool ready;            ///< True if `output` has not been read yet
+    bool compensate;       ///< Run outputs through the droop compensator
+    int16_t history[2][3]; ///< Last two outputs before compensation
+    int16_t output[3];     ///< Latest decimated sample
+  } lsm6ds_cic_t;
+
+  bool _filter(lsm6ds_cic_t *cic, const int16_t *xyz);
+  void _compensate(lsm6ds_cic_t *cic, const int32_t *xyz);
+
+  lsm6ds_cic_t _streams[LSM6DS_DECIMATOR_MAX_STREAMS]; ///< Stream states
+  uint8_t _num_streams = 0;                             ///< Streams in use
+  lsm6ds_decimator_callback_t _callback = NULL;         ///< Output callback
+};
+
+#endif
@@ -0,0 +1,152 @@
+
+/*!
+ *  @file Adafruit_LSM6DS_Decode.cpp
+ *  Bulk raw-to-engineering-units decode kernels for LSM6DS sample data
+ *
+ *  The data registers and FIFO hold packed little-endian int16 values, X, Y
+ *  and Z for each sensor. These kernels convert runs of them in one pass,
+ *  with SSE2/AVX2 or NEON paths where the compiler targets them and an
+ *  unrolled portable loop everywhere else. Every path computes
+ *  `(float)raw * scale` with a single rounding, the same expression the
+ *  driver's decodeReading() uses, so results are bit-identical across
+ *  paths. extras/host/test_decode.cpp checks each path against it.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Decode.h"
+
+#if defined(LSM6DS_DECODE_X86)
+#include <immintrin.h>
+#elif defined(LSM6DS_DECODE_NEON)
+#include <arm_neon.h>
+#endif
+
+/**************************************************************************/
+/*!
+    @brief Unpacks little-endian 16-bit samples
+    @param src Packed little-endian sample bytes, `count * 2` bytes
+    @param dst Array of `count` to hold the samples
+    @param count The number of 16-bit values, three per XYZ sample
+*/
+/**************************************************************************/
+void lsm6ds_decode_raw(const uint8_t *src, int16_t *dst, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    dst[i] = lsm6ds_raw(src + i * 2);
+    dst[i + 1] = lsm6ds_raw(src + i * 2 + 2);
+    dst[i + 2] = lsm6ds_raw(src + i * 2 + 4);
+    dst[i + 3] = lsm6ds_raw(src + i * 2 + 6);
+  }
+  for (; i < count; i++) {
+    dst[i] = lsm6ds_raw(src + i * 2);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Converts little-endian 16-bit samples to scaled floats
+    @param src Packed little-endian sample bytes, `count * 2` bytes
+    @param dst Array of `count` to hold the results
+    @param count The number of 16-bit values, three per XYZ sample
+    @param scale Output units per LSB, eg. from accelScale() or gyroScale()
+*/
+/**************************************************************************/
+void lsm6ds_decode_float(const uint8_t *src, float *dst, size_t count,
+                         float scale) {
+  size_t i = 0;
+
+#if defined(LSM6DS_DECODE_X86)
+#if defined(__AVX2__)
+  const __m256 scale8 = _mm256_set1_ps(scale);
+  for (; i + 8 <= count; i += 8) {
+    __m128i raw = _mm_loadu_si128((const __m128i *)(src + i * 2));
+    __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(f, scale8));
+  }
+#endif
+  const __m128 scale4 = _mm_set1_ps(scale);
+  for (; i + 8 <= count; i += 8) {
+    __m128i raw = _mm_loadu_si128((const __m128i *)(src + i * 2));
+    // sign extend by placing each value in the top half and shifting down
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale4));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale4));
+  }
+#elif defined(LSM6DS_DECODE_NEON)
+  const float32x4_t scale4 = vdupq_n_f32(scale);
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t raw = vreinterpretq_s16_u8(vld1q_u8(src + i * 2));
+    int32x4_t lo = vmovl_s16(vget_low_s16(raw));
+    int32x4_t hi = vmovl_s16(vget_high_s16(raw));
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(lo), scale4));
+    vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(hi), scale4));
+  }
+#endif
+
+  for (; i + 4 <= count; i += 4) {
+    dst[i] = lsm6ds_raw(src + i * 2) * scale;
+    dst[i + 1] = lsm6ds_raw(src + i * 2 + 2) * scale;
+    dst[i + 2] = lsm6ds_raw(src + i * 2 + 4) * scale;
+    dst[i + 3] = lsm6ds_raw(src + i * 2 + 6) * scale;
+  }
+  for (; i < count; i++) {
+    dst[i] = lsm6ds_raw(src + i * 2) * scale;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Converts little-endian 16-bit samples to scaled integers, for
+    FPU-less targets or exact fixed-point pipelines
+    @param src Packed little-endian sample bytes, `count * 2` bytes
+    @param dst Array of `count` to hold the results
+    @param count The number of 16-bit values, three per XYZ sample
+    @param scale Integer output units per LSB, eg. 122 to get micro-g from the
+    4G accelerometer range or 70 to get milli-dps from the 2000 dps gyro
+    range. Being 16 bits, any scale keeps the product of a full-scale sample
+    within 32 bits; finer units than that need a float decode.
+*/
+/**************************************************************************/
+void lsm6ds_decode_int32(const uint8_t *src, int32_t *dst, size_t count,
+                         uint16_t scale) {
+  // 32768 * 65535 is just below 2^31, so no path can overflow
+  const int32_t factor = scale;
+  size_t i = 0;
+
+#if defined(LSM6DS_DECODE_X86) && defined(__AVX2__)
+  const __m256i scale8 = _mm256_set1_epi32(factor);
+  for (; i + 8 <= count; i += 8) {
+    __m128i raw = _mm_loadu_si128((const __m128i *)(src + i * 2));
+    __m256i wide = _mm256_cvtepi16_epi32(raw);
+    _mm256_storeu_si256((__m256i *)(dst + i),
+                        _mm256_mullo_epi32(wide, scale8));
+  }
+#elif defined(LSM6DS_DECODE_X86) && defined(__SSE4_1__)
+  const __m128i scale4 = _mm_set1_epi32(factor);
+  for (; i + 8 <= count; i += 8) {
+    __m128i raw = _mm_loadu_si128((const __m128i *)(src + i * 2));
+    __m128i lo = _mm_cvtepi16_epi32(raw);
+    __m128i hi = _mm_cvtepi16_epi32(_mm_srli_si128(raw, 8));
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_mullo_epi32(lo, scale4));
+    _mm_storeu_si128((__m128i *)(dst + i + 4), _mm_mullo_epi32(hi, scale4));
+  }
+#elif defined(LSM6DS_DECODE_NEON)
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t raw = vreinterpretq_s16_u8(vld1q_u8(src + i * 2));
+    vst1q_s32(dst + i, vmulq_n_s32(vmovl_s16(vget_low_s16(raw)), factor));
+    vst1q_s32(dst + i + 4, vmulq_n_s32(vmovl_s16(vget_high_s16(raw)), factor));
+  }
+#endif
+
+  for (; i + 4 <= count; i += 4) {
+    dst[i] = (int32_t)lsm6ds_raw(src + i * 2) * factor;
+    dst[i + 1] = (int32_t)lsm6ds_raw(src + i * 2 + 2) * factor;
+    dst[i + 2] = (int32_t)lsm6ds_raw(src + i * 2 + 4) * factor;
+    dst[i + 3] = (int32_t)lsm6ds_raw(src + i * 2 + 6) * factor;
+  }
+  for (; i < count; i++) {
+    dst[i] = (int32_t)lsm6ds_raw(src + i * 2) * factor;
+  }
+}
@@ -0,0 +1,40 @@
+/*!
+ *  @file Adafruit_LSM6DS_Decode.h
+ *
+ * 	Bulk raw-to-engineering-units decode kernels for LSM6DS sample data
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_DECODE_H
+#define _ADAFRUIT_LSM6DS_DECODE_H
+
+#include "Arduino.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#define LSM6DS_DECODE_X86 ///< x86 SIMD paths are available
+#elif defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#define LSM6DS_DECODE_NEON ///< ARM NEON paths are available
+#endif
+
+/*!
+    @brief Assembles one little-endian 16-bit sample as the output registers
+    and FIFO store it
+    @param src Pointer to the low byte
+    @returns The signed sample
+*/
+static inline int16_t lsm6ds_raw(const uint8_t *src) {
+  return (int16_t)(src[1] << 8 | src[0]);
+}
+
+void lsm6ds_decode_raw(const uint8_t *src, int16_t *dst, size_t count);
+void lsm6ds_decode_float(const uint8_t *src, float *dst, size_t count,
+                         float scale);
+void lsm6ds_decode_int32(const uint8_t *src, int32_t *dst, size_t count,
+                         uint16_t scale);
+
+#endif
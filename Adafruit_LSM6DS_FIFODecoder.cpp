@@ -0,0 +1,196 @@
+
+/*!
+ *  @file Adafruit_LSM6DS_FIFODecoder.cpp
+ *  Tagged FIFO word decoder, with compression support, for the LSM6DSOX
+ *  family
+ *
+ *  Each FIFO word is a tag byte and six data bytes. The tag names the
+ *  sensor and, with compression on, how the data is packed:
+ *  - NC, NC_T_1, NC_T_2: one full sample for time slot t, t-1 or t-2
+ *  - 2xC: signed 8-bit X, Y, Z differences for slots t-2 and t-1
+ *  - 3xC: three 16-bit fields of signed 5-bit X, Y, Z differences for
+ *    slots t-2, t-1 and t
+ *  where t is the slot the word was written in, tracked through the 2-bit
+ *  TAG_CNT field. Differences chain from the sensor's previous sample, so
+ *  the reconstruction is exact.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_FIFODecoder.h"
+
+/*!
+ *    @brief  Instantiates a decoder ready for the start of a stream
+ */
+Adafruit_LSM6DS_FIFODecoder::Adafruit_LSM6DS_FIFODecoder(void) { reset(); }
+
+/**************************************************************************/
+/*!
+    @brief Forgets the previous samples and restarts the slot count. Call
+    after the FIFO is emptied, reconfigured or has overrun.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_FIFODecoder::reset(void) {
+  memset(_accel, 0, sizeof(_accel));
+  memset(_gyro, 0, sizeof(_gyro));
+  _accel_valid = false;
+  _gyro_valid = false;
+  _started = false;
+  _tag_count = 0;
+  _slot = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief Rebuilds the samples held in one accel or gyro word
+    @param tag The sensor tag
+    @param data The word's six data bytes
+    @param last The sensor's previous sample, updated to the newest one
+    @param samples Array to hold the samples, oldest first
+    @returns The number of samples, 0 if the tag is not an accel or gyro
+    tag
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS_FIFODecoder::_expand(uint8_t tag, const uint8_t *data,
+                                             int16_t *last,
+                                             lsm6ds_fifo_sample_t *samples) {
+  switch (tag) {
+  case LSM6DS_FIFO_TAG_ACCEL_NC:
+  case LSM6DS_FIFO_TAG_GYRO_NC:
+  case LSM6DS_FIFO_TAG_ACCEL_NC_T_1:
+  case LSM6DS_FIFO_TAG_GYRO_NC_T_1:
+  case LSM6DS_FIFO_TAG_ACCEL_NC_T_2:
+  case LSM6DS_FIFO_TAG_GYRO_NC_T_2:
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      last[axis] = (int16_t)(data[axis * 2 + 1] << 8 | data[axis * 2]);
+    }
+    memcpy(samples[0].data, last, sizeof(samples[0].data));
+    if ((tag == LSM6DS_FIFO_TAG_ACCEL_NC) || (tag == LSM6DS_FIFO_TAG_GYRO_NC)) {
+      samples[0].slot = _slot;
+    } else if ((tag == LSM6DS_FIFO_TAG_ACCEL_NC_T_1) ||
+               (tag == LSM6DS_FIFO_TAG_GYRO_NC_T_1)) {
+      samples[0].slot = _slot - 1;
+    } else {
+      samples[0].slot = _slot - 2;
+    }
+    return 1;
+
+  case LSM6DS_FIFO_TAG_ACCEL_2XC:
+  case LSM6DS_FIFO_TAG_GYRO_2XC:
+    for (uint8_t s = 0; s < 2; s++) {
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        last[axis] += (int8_t)data[s * 3 + axis];
+      }
+      memcpy(samples[s].data, last, sizeof(samples[s].data));
+      samples[s].slot = _slot - 2 + s;
+    }
+    return 2;
+
+  case LSM6DS_FIFO_TAG_ACCEL_3XC:
+  case LSM6DS_FIFO_TAG_GYRO_3XC:
+    for (uint8_t s = 0; s < 3; s++) {
+      uint16_t packed = data[s * 2 + 1] << 8 | data[s * 2];
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        int8_t diff = (packed >> (axis * 5)) & 0x1F;
+        if (diff & 0x10) { // sign extend the 5-bit field
+          diff -= 0x20;
+        }
+        last[axis] += diff;
+      }
+      memcpy(samples[s].data, last, sizeof(samples[s].data));
+      samples[s].slot = _slot - 2 + s;
+    }
+    return 3;
+  }
+  return 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief Decodes one FIFO word
+    @param word The tag byte followed by six data bytes
+    @param samples Array of LSM6DS_FIFO_MAX_SAMPLES to hold the results,
+    oldest first
+    @returns The number of samples stored, 0 if the word was empty, unknown
+    or a compressed word with no earlier sample to apply it to
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS_FIFODecoder::decodeWord(
+    const uint8_t *word, lsm6ds_fifo_sample_t *samples) {
+  uint8_t tag = word[0] >> 3;
+  const uint8_t *data = word + 1;
+
+  // advance the slot by the TAG_CNT step, which wraps every four slots
+  uint8_t tag_count = (word[0] >> 1) & 0x03;
+  if (_started) {
+    _slot += (tag_count - _tag_count) & 0x03;
+  }
+  _tag_count = tag_count;
+  _started = true;
+
+  bool gyro = (tag == LSM6DS_FIFO_TAG_GYRO_NC) ||
+              ((tag >= LSM6DS_FIFO_TAG_GYRO_NC_T_2) &&
+               (tag <= LSM6DS_FIFO_TAG_GYRO_3XC));
+  bool accel = (tag == LSM6DS_FIFO_TAG_ACCEL_NC) ||
+               ((tag >= LSM6DS_FIFO_TAG_ACCEL_NC_T_2) &&
+                (tag <= LSM6DS_FIFO_TAG_ACCEL_3XC));
+  if (!gyro && !accel) {
+    if (tag == 0) {
+      _errors++;
+      return 0;
+    }
+    samples[0].tag = tag;
+    samples[0].slot = _slot;
+    for (uint8_t i = 0; i < 3; i++) {
+      samples[0].data[i] = (int16_t)(data[i * 2 + 1] << 8 | data[i * 2]);
+    }
+    return 1;
+  }
+
+  bool *valid = gyro ? &_gyro_valid : &_accel_valid;
+  bool compressed = (tag == LSM6DS_FIFO_TAG_ACCEL_2XC) ||
+                    (tag == LSM6DS_FIFO_TAG_ACCEL_3XC) ||
+                    (tag == LSM6DS_FIFO_TAG_GYRO_2XC) ||
+                    (tag == LSM6DS_FIFO_TAG_GYRO_3XC);
+  if (compressed && !*valid) {
+    _errors++; // the stream started mid-sequence, wait for a full sample
+    return 0;
+  }
+  *valid = true;
+
+  uint8_t count = _expand(tag, data, gyro ? _gyro : _accel, samples);
+  for (uint8_t s = 0; s < count; s++) {
+    samples[s].tag = gyro ? LSM6DS_FIFO_TAG_GYRO_NC : LSM6DS_FIFO_TAG_ACCEL_NC;
+  }
+  return count;
+}
+
+/**************************************************************************/
+/*!
+    @brief Decodes a run of FIFO words, as read by readFIFO()
+    @param words Packed 7-byte FIFO words
+    @param count The number of words
+    @param samples Array to hold the results, with room for
+    `count * LSM6DS_FIFO_MAX_SAMPLES` samples. Samples of each sensor are in
+    time order; use their slots to line up accel and gyro.
+    @returns The number of samples stored
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_FIFODecoder::decode(const uint8_t *words, size_t count,
+                                           lsm6ds_fifo_sample_t *samples) {
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    total += decodeWord(words + i * LSM6DS_FIFO_TAGGED_WORD, samples + total);
+  }
+  return total;
+}
+
+/**************************************************************************/
+/*!
+    @brief Counts words that were skipped since the decoder was created:
+    empty words, and compressed words seen before any full sample of their
+    sensor
+    @returns The number of skipped words
+*/
+/**************************************************************************/
+uint32_t Adafruit_LSM6DS_FIFODecoder::errors(void) { return _errors; }
@@ -0,0 +1,79 @@
+/*!
+ *  @file Adafruit_LSM6DS_FIFODecoder.h
+ *
+ * 	Tagged FIFO word decoder, with compression support, for the LSM6DSOX
+ * 	family
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_FIFODECODER_H
+#define _ADAFRUIT_LSM6DS_FIFODECODER_H
+
+#include "Arduino.h"
+
+#define LSM6DS_FIFO_TAGGED_WORD 7 ///< Bytes per tagged FIFO word
+#define LSM6DS_FIFO_MAX_SAMPLES                                                \
+  3 ///< Most samples a single compressed word expands to
+
+/** FIFO_DATA_OUT_TAG sensor tags, bits 7:3 of each word's tag byte */
+typedef enum fifo_tag {
+  LSM6DS_FIFO_TAG_GYRO_NC = 0x01,      ///< Gyro, uncompressed, slot t
+  LSM6DS_FIFO_TAG_ACCEL_NC = 0x02,     ///< Accel, uncompressed, slot t
+  LSM6DS_FIFO_TAG_TEMPERATURE = 0x03,  ///< Temperature
+  LSM6DS_FIFO_TAG_TIMESTAMP = 0x04,    ///< Timestamp
+  LSM6DS_FIFO_TAG_CFG_CHANGE = 0x05,   ///< Configuration change
+  LSM6DS_FIFO_TAG_ACCEL_NC_T_2 = 0x06, ///< Accel, uncompressed, slot t-2
+  LSM6DS_FIFO_TAG_ACCEL_NC_T_1 = 0x07, ///< Accel, uncompressed, slot t-1
+  LSM6DS_FIFO_TAG_ACCEL_2XC = 0x08,    ///< Accel, 8-bit deltas, t-2 and t-1
+  LSM6DS_FIFO_TAG_ACCEL_3XC = 0x09,    ///< Accel, 5-bit deltas, t-2 to t
+  LSM6DS_FIFO_TAG_GYRO_NC_T_2 = 0x0A,  ///< Gyro, uncompressed, slot t-2
+  LSM6DS_FIFO_TAG_GYRO_NC_T_1 = 0x0B,  ///< Gyro, uncompressed, slot t-1
+  LSM6DS_FIFO_TAG_GYRO_2XC = 0x0C,     ///< Gyro, 8-bit deltas, t-2 and t-1
+  LSM6DS_FIFO_TAG_GYRO_3XC = 0x0D,     ///< Gyro, 5-bit deltas, t-2 to t
+} lsm6ds_fifo_tag_t;
+
+/** One sample recovered from the FIFO */
+typedef struct {
+  uint8_t tag;     ///< LSM6DS_FIFO_TAG_ACCEL_NC or LSM6DS_FIFO_TAG_GYRO_NC
+                   ///< for reconstructed samples, otherwise the word's tag
+  uint32_t slot;   ///< Time slot, counted in batch periods of the fastest
+                   ///< batched sensor since the decoder was reset
+  int16_t data[3]; ///< X, Y and Z, or the word's raw data for other tags
+} lsm6ds_fifo_sample_t;
+
+/*!
+ *    @brief  Turns tagged FIFO words back into full samples. Compressed
+ *            words hold differences from the previous sample of the same
+ *            sensor, so one decoder must see every word of a stream, in
+ *            order, from the first uncompressed word on.
+ */
+class Adafruit_LSM6DS_FIFODecoder {
+public:
+  Adafruit_LSM6DS_FIFODecoder(void);
+
+  void reset(void);
+  uint8_t decodeWord(const uint8_t *word, lsm6ds_fifo_sample_t *samples);
+  size_t decode(const uint8_t *words, size_t count,
+                lsm6ds_fifo_sample_t *samples);
+  uint32_t errors(void);
+
+private:
+  uint8_t _expand(uint8_t tag, const uint8_t *data, int16_t *last,
+                  lsm6ds_fifo_sample_t *samples);
+
+  int16_t _accel[3];    ///< Last accel sample, the base for deltas
+  int16_t _gyro[3];     ///< Last gyro sample, the base for deltas
+  bool _accel_valid;    ///< `_accel` holds a real sample
+  bool _gyro_valid;     ///< `_gyro` holds a real sample
+  bool _started;        ///< A word has been seen since reset()
+  uint8_t _tag_count;   ///< TAG_CNT of the last word
+  uint32_t _slot;       ///< Running time slot of the last word
+  uint32_t _errors = 0; ///< Words that could not be decoded
+};
+
+#endif
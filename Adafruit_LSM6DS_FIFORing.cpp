@@ -0,0 +1,262 @@
+/*!
+ *  @file Adafruit_LSM6DS_FIFORing.cpp
+ *  Caller-owned ring buffer that LSM6DS FIFO words are drained straight
+ *  into
+ *
+ *  Positions run from 0 to twice the capacity, so `head - tail` tells a
+ *  full ring from an empty one without a shared count. The writer only
+ *  moves the head and the reader only moves the tail, each after it is
+ *  done with the words in between. A side reads the other's position with
+ *  acquire and publishes its own with release, so the words are in place
+ *  before the position that hands them over.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_FIFORing.h"
+
+#if LSM6DS_RING_ATOMIC
+/*!
+ *    @brief  Reads a position the other side publishes
+ *    @param  pos The position
+ *    @returns Its value
+ */
+static inline size_t ring_load(lsm6ds_ring_pos_t *pos) {
+  return pos->load(std::memory_order_acquire);
+}
+
+/*!
+ *    @brief  Publishes this side's position
+ *    @param  pos The position
+ *    @param  value Its new value
+ */
+static inline void ring_store(lsm6ds_ring_pos_t *pos, size_t value) {
+  pos->store(value, std::memory_order_release);
+}
+#elif defined(__AVR__)
+#include <util/atomic.h>
+
+/*!
+ *    @brief  Reads a position the other side publishes, with interrupts
+ *            off so an interrupt can't change half of it
+ *    @param  pos The position
+ *    @returns Its value
+ */
+static inline size_t ring_load(lsm6ds_ring_pos_t *pos) {
+  size_t value;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { value = *pos; }
+  return value;
+}
+
+/*!
+ *    @brief  Publishes this side's position, with interrupts off so an
+ *            interrupt can't read half of it
+ *    @param  pos The position
+ *    @param  value Its new value
+ */
+static inline void ring_store(lsm6ds_ring_pos_t *pos, size_t value) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *pos = value; }
+}
+#else
+/*!
+ *    @brief  Reads a position the other side publishes
+ *    @param  pos The position
+ *    @returns Its value
+ */
+static inline size_t ring_load(lsm6ds_ring_pos_t *pos) { return *pos; }
+
+/*!
+ *    @brief  Publishes this side's position
+ *    @param  pos The position
+ *    @param  value Its new value
+ */
+static inline void ring_store(lsm6ds_ring_pos_t *pos, size_t value) {
+  *pos = value;
+}
+#endif
+
+/*!
+ *    @brief  Instantiates a ring. Call begin() to give it memory.
+ */
+Adafruit_LSM6DS_FIFORing::Adafruit_LSM6DS_FIFORing(void) {}
+
+/**************************************************************************/
+/*!
+    @brief Sets the memory to hold FIFO words in and empties the ring
+    @param buffer The caller's memory, `size` bytes
+    @param size Bytes in `buffer`. Only whole words are used.
+    @param word_size Bytes per FIFO word, from the driver's fifoWordSize()
+    @returns False if `buffer` can't hold a single word
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_FIFORing::begin(uint8_t *buffer, size_t size,
+                                     uint8_t word_size) {
+  if (!buffer || !word_size || (size < word_size)) {
+    return false;
+  }
+  _buffer = buffer;
+  _word_size = word_size;
+  _capacity = size / word_size;
+  reset();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Drops every unread word. Only call while nothing writes to or
+    reads from the ring.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_FIFORing::reset(void) {
+  ring_store(&_head, 0);
+  ring_store(&_tail, 0);
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the number of words waiting to be read
+    @returns The number of unread FIFO words
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_FIFORing::available(void) {
+  return _used(ring_load(&_head), ring_load(&_tail));
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the number of words that can be written
+    @returns The number of free FIFO words
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_FIFORing::space(void) {
+  return _capacity - _used(ring_load(&_head), ring_load(&_tail));
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the size of the words the ring holds
+    @returns The number of bytes per FIFO word
+*/
+/**************************************************************************/
+uint8_t Adafruit_LSM6DS_FIFORing::wordSize(void) { return _word_size; }
+
+/**************************************************************************/
+/*!
+    @brief Gets the unread words in place, without taking them out
+    @param view Filled with the runs of words, oldest first. The second run
+    is only used when the words wrap around the end of the buffer.
+    @param max_words The most words to include
+    @returns The number of words in the view. They stay valid until passed
+    to release().
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_FIFORing::peek(lsm6ds_fifo_view_t *view,
+                                      size_t max_words) {
+  memset(view, 0, sizeof(lsm6ds_fifo_view_t));
+  size_t tail = ring_load(&_tail);
+  size_t words = _used(ring_load(&_head), tail);
+  if (words > max_words) {
+    words = max_words;
+  }
+  if (!words) {
+    return 0;
+  }
+
+  size_t start = tail % _capacity;
+  size_t first = _capacity - start;
+  if (first > words) {
+    first = words;
+  }
+  view->data[0] = _buffer + start * _word_size;
+  view->words[0] = first;
+  if (words > first) {
+    view->data[1] = _buffer;
+    view->words[1] = words - first;
+  }
+  return words;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets one unread word in place
+    @param index The word, 0 for the oldest, up to available() - 1
+    @returns Pointer to the word's bytes, or NULL if `index` is out of range
+*/
+/**************************************************************************/
+const uint8_t *Adafruit_LSM6DS_FIFORing::word(size_t index) {
+  size_t tail = ring_load(&_tail);
+  if (index >= _used(ring_load(&_head), tail)) {
+    return NULL;
+  }
+  return _buffer + ((tail + index) % _capacity) * _word_size;
+}
+
+/**************************************************************************/
+/*!
+    @brief Hands the oldest words back to the writer once they are used
+    @param words The number of words to drop, capped at available()
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_FIFORing::release(size_t words) {
+  size_t tail = ring_load(&_tail);
+  size_t used = _used(ring_load(&_head), tail);
+  if (words > used) {
+    words = used;
+  }
+  if (!words) {
+    return;
+  }
+  ring_store(&_tail, (tail + words) % (2 * _capacity));
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the free space the next words can be written to in one
+    transfer, for the writer
+    @param words Set to the number of words that fit before the ring is
+    full or wraps
+    @returns Where to write them, NULL if the ring is full
+*/
+/**************************************************************************/
+uint8_t *Adafruit_LSM6DS_FIFORing::reserve(size_t *words) {
+  if (!_capacity) {
+    *words = 0;
+    return NULL;
+  }
+  size_t head = ring_load(&_head);
+  size_t room = _capacity - _used(head, ring_load(&_tail));
+  size_t start = head % _capacity;
+  *words = _capacity - start;
+  if (*words > room) {
+    *words = room;
+  }
+  return *words ? _buffer + start * _word_size : NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief Makes words written to the space from reserve() readable
+    @param words The number of words written, no more than reserve() gave
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_FIFORing::commit(size_t words) {
+  if (!words) {
+    return;
+  }
+  ring_store(&_head, (ring_load(&_head) + words) % (2 * _capacity));
+}
+
+/**************************************************************************/
+/*!
+    @brief Counts the words between two positions
+    @param head The write position
+    @param tail The read position
+    @returns The number of unread words
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_FIFORing::_used(size_t head, size_t tail) {
+  if (!_capacity) {
+    return 0; // no buffer yet
+  }
+  return (head + 2 * _capacity - tail) % (2 * _capacity);
+}
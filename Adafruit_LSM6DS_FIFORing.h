@@ -0,0 +1,88 @@
+/*!
+ *  @file Adafruit_LSM6DS_FIFORing.h
+ *
+ * 	Caller-owned ring buffer that LSM6DS FIFO words are drained straight
+ *      into
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_FIFORING_H
+#define _ADAFRUIT_LSM6DS_FIFORING_H
+
+#include "Arduino.h"
+
+#ifndef LSM6DS_RING_ATOMIC
+#if defined(__has_include)
+#if __has_include(<atomic>) && !defined(__AVR__)
+#define LSM6DS_RING_ATOMIC 1 ///< Ring positions are std::atomic
+#endif
+#endif
+#endif
+#ifndef LSM6DS_RING_ATOMIC
+#define LSM6DS_RING_ATOMIC 0 ///< Ring positions are volatile
+#endif
+
+#if LSM6DS_RING_ATOMIC
+#include <atomic>
+typedef std::atomic<size_t> lsm6ds_ring_pos_t; ///< A shared ring position
+#else
+typedef volatile size_t lsm6ds_ring_pos_t; ///< A shared ring position
+#endif
+
+/** Unread words of a ring, as at most two runs of memory in the ring */
+typedef struct {
+  const uint8_t *data[2]; ///< Start of each run, NULL if it is empty
+  size_t words[2];        ///< FIFO words in each run
+} lsm6ds_fifo_view_t;
+
+/*!
+ *    @brief  Holds raw FIFO words in memory the caller owns. The driver's
+ *            drainFIFO() reads into it directly, splitting a burst in two
+ *            where the ring wraps, and the caller reads the words in place
+ *            through views, so nothing is copied in between. One writer
+ *            and one reader can work on it from different contexts, eg. a
+ *            DMA completion interrupt and loop(). The positions they share
+ *            are std::atomic with acquire/release ordering where the
+ *            toolchain has it. On AVR, where a 16-bit position can be read
+ *            half updated, each access to the other side's position is
+ *            made with interrupts off. Elsewhere without <atomic> the
+ *            positions are only volatile: call the ring with the other
+ *            side's interrupt masked, or from a single core.
+ */
+class Adafruit_LSM6DS_FIFORing {
+public:
+  Adafruit_LSM6DS_FIFORing(void);
+
+  bool begin(uint8_t *buffer, size_t size, uint8_t word_size);
+  void reset(void);
+
+  size_t available(void);
+  size_t space(void);
+  uint8_t wordSize(void);
+
+  size_t peek(lsm6ds_fifo_view_t *view, size_t max_words = (size_t)-1);
+  const uint8_t *word(size_t index);
+  void release(size_t words);
+
+  uint8_t *reserve(size_t *words);
+  void commit(size_t words);
+
+private:
+  size_t _used(size_t head, size_t tail);
+
+  uint8_t *_buffer = NULL; ///< The caller's memory
+  size_t _capacity = 0;    ///< Whole FIFO words that fit in `_buffer`
+  uint8_t _word_size = 0;  ///< Bytes per FIFO word
+  //! next word to write, counted modulo twice the capacity so a full ring
+  //! can be told from an empty one. Only the writer changes it.
+  lsm6ds_ring_pos_t _head{0};
+  //! next word to read, counted like `_head`. Only the reader changes it.
+  lsm6ds_ring_pos_t _tail{0};
+};
+
+#endif
@@ -0,0 +1,281 @@
+/*!
+ *  @file Adafruit_LSM6DS_Linux.cpp
+ *  Linux userspace i2c-dev and spidev bus backends for LSM6DS sensors
+ *
+ *  Both backends move a whole register burst with one ioctl: I2C_RDWR
+ *  combines the address write and the data read, and a two-transfer
+ *  SPI_IOC_MESSAGE keeps chip select asserted across address and data.
+ *  An SPI read longer than spidev allows in one message is split into
+ *  several. Only FIFO bursts get that long, and the FIFO output address
+ *  rolls back to its first register after each word, so every piece
+ *  starts again at that register where the last one left off.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#if defined(__linux__)
+
+#include "Adafruit_LSM6DS_Linux.h"
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <linux/spi/spidev.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#define LSM6DS_LINUX_I2C_STACK_WRITE                                           \
+  32 ///< Longest I2C write that is staged on the stack
+#define LSM6DS_LINUX_SPIDEV_BUFSIZ_PATH                                        \
+  "/sys/module/spidev/parameters/bufsiz" ///< spidev per-message limit
+#define LSM6DS_LINUX_SPI_READ_ALIGN                                            \
+  14 ///< Split reads on whole FIFO words, 2 or 7 bytes on every chip
+
+/*!
+ *    @brief  Instantiates a backend for a sensor on a Linux I2C adapter
+ *    @param  device The adapter device path, e.g. "/dev/i2c-1". Must stay
+ *            valid for the life of the object.
+ *    @param  i2c_address The 7-bit I2C address of the sensor
+ */
+Adafruit_LSM6DS_LinuxI2C::Adafruit_LSM6DS_LinuxI2C(const char *device,
+                                                   uint8_t i2c_address) {
+  _device = device;
+  _address = i2c_address;
+}
+
+/*!
+ *    @brief  Closes the adapter
+ */
+Adafruit_LSM6DS_LinuxI2C::~Adafruit_LSM6DS_LinuxI2C() { end(); }
+
+/*!
+ *    @brief  Opens the adapter
+ *    @returns True if the adapter opened and supports combined transfers
+ */
+bool Adafruit_LSM6DS_LinuxI2C::begin(void) {
+  end();
+  _fd = open(_device, O_RDWR);
+  if (_fd < 0) {
+    return false;
+  }
+  unsigned long funcs = 0;
+  if ((ioctl(_fd, I2C_FUNCS, &funcs) < 0) || !(funcs & I2C_FUNC_I2C)) {
+    end();
+    return false;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Closes the adapter
+ */
+void Adafruit_LSM6DS_LinuxI2C::end(void) {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+/*!
+ *    @brief  Reads registers with one I2C_RDWR ioctl
+ *    @param  reg The first register address
+ *    @param  buffer Buffer to hold the register values
+ *    @param  len The number of registers to read
+ *    @returns True if the transfer succeeded
+ */
+bool Adafruit_LSM6DS_LinuxI2C::read(uint8_t reg, uint8_t *buffer, size_t len) {
+  if ((_fd < 0) || (len > 0xFFFF)) {
+    return false;
+  }
+  struct i2c_msg msgs[2];
+  msgs[0].addr = _address;
+  msgs[0].flags = 0;
+  msgs[0].len = 1;
+  msgs[0].buf = &reg;
+  msgs[1].addr = _address;
+  msgs[1].flags = I2C_M_RD;
+  msgs[1].len = len;
+  msgs[1].buf = buffer;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = msgs;
+  xfer.nmsgs = 2;
+  return ioctl(_fd, I2C_RDWR, &xfer) == 2;
+}
+
+/*!
+ *    @brief  Writes registers with one I2C_RDWR ioctl
+ *    @param  reg The first register address
+ *    @param  buffer The register values to write
+ *    @param  len The number of registers to write
+ *    @returns True if the transfer succeeded
+ */
+bool Adafruit_LSM6DS_LinuxI2C::write(uint8_t reg, const uint8_t *buffer,
+                                     size_t len) {
+  if ((_fd < 0) || (len >= 0xFFFF)) {
+    return false;
+  }
+  // the address and data must be one message, so stage them together
+  uint8_t stack_buf[LSM6DS_LINUX_I2C_STACK_WRITE + 1];
+  uint8_t *out = stack_buf;
+  if (len > LSM6DS_LINUX_I2C_STACK_WRITE) {
+    out = (uint8_t *)malloc(len + 1);
+    if (!out) {
+      return false;
+    }
+  }
+  out[0] = reg;
+  memcpy(out + 1, buffer, len);
+
+  struct i2c_msg msg;
+  msg.addr = _address;
+  msg.flags = 0;
+  msg.len = len + 1;
+  msg.buf = out;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = &msg;
+  xfer.nmsgs = 1;
+  bool ok = ioctl(_fd, I2C_RDWR, &xfer) == 1;
+
+  if (out != stack_buf) {
+    free(out);
+  }
+  return ok;
+}
+
+/*!
+ *    @brief  Instantiates a backend for a sensor on a Linux SPI device
+ *    @param  device The SPI device path, e.g. "/dev/spidev0.0". Must stay
+ *            valid for the life of the object.
+ *    @param  frequency The SPI clock rate in Hz
+ *    @param  three_wire True if the sensor's SDI/SDO share one data line,
+ *            see Adafruit_LSM6DS::enable3WireSPI()
+ */
+Adafruit_LSM6DS_LinuxSPI::Adafruit_LSM6DS_LinuxSPI(const char *device,
+                                                   uint32_t frequency,
+                                                   bool three_wire) {
+  _device = device;
+  _frequency = frequency;
+  _three_wire = three_wire;
+}
+
+/*!
+ *    @brief  Closes the device
+ */
+Adafruit_LSM6DS_LinuxSPI::~Adafruit_LSM6DS_LinuxSPI() { end(); }
+
+/*!
+ *    @brief  Opens the device in SPI mode 0 and reads the spidev message
+ *            size limit. Raise the spidev `bufsiz` module parameter to
+ *            drain a full FIFO in one transfer.
+ *    @returns True if the device opened and accepted the settings
+ */
+bool Adafruit_LSM6DS_LinuxSPI::begin(void) {
+  end();
+  _fd = open(_device, O_RDWR);
+  if (_fd < 0) {
+    return false;
+  }
+  uint8_t mode = SPI_MODE_0 | (_three_wire ? SPI_3WIRE : 0);
+  uint8_t bits = 8;
+  if ((ioctl(_fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+      (ioctl(_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) ||
+      (ioctl(_fd, SPI_IOC_WR_MAX_SPEED_HZ, &_frequency) < 0)) {
+    end();
+    return false;
+  }
+
+  size_t bufsiz = LSM6DS_LINUX_SPIDEV_BUFSIZ;
+  FILE *param = fopen(LSM6DS_LINUX_SPIDEV_BUFSIZ_PATH, "r");
+  if (param) {
+    unsigned long value;
+    if ((fscanf(param, "%lu", &value) == 1) && (value > 1)) {
+      bufsiz = value;
+    }
+    fclose(param);
+  }
+  // the address byte shares the message with the data
+  _max_transfer = bufsiz - 1;
+  return true;
+}
+
+/*!
+ *    @brief  Closes the device
+ */
+void Adafruit_LSM6DS_LinuxSPI::end(void) {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+/*!
+ *    @brief  Sends an address byte and then moves data, in one message
+ *    @param  addr The address byte, with the read bit set for reads
+ *    @param  tx Data to send, or NULL to read
+ *    @param  rx Buffer for received data, or NULL to write
+ *    @param  len The number of data bytes
+ *    @returns True if the transfer succeeded
+ */
+bool Adafruit_LSM6DS_LinuxSPI::transfer(uint8_t addr, const uint8_t *tx,
+                                        uint8_t *rx, size_t len) {
+  if ((_fd < 0) || (len > _max_transfer)) {
+    return false;
+  }
+  struct spi_ioc_transfer xfer[2];
+  memset(xfer, 0, sizeof(xfer));
+  xfer[0].tx_buf = (unsigned long)&addr;
+  xfer[0].len = 1;
+  xfer[0].speed_hz = _frequency;
+  xfer[0].bits_per_word = 8;
+  xfer[1].tx_buf = (unsigned long)tx;
+  xfer[1].rx_buf = (unsigned long)rx;
+  xfer[1].len = len;
+  xfer[1].speed_hz = _frequency;
+  xfer[1].bits_per_word = 8;
+  return ioctl(_fd, SPI_IOC_MESSAGE(2), xfer) == (int)(len + 1);
+}
+
+/*!
+ *    @brief  Reads registers with one SPI_IOC_MESSAGE ioctl, or a FIFO
+ *            burst longer than maxTransfer() with one ioctl per piece
+ *    @param  reg The first register address
+ *    @param  buffer Buffer to hold the register values
+ *    @param  len The number of registers to read
+ *    @returns True if every transfer succeeded
+ */
+bool Adafruit_LSM6DS_LinuxSPI::read(uint8_t reg, uint8_t *buffer, size_t len) {
+  if (len <= _max_transfer) {
+    return transfer(reg | 0x80, NULL, buffer, len);
+  }
+  // restart at `reg` each time, so each piece must end on a word boundary
+  size_t chunk = _max_transfer - _max_transfer % LSM6DS_LINUX_SPI_READ_ALIGN;
+  if (!chunk) {
+    return false;
+  }
+  for (size_t done = 0; done < len; done += chunk) {
+    size_t part = (len - done < chunk) ? (len - done) : chunk;
+    if (!transfer(reg | 0x80, NULL, buffer + done, part)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Writes registers with one SPI_IOC_MESSAGE ioctl
+ *    @param  reg The first register address
+ *    @param  buffer The register values to write
+ *    @param  len The number of registers to write, up to maxTransfer()
+ *    @returns True if the transfer succeeded
+ */
+bool Adafruit_LSM6DS_LinuxSPI::write(uint8_t reg, const uint8_t *buffer,
+                                     size_t len) {
+  return transfer(reg & 0x7F, buffer, NULL, len);
+}
+
+#endif
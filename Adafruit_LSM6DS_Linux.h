@@ -0,0 +1,81 @@
+/*!
+ *  @file Adafruit_LSM6DS_Linux.h
+ *
+ * 	Linux userspace i2c-dev and spidev bus backends for LSM6DS sensors
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_LINUX_H
+#define _ADAFRUIT_LSM6DS_LINUX_H
+
+#if defined(__linux__)
+
+#include "Adafruit_LSM6DS_Bus.h"
+
+#define LSM6DS_LINUX_SPI_HZ 10000000 ///< Default spidev clock, 10 MHz max
+#define LSM6DS_LINUX_SPIDEV_BUFSIZ                                             \
+  4096 ///< spidev per-message limit when the module does not report one
+
+/*!
+ *    @brief  Bus backend for a sensor on a Linux I2C adapter (/dev/i2c-N).
+ *            Each register read is a single I2C_RDWR ioctl carrying the
+ *            address write and the data read with a repeated start.
+ */
+class Adafruit_LSM6DS_LinuxI2C : public Adafruit_LSM6DS_Bus {
+public:
+  Adafruit_LSM6DS_LinuxI2C(const char *device, uint8_t i2c_address = 0x6A);
+  ~Adafruit_LSM6DS_LinuxI2C();
+
+  bool begin(void);
+  void end(void);
+  bool read(uint8_t reg, uint8_t *buffer, size_t len);
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len);
+
+private:
+  const char *_device; ///< Adapter device path
+  uint8_t _address;    ///< 7-bit sensor address
+  int _fd = -1;        ///< Open adapter, -1 when closed
+};
+
+/*!
+ *    @brief  Bus backend for a sensor on a Linux SPI device
+ *            (/dev/spidevB.C). The address byte and the data go out as two
+ *            transfers of one SPI_IOC_MESSAGE with chip select held, so
+ *            data is read straight into the caller's buffer. FIFO reads
+ *            longer than maxTransfer() take one message per piece.
+ */
+class Adafruit_LSM6DS_LinuxSPI : public Adafruit_LSM6DS_Bus {
+public:
+  Adafruit_LSM6DS_LinuxSPI(const char *device,
+                           uint32_t frequency = LSM6DS_LINUX_SPI_HZ,
+                           bool three_wire = false);
+  ~Adafruit_LSM6DS_LinuxSPI();
+
+  bool begin(void);
+  void end(void);
+  bool read(uint8_t reg, uint8_t *buffer, size_t len);
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len);
+
+  /*!  @brief  The longest read or write a single message can carry.
+   *           Longer writes fail; longer reads are split.
+   *   @returns Register count, set from the spidev bufsiz by begin() */
+  size_t maxTransfer(void) { return _max_transfer; }
+
+private:
+  bool transfer(uint8_t addr, const uint8_t *tx, uint8_t *rx, size_t len);
+
+  const char *_device; ///< SPI device path
+  uint32_t _frequency; ///< Clock rate in Hz
+  bool _three_wire;    ///< Half duplex on a shared data line
+  size_t _max_transfer = LSM6DS_LINUX_SPIDEV_BUFSIZ - 1; ///< See maxTransfer()
+  int _fd = -1; ///< Open device, -1 when closed
+};
+
+#endif
+
+#endif
@@ -0,0 +1,369 @@
+/*!
+ *  @file Adafruit_LSM6DS_Pipeline.cpp
+ *  Multithreaded FIFO acquisition and processing pipeline for LSM6DS
+ *  sensors on Linux hosts
+ *
+ *  Each bus gets one acquisition thread, since transfers on a bus are
+ *  serialized anyway, and it is the only thread that touches the sensor
+ *  objects on that bus. Blocks circulate between two bounded lock-free
+ *  queues: acquisition pops a free block, fills it with one readFIFO() and
+ *  pushes it to the ready queue; a worker pops it, runs every stage on it
+ *  and returns it to the free queue. The fixed block count bounds memory and
+ *  is the backpressure point.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#if defined(__linux__)
+
+#include "Adafruit_LSM6DS_Pipeline.h"
+
+#if LSM6DS_ENABLE_FIFO
+
+#include <chrono>
+
+/*!
+ *    @brief  Instantiates an empty queue
+ *    @param  capacity The most pointers the queue holds, rounded up to a
+ *            power of 2
+ */
+Adafruit_LSM6DS_BlockQueue::Adafruit_LSM6DS_BlockQueue(size_t capacity) {
+  size_t size = 2;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  _cells = new cell[size];
+  for (size_t i = 0; i < size; i++) {
+    _cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  _mask = size - 1;
+  _head.store(0, std::memory_order_relaxed);
+  _tail.store(0, std::memory_order_relaxed);
+}
+
+/*!
+ *    @brief  Frees the queue storage
+ */
+Adafruit_LSM6DS_BlockQueue::~Adafruit_LSM6DS_BlockQueue() { delete[] _cells; }
+
+/*!
+ *    @brief  Adds a block pointer, from any thread
+ *    @param  block The block to add
+ *    @returns False if the queue is full
+ */
+bool Adafruit_LSM6DS_BlockQueue::push(lsm6ds_block_t *block) {
+  size_t pos = _head.load(std::memory_order_relaxed);
+  for (;;) {
+    cell *c = &_cells[pos & _mask];
+    size_t seq = c->sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (_head.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        c->block = block;
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = _head.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+/*!
+ *    @brief  Takes the oldest block pointer, from any thread
+ *    @returns The block, or NULL if the queue is empty
+ */
+lsm6ds_block_t *Adafruit_LSM6DS_BlockQueue::pop(void) {
+  size_t pos = _tail.load(std::memory_order_relaxed);
+  for (;;) {
+    cell *c = &_cells[pos & _mask];
+    size_t seq = c->sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (diff == 0) {
+      if (_tail.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        lsm6ds_block_t *block = c->block;
+        c->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return block;
+      }
+    } else if (diff < 0) {
+      return NULL;
+    } else {
+      pos = _tail.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+/*!
+ *    @brief  Counts the queued pointers. Only exact while no other thread
+ *            is pushing or popping.
+ *    @returns The number of queued pointers
+ */
+size_t Adafruit_LSM6DS_BlockQueue::size(void) {
+  return _head.load(std::memory_order_relaxed) -
+         _tail.load(std::memory_order_relaxed);
+}
+
+/*!
+ *    @brief  Instantiates a stopped pipeline with no sensors or stages
+ *    @param  blocks The number of block buffers shared by all sensors. A
+ *            pipeline with none can't be started.
+ */
+Adafruit_LSM6DS_Pipeline::Adafruit_LSM6DS_Pipeline(size_t blocks)
+    : _block_count(blocks), _free(blocks), _ready(blocks) {
+  _blocks = new lsm6ds_block_t[blocks];
+  for (size_t i = 0; i < blocks; i++) {
+    _free.push(&_blocks[i]);
+  }
+  _acquiring.store(false);
+  _working.store(false);
+  resetStats();
+}
+
+/*!
+ *    @brief  Stops the pipeline and frees the block buffers
+ */
+Adafruit_LSM6DS_Pipeline::~Adafruit_LSM6DS_Pipeline() {
+  stop();
+  delete[] _blocks;
+}
+
+/*!
+ *    @brief  Adds a sensor whose FIFO is already configured. Only the
+ *            pipeline may use the sensor while it is running.
+ *    @param  sensor The sensor to drain
+ *    @param  bus Sensors sharing a bus number are drained by one thread
+ *    @returns The sensor's index, stored in its blocks, or -1 if the
+ *             pipeline is running
+ */
+int Adafruit_LSM6DS_Pipeline::addSensor(Adafruit_LSM6DS *sensor, uint8_t bus) {
+  if (running()) {
+    return -1;
+  }
+  source src = {sensor, bus, 0};
+  _sources.push_back(src);
+  return _sources.size() - 1;
+}
+
+/*!
+ *    @brief  Appends a processing stage. Stages run in the order added,
+ *            all on the same worker for a given block; different blocks,
+ *            even from one sensor, may be processed at the same time.
+ *    @param  stage The function to call on each block
+ *    @param  context Passed through to `stage`
+ *    @returns False if the pipeline is running or has no room for a stage
+ */
+bool Adafruit_LSM6DS_Pipeline::addStage(lsm6ds_stage_t stage, void *context) {
+  if (running() || (_stage_count >= LSM6DS_PIPELINE_MAX_STAGES)) {
+    return false;
+  }
+  _stages[_stage_count] = stage;
+  _contexts[_stage_count] = context;
+  _stage_count++;
+  return true;
+}
+
+/*!
+ *    @brief  Chooses what acquisition does when every block is in use
+ *    @param  drop True to read and discard the FIFO data, counting it in
+ *            the stats, so the sensor FIFOs never overflow. False to wait
+ *            for a worker to free a block.
+ */
+void Adafruit_LSM6DS_Pipeline::setDropWhenFull(bool drop) { _drop = drop; }
+
+/*!
+ *    @brief  Starts one acquisition thread per bus and the worker pool
+ *    @param  workers The number of worker threads, 0 for one per core
+ *    @param  poll_us How long a bus thread sleeps when no sensor on it had
+ *            data
+ *    @returns False if already running, no sensors were added or there
+ *             are no block buffers
+ */
+bool Adafruit_LSM6DS_Pipeline::start(unsigned int workers, uint32_t poll_us) {
+  if (running() || _sources.empty() || !_block_count) {
+    return false;
+  }
+  if (!workers) {
+    workers = std::thread::hardware_concurrency(); // 0 if unknown
+  }
+  if (!workers) {
+    workers = 1;
+  }
+  _poll_us = poll_us;
+
+  _working.store(true);
+  _acquiring.store(true);
+  for (unsigned int i = 0; i < workers; i++) {
+    _workers.push_back(std::thread(&Adafruit_LSM6DS_Pipeline::work, this));
+  }
+  for (size_t i = 0; i < _sources.size(); i++) {
+    bool seen = false;
+    for (size_t j = 0; j < i; j++) {
+      seen |= (_sources[j].bus == _sources[i].bus);
+    }
+    if (!seen) {
+      _acquirers.push_back(std::thread(&Adafruit_LSM6DS_Pipeline::acquire,
+                                       this, _sources[i].bus));
+    }
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Stops acquisition, lets the workers finish every block already
+ *            read, and joins all threads
+ */
+void Adafruit_LSM6DS_Pipeline::stop(void) {
+  _acquiring.store(false);
+  for (size_t i = 0; i < _acquirers.size(); i++) {
+    _acquirers[i].join();
+  }
+  _acquirers.clear();
+
+  _working.store(false);
+  for (size_t i = 0; i < _workers.size(); i++) {
+    _workers[i].join();
+  }
+  _workers.clear();
+}
+
+/*!
+ *    @brief  Checks whether the pipeline threads are running
+ *    @returns True between start() and stop()
+ */
+bool Adafruit_LSM6DS_Pipeline::running(void) { return _working.load(); }
+
+/*!
+ *    @brief  Copies the pipeline counters. Safe to call while running.
+ *    @param  stats Where to store the counters
+ */
+void Adafruit_LSM6DS_Pipeline::getStats(lsm6ds_pipeline_stats_t *stats) {
+  stats->blocks = _blocks_out.load();
+  stats->words = _words_out.load();
+  stats->dropped_blocks = _dropped_blocks.load();
+  stats->dropped_words = _dropped_words.load();
+  stats->stalls = _stalls.load();
+  stats->max_queued = _max_queued.load();
+}
+
+/*!
+ *    @brief  Zeroes the pipeline counters
+ */
+void Adafruit_LSM6DS_Pipeline::resetStats(void) {
+  _blocks_out.store(0);
+  _words_out.store(0);
+  _dropped_blocks.store(0);
+  _dropped_words.store(0);
+  _stalls.store(0);
+  _max_queued.store(0);
+}
+
+/*!
+ *    @brief  Gets a block to fill, waiting for one unless dropping
+ *    @returns A free block, or NULL when dropping or stopping
+ */
+lsm6ds_block_t *Adafruit_LSM6DS_Pipeline::freeBlock(void) {
+  lsm6ds_block_t *block = _free.pop();
+  if (block || _drop) {
+    return block;
+  }
+  _stalls++;
+  while (!block && _acquiring.load()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    block = _free.pop();
+  }
+  return block;
+}
+
+/*!
+ *    @brief  Acquisition thread body: drains every sensor on one bus in
+ *            turn until stopped
+ *    @param  bus The bus number to serve
+ */
+void Adafruit_LSM6DS_Pipeline::acquire(uint8_t bus) {
+  lsm6ds_block_t scratch; // drop target, never queued
+
+  while (_acquiring.load()) {
+    bool any = false;
+    for (size_t i = 0; i < _sources.size(); i++) {
+      source *src = &_sources[i];
+      if (src->bus != bus) {
+        continue;
+      }
+      uint8_t word_size = src->sensor->fifoWordSize();
+      size_t max_words = sizeof(scratch.data) / word_size;
+
+      lsm6ds_block_t *block = freeBlock();
+      if (!block && !_drop) {
+        break; // stopping
+      }
+      if (!block) {
+        size_t words = src->sensor->readFIFO(scratch.data, max_words);
+        if (words) {
+          _dropped_blocks++;
+          _dropped_words += words;
+          src->sequence++;
+          any = true;
+        }
+        continue;
+      }
+
+      size_t words = src->sensor->readFIFO(block->data, max_words);
+      if (!words) {
+        _free.push(block);
+        continue;
+      }
+      block->sensor = i;
+      block->word_size = word_size;
+      block->words = words;
+      block->sequence = src->sequence++;
+      _blocks_out++;
+      _words_out += words;
+      _ready.push(block);
+      any = true;
+
+      uint32_t queued = _ready.size();
+      uint32_t seen = _max_queued.load();
+      while ((queued > seen) &&
+             !_max_queued.compare_exchange_weak(seen, queued)) {
+      }
+    }
+    if (!any) {
+      std::this_thread::sleep_for(std::chrono::microseconds(_poll_us));
+    }
+  }
+}
+
+/*!
+ *    @brief  Worker thread body: runs the stages on ready blocks until
+ *            stopped and the ready queue is empty
+ */
+void Adafruit_LSM6DS_Pipeline::work(void) {
+  uint32_t idle = 0;
+  for (;;) {
+    lsm6ds_block_t *block = _ready.pop();
+    if (!block) {
+      if (!_working.load()) {
+        return;
+      }
+      if (++idle < LSM6DS_PIPELINE_SPINS) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+      continue;
+    }
+    idle = 0;
+    for (uint8_t s = 0; s < _stage_count; s++) {
+      _stages[s](block, _contexts[s]);
+    }
+    _free.push(block);
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+/*!
+ *  @file Adafruit_LSM6DS_Pipeline.h
+ *
+ * 	Multithreaded FIFO acquisition and processing pipeline for LSM6DS
+ *      sensors on Linux hosts
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_PIPELINE_H
+#define _ADAFRUIT_LSM6DS_PIPELINE_H
+
+#if defined(__linux__)
+
+#include "Adafruit_LSM6DS.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if LSM6DS_ENABLE_FIFO
+
+#ifndef LSM6DS_PIPELINE_BLOCK_WORDS
+#define LSM6DS_PIPELINE_BLOCK_WORDS 128 ///< Most FIFO words in one block
+#endif
+#define LSM6DS_PIPELINE_MAX_STAGES 8 ///< Processing stages per pipeline
+#define LSM6DS_PIPELINE_SPINS                                                  \
+  64 ///< Idle polls a worker yields for before it starts sleeping
+
+/** FIFO words drained from one sensor in one read */
+typedef struct {
+  uint8_t sensor;    ///< Index returned by addSensor()
+  uint8_t word_size; ///< Bytes per FIFO word
+  uint16_t words;    ///< FIFO words in `data`
+  uint32_t sequence; ///< Per-sensor block count, a gap means dropped blocks
+  uint8_t data[LSM6DS_PIPELINE_BLOCK_WORDS * 7]; ///< Raw FIFO words
+} lsm6ds_block_t;
+
+/** A processing stage, run by a worker thread on each block in turn */
+typedef void (*lsm6ds_stage_t)(lsm6ds_block_t *block, void *context);
+
+/** Pipeline counters, see Adafruit_LSM6DS_Pipeline::getStats() */
+typedef struct {
+  uint64_t blocks;         ///< Blocks handed to the workers
+  uint64_t words;          ///< FIFO words in those blocks
+  uint64_t dropped_blocks; ///< Blocks discarded because no buffer was free
+  uint64_t dropped_words;  ///< FIFO words in the discarded blocks
+  uint64_t stalls;         ///< Times acquisition waited for a free buffer
+  uint32_t max_queued;     ///< Most blocks ever waiting for a worker
+} lsm6ds_pipeline_stats_t;
+
+/*!
+ *    @brief  Bounded lock-free multi-producer, multi-consumer queue of
+ *            block pointers, after Dmitry Vyukov's sequence-numbered ring
+ */
+class Adafruit_LSM6DS_BlockQueue {
+public:
+  Adafruit_LSM6DS_BlockQueue(size_t capacity);
+  ~Adafruit_LSM6DS_BlockQueue();
+
+  bool push(lsm6ds_block_t *block);
+  lsm6ds_block_t *pop(void);
+  size_t size(void);
+
+private:
+  /** One ring slot */
+  struct cell {
+    std::atomic<size_t> sequence; ///< Lap counter for this slot
+    lsm6ds_block_t *block;        ///< Stored pointer
+  };
+
+  cell *_cells;                          ///< Ring slots, a power of 2
+  size_t _mask;                          ///< Slot count - 1
+  alignas(64) std::atomic<size_t> _head; ///< Next slot to push
+  alignas(64) std::atomic<size_t> _tail; ///< Next slot to pop
+};
+
+/*!
+ *    @brief  Drains the FIFOs of many sensors on dedicated threads, one per
+ *            bus, and runs user processing stages on a pool of workers.
+ *            Full buffers are passed through lock-free queues; when every
+ *            buffer is in use, acquisition either waits or drops and counts
+ *            the data.
+ */
+class Adafruit_LSM6DS_Pipeline {
+public:
+  Adafruit_LSM6DS_Pipeline(size_t blocks = 64);
+  ~Adafruit_LSM6DS_Pipeline();
+
+  int addSensor(Adafruit_LSM6DS *sensor, uint8_t bus = 0);
+  bool addStage(lsm6ds_stage_t stage, void *context = NULL);
+  void setDropWhenFull(bool drop);
+
+  bool start(unsigned int workers = 0, uint32_t poll_us = 500);
+  void stop(void);
+  bool running(void);
+
+  void getStats(lsm6ds_pipeline_stats_t *stats);
+  void resetStats(void);
+
+private:
+  /** A sensor and the bus thread that drains it */
+  struct source {
+    Adafruit_LSM6DS *sensor; ///< The sensor
+    uint8_t bus;             ///< Bus it shares with other sensors
+    uint32_t sequence;       ///< Blocks produced so far
+  };
+
+  void acquire(uint8_t bus);
+  void work(void);
+  lsm6ds_block_t *freeBlock(void);
+
+  std::vector<source> _sources;        ///< Sensors from addSensor()
+  std::vector<std::thread> _acquirers; ///< One thread per bus
+  std::vector<std::thread> _workers;   ///< Processing threads
+  lsm6ds_block_t *_blocks;             ///< Block storage
+  size_t _block_count;                 ///< Blocks in `_blocks`
+  Adafruit_LSM6DS_BlockQueue _free;    ///< Blocks ready to fill
+  Adafruit_LSM6DS_BlockQueue _ready;   ///< Blocks waiting for a worker
+  bool _drop = false;                  ///< Drop instead of waiting
+  uint32_t _poll_us = 500;             ///< Acquisition idle sleep
+  std::atomic<bool> _acquiring;        ///< Bus threads run while set
+  std::atomic<bool> _working;          ///< Workers run while set
+
+  lsm6ds_stage_t _stages[LSM6DS_PIPELINE_MAX_STAGES]; ///< Processing stages
+  void *_contexts[LSM6DS_PIPELINE_MAX_STAGES];        ///< Stage contexts
+  uint8_t _stage_count = 0;                           ///< Stages in use
+
+  std::atomic<uint64_t> _blocks_out, ///< See lsm6ds_pipeline_stats_t
+      _words_out, _dropped_blocks, _dropped_words, _stalls;
+  std::atomic<uint32_t> _max_queued; ///< See lsm6ds_pipeline_stats_t
+};
+
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,361 @@
+/*!
+ *  @file Adafruit_LSM6DS_Resampler.cpp
+ *  Merges accelerometer and gyro event streams running at different data
+ *  rates into one stream on a common timebase
+ *
+ *  Event timestamps are whole milliseconds anchored to the time of each
+ *  FIFO read, so at high data rates they are quantized and jump between
+ *  batches. Each stream runs them through a second order tracking loop:
+ *  every sample is predicted one tracked period after the last, and the
+ *  timestamp only nudges the prediction and the period. The loop gains
+ *  scale with the data rate so it settles over LSM6DS_RESAMPLER_TRACKING_MS
+ *  whatever the rate, averaging over many reads. The smoothed times
+ *  follow the chip's real data rate, which can be a few percent off its
+ *  nominal value, and both streams are linearly interpolated at the
+ *  output times.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Resampler.h"
+
+/*!
+ *    @brief  Instantiates a resampler. Call setRates() before pushing
+ *            events.
+ */
+Adafruit_LSM6DS_Resampler::Adafruit_LSM6DS_Resampler(void) {
+  memset(_streams, 0, sizeof(_streams));
+  memset(_out, 0, sizeof(_out));
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets the input and output data rates and clears all history
+    @param accel_rate The accelerometer data rate in Hz, eg. from
+    accelerationSampleRate()
+    @param gyro_rate The gyro data rate in Hz, eg. from
+    gyroscopeSampleRate()
+    @param output_rate The fused sample rate in Hz, or 0 to use the faster
+    of the two input rates
+    @returns False if an input rate is not positive
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Resampler::setRates(float accel_rate, float gyro_rate,
+                                         float output_rate) {
+  if ((accel_rate <= 0) || (gyro_rate <= 0) || (output_rate < 0)) {
+    return false;
+  }
+  if (output_rate == 0) {
+    output_rate = (accel_rate > gyro_rate) ? accel_rate : gyro_rate;
+  }
+
+  _streams[0].nominal_us = 1000000.0f / gyro_rate;
+  _streams[1].nominal_us = 1000000.0f / accel_rate;
+  for (uint8_t s = 0; s < 2; s++) {
+    // critically damped, settling in about LSM6DS_RESAMPLER_TRACKING_MS
+    float gain =
+        2 * _streams[s].nominal_us / (LSM6DS_RESAMPLER_TRACKING_MS * 1000.0f);
+    _streams[s].phase_gain = (gain < 1) ? gain : 1;
+    _streams[s].period_gain =
+        _streams[s].phase_gain * _streams[s].phase_gain / 4;
+  }
+  _out_period_q8 = (uint32_t)(256000000.0f / output_rate + 0.5f);
+  reset();
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Clears the sample history and timing of both streams, keeping
+    the rates. Call after a data rate change or a restart of the FIFO.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Resampler::reset(void) {
+  for (uint8_t s = 0; s < 2; s++) {
+    _streams[s].head = 0;
+    _streams[s].count = 0;
+    _streams[s].frac_us = 0;
+    _streams[s].period_us = _streams[s].nominal_us;
+  }
+  _next_out_us = 0;
+  _next_out_frac = 0;
+  _started = false;
+  _ready = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Sets a function to be called with every fused sample
+    @param callback The function to call, or NULL to only use read()
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Resampler::setCallback(
+    lsm6ds_resampler_callback_t callback) {
+  _callback = callback;
+}
+
+/**************************************************************************/
+/*!
+    @brief Feeds accelerometer and gyro events, eg. the arrays filled by
+    getEvents(), and produces every fused sample they complete
+    @param accel Accelerometer events, oldest first. May be NULL if
+    `accel_count` is 0.
+    @param accel_count The number of accelerometer events
+    @param gyro Gyro events, oldest first. May be NULL if `gyro_count` is 0.
+    @param gyro_count The number of gyro events
+    @returns The number of fused samples produced. Use setCallback() to
+    receive each of them.
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_Resampler::push(const sensors_event_t *accel,
+                                       size_t accel_count,
+                                       const sensors_event_t *gyro,
+                                       size_t gyro_count) {
+  if (!_out_period_q8) {
+    return 0;
+  }
+
+  // merge in time order so the faster stream's history only has to span
+  // one period of the slower one
+  size_t a = 0, g = 0, produced = 0;
+  while ((a < accel_count) || (g < gyro_count)) {
+    if ((g >= gyro_count) ||
+        ((a < accel_count) && (accel[a].timestamp <= gyro[g].timestamp))) {
+      _add(&_streams[1], &accel[a++]);
+    } else {
+      _add(&_streams[0], &gyro[g++]);
+    }
+    produced += _emit();
+  }
+
+  return produced;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the latest fused sample
+    @param accel Event to fill with the interpolated acceleration
+    @param gyro Event to fill with the interpolated rotation
+    @returns True if this sample had not been read before
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Resampler::read(sensors_event_t *accel,
+                                     sensors_event_t *gyro) {
+  if (accel) {
+    memcpy(accel, &_out[1], sizeof(sensors_event_t));
+  }
+  if (gyro) {
+    memcpy(gyro, &_out[0], sizeof(sensors_event_t));
+  }
+  bool fresh = _ready;
+  _ready = false;
+  return fresh;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the data rate a stream is actually running at, as tracked
+    from its timestamps
+    @param accel True for the accelerometer, false for the gyro
+    @returns The measured data rate in Hz
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS_Resampler::measuredRate(bool accel) {
+  float period_us = _streams[accel].period_us;
+  return (period_us > 0) ? 1000000.0f / period_us : 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief Adds one event to a stream, smoothing its timestamp
+    @param stream The stream to add to
+    @param event The event
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Resampler::_add(lsm6ds_resample_stream_t *stream,
+                                     const sensors_event_t *event) {
+  int32_t elapsed_ms = event->timestamp - _epoch_ms;
+  int32_t gap_us =
+      (int32_t)(3 * stream->period_us) + LSM6DS_RESAMPLER_MAX_JITTER_US;
+
+  // time went backwards or jumped past what the internal times can hold
+  if (_started &&
+      ((elapsed_ms < 0) || (elapsed_ms > LSM6DS_RESAMPLER_REBASE_US / 500) ||
+       (stream->count &&
+        ((elapsed_ms * 1000L) - _newest(stream) < -gap_us)))) {
+    reset();
+  }
+  if (!_started) {
+    _epoch_ms = event->timestamp;
+    _started = true;
+    elapsed_ms = 0;
+  }
+
+  int32_t stamp_us = elapsed_ms * 1000L;
+  int32_t time_us = stamp_us;
+  float frac_us = 0;
+  if (stream->count) {
+    // predict one period on, then let the timestamp nudge phase and period
+    float advance = stream->frac_us + stream->period_us;
+    float error = (float)(stamp_us - _newest(stream)) - advance;
+    if (error <= gap_us) {
+      advance += error * stream->phase_gain;
+      int32_t whole = (int32_t)floorf(advance);
+      time_us = _newest(stream) + whole;
+      frac_us = advance - whole;
+      stream->period_us += error * stream->period_gain;
+      // keep within the chips' +/-10% data rate tolerance
+      float limit = stream->nominal_us / 10;
+      if (stream->period_us > stream->nominal_us + limit) {
+        stream->period_us = stream->nominal_us + limit;
+      } else if (stream->period_us < stream->nominal_us - limit) {
+        stream->period_us = stream->nominal_us - limit;
+      }
+    }
+  }
+
+  stream->head = (stream->head + 1) % LSM6DS_RESAMPLER_HISTORY;
+  if (stream->count < LSM6DS_RESAMPLER_HISTORY) {
+    stream->count++;
+  }
+  stream->time_us[stream->head] = time_us;
+  stream->frac_us = frac_us;
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    stream->xyz[stream->head][axis] = event->data[axis];
+  }
+  stream->sensor_id = event->sensor_id;
+  stream->type = event->type;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the smoothed time of a stream's oldest held sample
+    @param stream The stream, holding at least one sample
+    @returns The time in us
+*/
+/**************************************************************************/
+int32_t Adafruit_LSM6DS_Resampler::_oldest(lsm6ds_resample_stream_t *stream) {
+  uint8_t slot = (stream->head + LSM6DS_RESAMPLER_HISTORY + 1 - stream->count) %
+                 LSM6DS_RESAMPLER_HISTORY;
+  return stream->time_us[slot];
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the smoothed time of a stream's newest sample
+    @param stream The stream, holding at least one sample
+    @returns The time in us
+*/
+/**************************************************************************/
+int32_t Adafruit_LSM6DS_Resampler::_newest(lsm6ds_resample_stream_t *stream) {
+  return stream->time_us[stream->head];
+}
+
+/**************************************************************************/
+/*!
+    @brief Fills an event with a stream's value at a given time, linearly
+    interpolated between the two samples around it
+    @param stream The stream, holding at least one sample
+    @param time_us The time to interpolate at
+    @param event The event to fill
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Resampler::_interpolate(lsm6ds_resample_stream_t *stream,
+                                             int32_t time_us,
+                                             sensors_event_t *event) {
+  memset(event, 0, sizeof(sensors_event_t));
+  event->version = 1;
+  event->sensor_id = stream->sensor_id;
+  event->type = stream->type;
+
+  // walk back from the newest sample to the first one at or before time_us
+  uint8_t newer = stream->head;
+  uint8_t older = newer;
+  for (uint8_t k = 1; k < stream->count; k++) {
+    if (stream->time_us[older] - time_us <= 0) {
+      break;
+    }
+    newer = older;
+    older = (older + LSM6DS_RESAMPLER_HISTORY - 1) % LSM6DS_RESAMPLER_HISTORY;
+  }
+
+  int32_t span = stream->time_us[newer] - stream->time_us[older];
+  int32_t offset = time_us - stream->time_us[older];
+  float frac = 0;
+  if ((span > 0) && (offset > 0)) {
+    frac = (offset >= span) ? 1 : (float)offset / span;
+  }
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    float from = stream->xyz[older][axis];
+    event->data[axis] = from + (stream->xyz[newer][axis] - from) * frac;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Produces every output sample both streams now reach
+    @returns The number of samples produced
+*/
+/**************************************************************************/
+size_t Adafruit_LSM6DS_Resampler::_emit(void) {
+  lsm6ds_resample_stream_t *gyro = &_streams[0];
+  lsm6ds_resample_stream_t *accel = &_streams[1];
+  if (!gyro->count || !accel->count) {
+    return 0;
+  }
+
+  // outputs older than the history either stream still holds are skipped
+  int32_t start = _oldest(gyro);
+  if (_oldest(accel) - start > 0) {
+    start = _oldest(accel);
+  }
+  if (_next_out_us - start < 0) {
+    _next_out_us = start;
+    _next_out_frac = 0;
+  }
+  int32_t end = _newest(gyro);
+  if (_newest(accel) - end < 0) {
+    end = _newest(accel);
+  }
+
+  size_t produced = 0;
+  while (_next_out_us - end <= 0) {
+    _interpolate(gyro, _next_out_us, &_out[0]);
+    _interpolate(accel, _next_out_us, &_out[1]);
+    int32_t timestamp = _epoch_ms + (_next_out_us + 500) / 1000;
+    _out[0].timestamp = timestamp;
+    _out[1].timestamp = timestamp;
+    _ready = true;
+    produced++;
+    if (_callback) {
+      _callback(&_out[1], &_out[0]);
+    }
+
+    uint32_t step = _next_out_frac + _out_period_q8;
+    _next_out_us += step >> 8;
+    _next_out_frac = step & 0xFF;
+  }
+
+  _rebase();
+  return produced;
+}
+
+/**************************************************************************/
+/*!
+    @brief Moves the internal time origin forward before the us times can
+    overflow
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Resampler::_rebase(void) {
+  if (_next_out_us < LSM6DS_RESAMPLER_REBASE_US) {
+    return;
+  }
+  for (uint8_t s = 0; s < 2; s++) {
+    for (uint8_t i = 0; i < LSM6DS_RESAMPLER_HISTORY; i++) {
+      _streams[s].time_us[i] -= LSM6DS_RESAMPLER_REBASE_US;
+    }
+  }
+  _next_out_us -= LSM6DS_RESAMPLER_REBASE_US;
+  _epoch_ms += LSM6DS_RESAMPLER_REBASE_US / 1000;
+}
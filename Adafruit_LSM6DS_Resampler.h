@@ -0,0 +1,105 @@
+/*!
+ *  @file Adafruit_LSM6DS_Resampler.h
+ *
+ * 	Merges accelerometer and gyro event streams running at different data
+ *      rates into one stream on a common timebase
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_RESAMPLER_H
+#define _ADAFRUIT_LSM6DS_RESAMPLER_H
+
+#include "Arduino.h"
+#include <Adafruit_Sensor.h>
+
+#ifndef LSM6DS_RESAMPLER_HISTORY
+#define LSM6DS_RESAMPLER_HISTORY                                               \
+  16 ///< Samples kept per stream, must exceed the fast/slow rate ratio
+#endif
+
+#ifndef LSM6DS_RESAMPLER_MAX_JITTER_US
+#define LSM6DS_RESAMPLER_MAX_JITTER_US                                         \
+  5000 ///< Timestamp error beyond 3 periods plus this is taken as a gap
+#endif
+
+#ifndef LSM6DS_RESAMPLER_TRACKING_MS
+#define LSM6DS_RESAMPLER_TRACKING_MS                                           \
+  1000 ///< Time constant of the timestamp tracking loops, should span
+       ///< several FIFO reads
+#endif
+
+#define LSM6DS_RESAMPLER_REBASE_US                                             \
+  1000000000L ///< Internal times are shifted back after this many us
+
+/** Called for each fused sample, with both events at the same timestamp */
+typedef void (*lsm6ds_resampler_callback_t)(const sensors_event_t *accel,
+                                            const sensors_event_t *gyro);
+
+/*!
+ *    @brief  Interpolates independently rated accelerometer and gyro events,
+ *            eg. from getEvents(), onto one output rate so downstream code
+ *            sees synchronous samples. Each input stream's sample times are
+ *            smoothed by a tracking loop that follows the chip's real data
+ *            rate, which removes the jitter of millisecond timestamps
+ *            anchored to read times.
+ */
+class Adafruit_LSM6DS_Resampler {
+public:
+  Adafruit_LSM6DS_Resampler(void);
+
+  bool setRates(float accel_rate, float gyro_rate, float output_rate = 0);
+  void reset(void);
+  void setCallback(lsm6ds_resampler_callback_t callback);
+
+  size_t push(const sensors_event_t *accel, size_t accel_count,
+              const sensors_event_t *gyro, size_t gyro_count);
+  bool read(sensors_event_t *accel, sensors_event_t *gyro);
+
+  float measuredRate(bool accel);
+
+private:
+  /** Recent samples and timing state of one input stream */
+  typedef struct {
+    int32_t time_us[LSM6DS_RESAMPLER_HISTORY]; ///< Smoothed sample times
+    float xyz[LSM6DS_RESAMPLER_HISTORY][3];    ///< Sample values
+    uint8_t head;                              ///< Slot of the newest
+    uint8_t count;                             ///< Samples held
+    float frac_us;                             ///< Fraction of newest time
+    float period_us;                           ///< Tracked sample period
+    float nominal_us;                          ///< Period from setRates()
+    float phase_gain;                          ///< Tracking loop gains, set
+    float period_gain;                         ///< by the data rate
+    int32_t sensor_id;                         ///< Copied to the outputs
+    int32_t type;                              ///< Copied to the outputs
+  } lsm6ds_resample_stream_t;
+
+  void _add(lsm6ds_resample_stream_t *stream, const sensors_event_t *event);
+  void _interpolate(lsm6ds_resample_stream_t *stream, int32_t time_us,
+                    sensors_event_t *event);
+  int32_t _oldest(lsm6ds_resample_stream_t *stream);
+  int32_t _newest(lsm6ds_resample_stream_t *stream);
+  size_t _emit(void);
+  void _rebase(void);
+
+  //! gyro (0) and accelerometer (1) input streams
+  lsm6ds_resample_stream_t _streams[2];
+  //! latest fused gyro and accelerometer events
+  sensors_event_t _out[2];
+  lsm6ds_resampler_callback_t _callback = NULL; ///< Output callback
+  //! output sample period in 1/256 us
+  uint32_t _out_period_q8 = 0;
+  //! time of the next output sample in us
+  int32_t _next_out_us = 0;
+  uint8_t _next_out_frac = 0; ///< Fraction of `_next_out_us`
+  //! millis() that internal time 0 stands for
+  int32_t _epoch_ms = 0;
+  bool _started = false; ///< Set once `_epoch_ms` is chosen
+  bool _ready = false;   ///< True if `_out` has not been read yet
+};
+
+#endif
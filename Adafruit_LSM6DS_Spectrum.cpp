@@ -0,0 +1,293 @@
+
+/*!
+ *  @file Adafruit_LSM6DS_Spectrum.cpp
+ *  Streaming vibration spectrum analysis for LSM6DS and ISM330DHCX
+ *  accelerometer data
+ *
+ *  Raw samples are kept in a ring of LSM6DS_SPECTRUM_SIZE per axis, so the
+ *  memory use is fixed no matter how long the analyzer runs. Twiddle
+ *  factors and the Hann window are generated by rotation instead of being
+ *  stored in tables.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Spectrum.h"
+
+#if (LSM6DS_SPECTRUM_SIZE & (LSM6DS_SPECTRUM_SIZE - 1)) != 0
+#error "LSM6DS_SPECTRUM_SIZE must be a power of two"
+#endif
+
+/*!
+ *    @brief  Instantiates a new spectrum analyzer
+ */
+Adafruit_LSM6DS_Spectrum::Adafruit_LSM6DS_Spectrum(void) {}
+
+/**************************************************************************/
+/*!
+    @brief Sets up the analyzer and clears any previous samples and bands
+    @param sample_rate The rate of the samples passed to push(), in Hz
+    @param scale Factor from raw LSB to the units wanted in the results, eg.
+    m/s^2 per LSB for the configured accelerometer range
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Spectrum::begin(float sample_rate, float scale) {
+  _sample_rate = sample_rate;
+  _scale = scale;
+  _head = _filled = _pending = 0;
+  _frames = 0;
+  _num_bands = 0;
+  _available = false;
+  memset(_result, 0, sizeof(_result));
+}
+
+/**************************************************************************/
+/*!
+    @brief Adds a frequency band to track the energy of
+    @param low_hz The lower band edge in Hz
+    @param high_hz The upper band edge in Hz
+    @returns The band index into `band_energy`, or -1 if the band is empty at
+    this resolution or no more bands are available
+*/
+/**************************************************************************/
+int8_t Adafruit_LSM6DS_Spectrum::addBand(float low_hz, float high_hz) {
+  if ((_num_bands >= LSM6DS_SPECTRUM_MAX_BANDS) || (_sample_rate <= 0)) {
+    return -1;
+  }
+  float bin_width = _sample_rate / LSM6DS_SPECTRUM_SIZE;
+  int32_t low = ceil(low_hz / bin_width);
+  int32_t high = floor(high_hz / bin_width);
+  // DC is not vibration
+  if (low < 1) {
+    low = 1;
+  }
+  if (high > LSM6DS_SPECTRUM_SIZE / 2) {
+    high = LSM6DS_SPECTRUM_SIZE / 2;
+  }
+  if (high < low) {
+    return -1;
+  }
+  _band_low[_num_bands] = low;
+  _band_high[_num_bands] = high;
+  return _num_bands++;
+}
+
+/**************************************************************************/
+/*!
+    @brief Adds samples to the analyzer, running a new frame every
+    LSM6DS_SPECTRUM_HOP samples
+    @param samples Packed raw X, Y, Z samples, `count * 3` values
+    @param count The number of XYZ samples
+    @returns The number of frames analyzed during this call
+*/
+/**************************************************************************/
+uint16_t Adafruit_LSM6DS_Spectrum::push(const int16_t *samples,
+                                        size_t count) {
+  uint16_t frames = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    _ring[0][_head] = samples[0];
+    _ring[1][_head] = samples[1];
+    _ring[2][_head] = samples[2];
+    samples += 3;
+    _head = (_head + 1) & (LSM6DS_SPECTRUM_SIZE - 1);
+
+    if (_filled < LSM6DS_SPECTRUM_SIZE) {
+      _filled++;
+    }
+    if (++_pending >= LSM6DS_SPECTRUM_HOP &&
+        _filled == LSM6DS_SPECTRUM_SIZE) {
+      _pending = 0;
+      _analyze();
+      frames++;
+    }
+  }
+
+  return frames;
+}
+
+/**************************************************************************/
+/*!
+    @brief Checks for results that have not been read yet
+    @returns True if a frame was analyzed since the last getResult()
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Spectrum::available(void) { return _available; }
+
+/**************************************************************************/
+/*!
+    @brief Gets the results of the latest frame for one axis
+    @param axis 0, 1 or 2 for X, Y or Z
+    @param result The result struct to fill in
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Spectrum::getResult(uint8_t axis,
+                                         lsm6ds_spectrum_t *result) {
+  if (axis > 2) {
+    return;
+  }
+  *result = _result[axis];
+  _available = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the center frequency of an FFT bin
+    @param bin The bin number, 0 to LSM6DS_SPECTRUM_SIZE / 2
+    @returns The frequency in Hz
+*/
+/**************************************************************************/
+float Adafruit_LSM6DS_Spectrum::binFrequency(uint16_t bin) {
+  return bin * _sample_rate / LSM6DS_SPECTRUM_SIZE;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the number of frames analyzed since begin()
+    @returns The frame count
+*/
+/**************************************************************************/
+uint32_t Adafruit_LSM6DS_Spectrum::frames(void) { return _frames; }
+
+/**************************************************************************/
+/*!
+    @brief Windows and transforms the latest samples of each axis and updates
+    the results
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Spectrum::_analyze(void) {
+  const uint16_t n = LSM6DS_SPECTRUM_SIZE;
+  // Hann window by rotating (c, s) through 2 * pi / n per sample
+  const float step_c = cos(2 * M_PI / n), step_s = sin(2 * M_PI / n);
+  // sum of w^2 for a periodic Hann window is 3n/8
+  const float norm = 2.0 / (n * (3.0 * n / 8.0));
+
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    lsm6ds_spectrum_t *res = &_result[axis];
+    const int16_t *ring = _ring[axis];
+
+    // oldest sample is at _head since the ring is full
+    int32_t sum = 0;
+    for (uint16_t i = 0; i < n; i++) {
+      sum += ring[i];
+    }
+    float mean = (float)sum / n;
+
+    float sum_sq = 0, peak = 0;
+    float c = 1, s = 0;
+    for (uint16_t i = 0; i < n; i++) {
+      float x = (ring[(_head + i) & (n - 1)] - mean) * _scale;
+      sum_sq += x * x;
+      if (fabs(x) > peak) {
+        peak = fabs(x);
+      }
+      _re[i] = x * (0.5 - 0.5 * c);
+      _im[i] = 0;
+      float c_next = c * step_c - s * step_s;
+      s = s * step_c + c * step_s;
+      c = c_next;
+    }
+    res->rms = sqrt(sum_sq / n);
+    res->peak = peak;
+    res->crest_factor = (res->rms > 0) ? peak / res->rms : 0;
+
+    _fft(_re, _im);
+
+    // one-sided power spectrum, scaled to mean square per bin
+    float peak_power = 0;
+    uint16_t peak_bin = 0;
+    for (uint16_t k = 1; k <= n / 2; k++) {
+      float p = (_re[k] * _re[k] + _im[k] * _im[k]) * norm;
+      if (k == n / 2) {
+        p /= 2; // the Nyquist bin has no mirror image
+      }
+      _re[k] = p;
+      if (p > peak_power) {
+        peak_power = p;
+        peak_bin = k;
+      }
+    }
+
+    // refine the peak between bins with a parabolic fit
+    float offset = 0;
+    if ((peak_bin > 1) && (peak_bin < n / 2)) {
+      float a = sqrt(_re[peak_bin - 1]), b = sqrt(_re[peak_bin]),
+            g = sqrt(_re[peak_bin + 1]);
+      float denom = a - 2 * b + g;
+      if (denom != 0) {
+        offset = 0.5 * (a - g) / denom;
+      }
+    }
+    res->peak_freq = (peak_bin + offset) * _sample_rate / n;
+
+    // the window spreads a sine's A^2 / 2 mean square over about 3 bins
+    float line_power = peak_power;
+    if (peak_bin > 1) {
+      line_power += _re[peak_bin - 1];
+    }
+    if (peak_bin < n / 2) {
+      line_power += _re[peak_bin + 1];
+    }
+    res->peak_amplitude = sqrt(2 * line_power);
+
+    for (uint8_t b = 0; b < _num_bands; b++) {
+      float energy = 0;
+      for (uint16_t k = _band_low[b]; k <= _band_high[b]; k++) {
+        energy += _re[k];
+      }
+      res->band_energy[b] = energy;
+    }
+  }
+
+  _frames++;
+  _available = true;
+}
+
+/**************************************************************************/
+/*!
+    @brief In-place iterative radix-2 complex FFT of LSM6DS_SPECTRUM_SIZE
+    points
+    @param re Real parts
+    @param im Imaginary parts
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Spectrum::_fft(float *re, float *im) {
+  const uint16_t n = LSM6DS_SPECTRUM_SIZE;
+
+  // bit reversal permutation
+  for (uint16_t i = 1, j = 0; i < n; i++) {
+    uint16_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      float t = re[i];
+      re[i] = re[j];
+      re[j] = t;
+      t = im[i];
+      im[i] = im[j];
+      im[j] = t;
+    }
+  }
+
+  for (uint16_t len = 2; len <= n; len <<= 1) {
+    float step_c = cos(2 * M_PI / len), step_s = -sin(2 * M_PI / len);
+    uint16_t half = len >> 1;
+    float wc = 1, ws = 0;
+    for (uint16_t k = 0; k < half; k++) {
+      for (uint16_t i = k; i < n; i += len) {
+        uint16_t j = i + half;
+        float tr = re[j] * wc - im[j] * ws;
+        float ti = re[j] * ws + im[j] * wc;
+        re[j] = re[i] - tr;
+        im[j] = im[i] - ti;
+        re[i] += tr;
+        im[i] += ti;
+      }
+      float wc_next = wc * step_c - ws * step_s;
+      ws = ws * step_c + wc * step_s;
+      wc = wc_next;
+    }
+  }
+}
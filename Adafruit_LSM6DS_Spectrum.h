@@ -0,0 +1,83 @@
+/*!
+ *  @file Adafruit_LSM6DS_Spectrum.h
+ *
+ * 	Streaming vibration spectrum analysis for LSM6DS and ISM330DHCX
+ *      accelerometer data
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_SPECTRUM_H
+#define _ADAFRUIT_LSM6DS_SPECTRUM_H
+
+#include "Arduino.h"
+
+#ifndef LSM6DS_SPECTRUM_SIZE
+#define LSM6DS_SPECTRUM_SIZE 256 ///< FFT length, must be a power of two
+#endif
+#ifndef LSM6DS_SPECTRUM_HOP
+#define LSM6DS_SPECTRUM_HOP                                                    \
+  (LSM6DS_SPECTRUM_SIZE / 2) ///< New samples between frames, 50% overlap
+#endif
+#ifndef LSM6DS_SPECTRUM_MAX_BANDS
+#define LSM6DS_SPECTRUM_MAX_BANDS 8 ///< Energy bands tracked per axis
+#endif
+
+/** Condition monitoring figures for one axis over the latest frame */
+typedef struct {
+  float rms;          ///< RMS of the vibration (mean removed)
+  float peak;         ///< Largest deviation from the mean
+  float crest_factor; ///< `peak` / `rms`
+  float peak_freq;    ///< Frequency in Hz of the strongest spectral line
+  float peak_amplitude; ///< Amplitude of the strongest spectral line
+  float band_energy[LSM6DS_SPECTRUM_MAX_BANDS]; ///< Mean square per band
+} lsm6ds_spectrum_t;
+
+/*!
+ *    @brief  Windowed, overlapping FFT analysis of a three axis raw sample
+ *            stream with fixed memory use. Every LSM6DS_SPECTRUM_HOP samples
+ *            the latest LSM6DS_SPECTRUM_SIZE samples are Hann windowed and
+ *            transformed and the per-axis results are updated.
+ */
+class Adafruit_LSM6DS_Spectrum {
+public:
+  Adafruit_LSM6DS_Spectrum(void);
+
+  void begin(float sample_rate, float scale = 1.0);
+  int8_t addBand(float low_hz, float high_hz);
+
+  uint16_t push(const int16_t *samples, size_t count = 1);
+  bool available(void);
+  void getResult(uint8_t axis, lsm6ds_spectrum_t *result);
+
+  float binFrequency(uint16_t bin);
+  uint32_t frames(void);
+
+private:
+  void _analyze(void);
+  void _fft(float *re, float *im);
+
+  int16_t _ring[3][LSM6DS_SPECTRUM_SIZE]; ///< Latest raw samples per axis
+  float _re[LSM6DS_SPECTRUM_SIZE],        ///< FFT work buffer, real part
+      _im[LSM6DS_SPECTRUM_SIZE];          ///< FFT work buffer, imaginary part
+
+  lsm6ds_spectrum_t _result[3]; ///< Latest results per axis
+
+  uint16_t _band_low[LSM6DS_SPECTRUM_MAX_BANDS],  ///< First bin of each band
+      _band_high[LSM6DS_SPECTRUM_MAX_BANDS];      ///< Last bin of each band
+  uint8_t _num_bands = 0;                         ///< Bands in use
+
+  float _sample_rate = 0; ///< Input sample rate in Hz
+  float _scale = 1.0;     ///< Raw LSB to output units
+  uint16_t _head = 0;     ///< Next write position in `_ring`
+  uint16_t _filled = 0;   ///< Samples in `_ring`, up to the FFT size
+  uint16_t _pending = 0;  ///< Samples since the last frame
+  uint32_t _frames = 0;   ///< Frames analyzed
+  bool _available = false; ///< True if results have not been read yet
+};
+
+#endif
@@ -0,0 +1,259 @@
+/*!
+ *  @file Adafruit_LSM6DS_Window.cpp
+ *  Incremental per-axis statistics over tumbling or sliding windows of raw
+ *  LSM6DS samples
+ *
+ *  Each axis keeps an integer sum and sum of squares of the raw LSBs, which
+ *  give the mean, variance and RMS exactly, and its extremes. A sliding
+ *  window subtracts each sample again as it leaves the window, and finds
+ *  its extremes with monotonic queues: a new sample first removes every
+ *  queued sample it beats, so each sample is queued and removed at most
+ *  once. Tumbling windows need no history and take blocks in one tight
+ *  loop per axis that compilers can vectorize.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Window.h"
+
+/*!
+ *    @brief  Instantiates a window. Call begin() to set its length.
+ */
+Adafruit_LSM6DS_Window::Adafruit_LSM6DS_Window(void) { reset(); }
+
+/**************************************************************************/
+/*!
+    @brief Sets the window type and length and clears it
+    @param length The samples per window. Tumbling windows can hold up to
+    65535 samples, sliding ones up to LSM6DS_WINDOW_MAX_SLIDING.
+    @param sliding True to report the latest `length` samples at any time,
+    false to report each completed block of `length` samples
+    @returns False if the length is out of range
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Window::begin(uint16_t length, bool sliding) {
+  if ((length == 0) || (sliding && (length > LSM6DS_WINDOW_MAX_SLIDING))) {
+    return false;
+  }
+  _length = length;
+  _sliding = sliding;
+  reset();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief Drops every sample and completed window. Call after a range
+    change, since samples taken at different ranges can't be combined.
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Window::reset(void) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    _clearSums(&_sums[axis]);
+    _clearSums(&_done[axis]);
+    _front[0][axis] = _front[1][axis] = 0;
+    _size[0][axis] = _size[1][axis] = 0;
+  }
+  _count = 0;
+  _done_count = 0;
+  _slot = 0;
+  _fresh = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief Adds one sample
+    @param xyz The raw X, Y and Z sample, as in `rawAccX..rawAccZ` or
+    `rawGyroX..rawGyroZ`
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Window::push(const int16_t *xyz) { process(xyz, 1); }
+
+/**************************************************************************/
+/*!
+    @brief Adds a block of samples, for example a drained batch
+    @param samples Packed X, Y, Z raw samples, `count * 3` values
+    @param count The number of XYZ samples
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Window::process(const int16_t *samples, size_t count) {
+  if (!_length) {
+    return;
+  }
+
+  if (_sliding) {
+    for (size_t i = 0; i < count; i++) {
+      _slide(samples + i * 3);
+    }
+    _fresh = _fresh || count;
+    return;
+  }
+
+  while (count) {
+    uint16_t run = _length - _count;
+    if (run > count) {
+      run = count;
+    }
+    _accumulate(samples, run);
+    samples += run * 3;
+    count -= run;
+
+    if (_count == _length) {
+      memcpy(_done, _sums, sizeof(_done));
+      _done_count = _count;
+      _fresh = true;
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        _clearSums(&_sums[axis]);
+      }
+      _count = 0;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets the statistics of the last completed tumbling window, or of
+    the samples now in a sliding window
+    @param stats The statistics to fill in. All zero with `samples` 0 if
+    there is nothing to report yet.
+    @param scale Units per LSB, eg. from accelScale() or gyroScale()
+    @returns True if a tumbling window completed or a sliding window took
+    new samples since the last call
+*/
+/**************************************************************************/
+bool Adafruit_LSM6DS_Window::getStats(lsm6ds_window_stats_t *stats,
+                                      float scale) {
+  memset(stats, 0, sizeof(lsm6ds_window_stats_t));
+  bool fresh = _fresh;
+  _fresh = false;
+
+  const lsm6ds_axis_sums_t *sums = _sliding ? _sums : _done;
+  uint16_t n = _sliding ? _count : _done_count;
+  if (!n) {
+    return fresh;
+  }
+
+  stats->samples = n;
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int16_t min = sums[axis].min;
+    int16_t max = sums[axis].max;
+    if (_sliding) {
+      min = _history[_queue[0][axis][_front[0][axis]]][axis];
+      max = _history[_queue[1][axis][_front[1][axis]]][axis];
+    }
+
+    // exact in integers: n * sum_sq - sum^2 is at most 2^62
+    int64_t sum = sums[axis].sum;
+    int64_t spread = n * sums[axis].sum_sq - sum * sum;
+    stats->mean[axis] = (float)sum / n * scale;
+    stats->variance[axis] = (float)spread / ((float)n * n) * scale * scale;
+    stats->rms[axis] = sqrtf((float)sums[axis].sum_sq / n) * scale;
+    stats->min[axis] = min * scale;
+    stats->max[axis] = max * scale;
+    stats->peak_to_peak[axis] = (int32_t)(max - min) * scale;
+  }
+  return fresh;
+}
+
+/**************************************************************************/
+/*!
+    @brief Gets how many samples the window being filled holds
+    @returns The number of samples, up to the window length
+*/
+/**************************************************************************/
+uint16_t Adafruit_LSM6DS_Window::count(void) { return _count; }
+
+/**************************************************************************/
+/*!
+    @brief Adds samples to the tumbling window sums, one pass per axis
+    @param samples Packed X, Y, Z raw samples
+    @param count The number of XYZ samples, no more than the window has
+    room for
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Window::_accumulate(const int16_t *samples,
+                                         uint16_t count) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    const int16_t *v = samples + axis;
+    int32_t sum = 0;
+    int64_t sum_sq = 0;
+    int16_t min = _sums[axis].min;
+    int16_t max = _sums[axis].max;
+    for (uint16_t i = 0; i < count; i++) {
+      int32_t x = v[i * 3];
+      sum += x;
+      sum_sq += x * x;
+      min = (x < min) ? x : min;
+      max = (x > max) ? x : max;
+    }
+    _sums[axis].sum += sum;
+    _sums[axis].sum_sq += sum_sq;
+    _sums[axis].min = min;
+    _sums[axis].max = max;
+  }
+  _count += count;
+}
+
+/**************************************************************************/
+/*!
+    @brief Adds one sample to a sliding window, removing the oldest once
+    the window is full
+    @param xyz The raw X, Y and Z sample
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Window::_slide(const int16_t *xyz) {
+  bool full = (_count == _length);
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int32_t x = xyz[axis];
+    lsm6ds_axis_sums_t *sums = &_sums[axis];
+    if (full) {
+      // the sample in this slot leaves the window
+      int32_t old = _history[_slot][axis];
+      sums->sum -= old;
+      sums->sum_sq -= old * old;
+      for (uint8_t q = 0; q < 2; q++) {
+        if (_queue[q][axis][_front[q][axis]] == _slot) {
+          _front[q][axis] = (_front[q][axis] + 1) % _length;
+          _size[q][axis]--;
+        }
+      }
+    }
+    _history[_slot][axis] = x;
+    sums->sum += x;
+    sums->sum_sq += x * x;
+
+    for (uint8_t q = 0; q < 2; q++) {
+      uint8_t *queue = _queue[q][axis];
+      // drop queued samples that can no longer be the minimum (q = 0) or
+      // maximum (q = 1) now that a newer sample beats them
+      while (_size[q][axis]) {
+        uint8_t back = (_front[q][axis] + _size[q][axis] - 1) % _length;
+        int16_t queued = _history[queue[back]][axis];
+        if (q ? (queued > x) : (queued < x)) {
+          break;
+        }
+        _size[q][axis]--;
+      }
+      queue[(_front[q][axis] + _size[q][axis]) % _length] = _slot;
+      _size[q][axis]++;
+    }
+  }
+
+  _slot = (_slot + 1) % _length;
+  if (!full) {
+    _count++;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Empties one axis' sums
+    @param sums The sums to clear
+*/
+/**************************************************************************/
+void Adafruit_LSM6DS_Window::_clearSums(lsm6ds_axis_sums_t *sums) {
+  sums->sum = 0;
+  sums->sum_sq = 0;
+  sums->min = INT16_MAX;
+  sums->max = INT16_MIN;
+}
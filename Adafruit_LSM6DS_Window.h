@@ -0,0 +1,88 @@
+/*!
+ *  @file Adafruit_LSM6DS_Window.h
+ *
+ * 	Incremental per-axis statistics over tumbling or sliding windows of
+ *      raw LSM6DS samples
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	BSD license (see license.txt)
+ */
+
+#ifndef _ADAFRUIT_LSM6DS_WINDOW_H
+#define _ADAFRUIT_LSM6DS_WINDOW_H
+
+#include "Arduino.h"
+
+#ifndef LSM6DS_WINDOW_MAX_SLIDING
+#define LSM6DS_WINDOW_MAX_SLIDING                                              \
+  32 ///< Longest sliding window in samples, at most 255. Sets the history
+     ///< every window carries: 12 bytes per sample.
+#endif
+
+/** Per-axis statistics of one window, in the units of the scale given */
+typedef struct {
+  float mean[3];         ///< Average
+  float variance[3];     ///< Population variance, in units squared
+  float rms[3];          ///< Root mean square
+  float min[3];          ///< Smallest sample
+  float max[3];          ///< Largest sample
+  float peak_to_peak[3]; ///< max - min
+  uint16_t samples;      ///< Samples the statistics cover
+} lsm6ds_window_stats_t;
+
+/*!
+ *    @brief  Keeps running mean, variance, RMS, min, max and peak-to-peak
+ *            of raw XYZ samples in O(1) per sample. Sums are exact integers
+ *            on the raw LSBs, so nothing drifts however long it runs, and
+ *            scaling to units only happens in getStats(). A tumbling window
+ *            reports each completed block of samples; a sliding window
+ *            reports the latest samples at any time.
+ */
+class Adafruit_LSM6DS_Window {
+public:
+  Adafruit_LSM6DS_Window(void);
+
+  bool begin(uint16_t length, bool sliding = false);
+  void reset(void);
+
+  void push(const int16_t *xyz);
+  void process(const int16_t *samples, size_t count);
+
+  bool getStats(lsm6ds_window_stats_t *stats, float scale = 1);
+  uint16_t count(void);
+
+private:
+  /** Sums and extremes of one axis */
+  typedef struct {
+    int32_t sum;    ///< Sum of the samples
+    int64_t sum_sq; ///< Sum of the squared samples
+    int16_t min;    ///< Smallest sample
+    int16_t max;    ///< Largest sample
+  } lsm6ds_axis_sums_t;
+
+  void _accumulate(const int16_t *samples, uint16_t count);
+  void _slide(const int16_t *xyz);
+  void _clearSums(lsm6ds_axis_sums_t *sums);
+
+  lsm6ds_axis_sums_t _sums[3]; ///< Samples of the window being filled
+  lsm6ds_axis_sums_t _done[3]; ///< Last completed tumbling window
+  uint16_t _length = 0;        ///< Samples per window
+  uint16_t _count = 0;         ///< Samples in `_sums`
+  uint16_t _done_count = 0;    ///< Samples in `_done`
+  bool _sliding = false;       ///< False for tumbling windows
+  bool _fresh = false;         ///< Set when there is something new to report
+
+  //! the last `_length` samples of a sliding window, a ring
+  int16_t _history[LSM6DS_WINDOW_MAX_SLIDING][3];
+  uint8_t _slot = 0; ///< Next `_history` slot to write
+  //! per axis, `_history` slots whose values increase (min) or decrease
+  //! (max) from the front, so the front holds the window's extreme
+  uint8_t _queue[2][3][LSM6DS_WINDOW_MAX_SLIDING];
+  uint8_t _front[2][3]; ///< First used entry of each queue
+  uint8_t _size[2][3];  ///< Used entries of each queue
+};
+
+#endif
@@ -0,0 +1,97 @@
+// Vibration spectrum demo for condition monitoring with the ISM330DHCX
+// First measures how long the analyzer takes to keep up with a 6.66 kHz,
+// three axis stream, then analyzes live readings from the sensor.
+
+#include <Adafruit_ISM330DHCX.h>
+#include <Adafruit_LSM6DS_Spectrum.h>
+
+Adafruit_ISM330DHCX ism330dhcx;
+Adafruit_LSM6DS_Spectrum spectrum;
+
+// 4G range is 0.122 mg per LSB
+const float accel_scale = 0.122 * SENSORS_GRAVITY_STANDARD / 1000;
+
+void benchmark(void) {
+  const float rate = 6660;
+  int16_t block[LSM6DS_SPECTRUM_HOP * 3];
+
+  spectrum.begin(rate, accel_scale);
+  for (uint16_t i = 0; i < LSM6DS_SPECTRUM_HOP; i++) {
+    float t = i / rate;
+    block[i * 3] = 2000 * sin(2 * PI * 120 * t);
+    block[i * 3 + 1] = 500 * sin(2 * PI * 1000 * t);
+    block[i * 3 + 2] = 8192;
+  }
+
+  // one second worth of hops
+  uint16_t hops = rate / LSM6DS_SPECTRUM_HOP + 1;
+  uint32_t start = micros();
+  for (uint16_t h = 0; h < hops; h++) {
+    spectrum.push(block, LSM6DS_SPECTRUM_HOP);
+  }
+  uint32_t elapsed = micros() - start;
+
+  Serial.print("Analyzed 1 s of 6.66 kHz x 3 axis data in ");
+  Serial.print(elapsed);
+  Serial.print(" us, CPU load ");
+  Serial.print(elapsed / 10000.0);
+  Serial.println(" %");
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  Serial.println("Adafruit ISM330DHCX vibration spectrum test!");
+
+  benchmark();
+
+  if (!ism330dhcx.begin_I2C()) {
+    Serial.println("Failed to find ISM330DHCX chip");
+    while (1) {
+      delay(10);
+    }
+  }
+
+  Serial.println("ISM330DHCX Found!");
+
+  ism330dhcx.setAccelRange(LSM6DS_ACCEL_RANGE_4_G);
+  ism330dhcx.setAccelDataRate(LSM6DS_RATE_833_HZ);
+
+  spectrum.begin(ism330dhcx.accelerationSampleRate(), accel_scale);
+  spectrum.addBand(10, 100);
+  spectrum.addBand(100, 400);
+}
+
+void loop() {
+  if (!ism330dhcx.accelerationAvailable()) {
+    return;
+  }
+
+  sensors_event_t accel, gyro, temp;
+  ism330dhcx.getEvent(&accel, &gyro, &temp);
+  int16_t sample[3] = {ism330dhcx.rawAccX, ism330dhcx.rawAccY,
+                       ism330dhcx.rawAccZ};
+  spectrum.push(sample);
+
+  if (!spectrum.available()) {
+    return;
+  }
+
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    lsm6ds_spectrum_t result;
+    spectrum.getResult(axis, &result);
+    Serial.print("XYZ"[axis]);
+    Serial.print(": RMS ");
+    Serial.print(result.rms);
+    Serial.print(" crest ");
+    Serial.print(result.crest_factor);
+    Serial.print(" peak ");
+    Serial.print(result.peak_freq);
+    Serial.print(" Hz, 10-100 Hz ");
+    Serial.print(result.band_energy[0]);
+    Serial.print(" 100-400 Hz ");
+    Serial.println(result.band_energy[1]);
+  }
+}
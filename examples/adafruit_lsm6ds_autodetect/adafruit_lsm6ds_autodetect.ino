@@ -0,0 +1,49 @@
+// Starts every LSM6DS family chip found on both I2C addresses, whatever the
+// variant, reading WHOAMI only once per address
+
+#include <Adafruit_LSM6DS_AutoDetect.h>
+
+// driver storage for each address, no heap needed for the drivers
+Adafruit_LSM6DS_AutoDetect imus[2];
+const uint8_t addresses[2] = {0x6A, 0x6B};
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  Serial.println("Adafruit LSM6DS auto-detect");
+
+  for (uint8_t i = 0; i < 2; i++) {
+    // uncomment if your 0x6C chip is an LSM6DSO32 rather than an LSM6DSOX
+    // imus[i].prefer(LSM6DS_VARIANT_LSM6DSO32);
+    Serial.print("0x");
+    Serial.print(addresses[i], HEX);
+    Serial.print(": ");
+    if (imus[i].begin_I2C(addresses[i], &Wire, i * 10)) {
+      Serial.println(imus[i].variantName(imus[i].variant()));
+    } else {
+      Serial.println("nothing found");
+    }
+  }
+}
+
+void loop() {
+  sensors_event_t accel, gyro, temp;
+
+  for (uint8_t i = 0; i < 2; i++) {
+    Adafruit_LSM6DS *imu = imus[i].driver();
+    if (!imu) {
+      continue;
+    }
+    imu->getEvent(&accel, &gyro, &temp);
+
+    Serial.print(imus[i].variantName(imus[i].variant()));
+    Serial.print(" accel Z: ");
+    Serial.print(accel.acceleration.z);
+    Serial.print(" m/s^2, gyro Z: ");
+    Serial.print(gyro.gyro.z);
+    Serial.println(" rad/s");
+  }
+  delay(500);
+}
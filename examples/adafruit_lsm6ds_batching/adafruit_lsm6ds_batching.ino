@@ -0,0 +1,67 @@
+// Lets the sensor fill its FIFO while the board idles, then drains it all
+// when the watermark interrupt on INT1 fires. Replace the idle loop with
+// your board's sleep call, woken by the INT1 pin.
+
+#include <Adafruit_LSM6DSOX.h>
+
+#define INT1_PIN 2    // connect the sensor's INT1 pin here
+#define WATERMARK 256 // FIFO words to collect before waking
+#define CHUNK 8       // events per sensor handed over at a time
+
+Adafruit_LSM6DSOX lsm6ds;
+sensors_event_t accel[CHUNK], gyro[CHUNK];
+volatile bool fifo_ready = false;
+
+void onWatermark(void) { fifo_ready = true; }
+
+void printChunk(const sensors_event_t *accel, size_t accel_count,
+                const sensors_event_t *gyro, size_t gyro_count) {
+  (void)gyro;
+  Serial.print(accel_count);
+  Serial.print(" accel and ");
+  Serial.print(gyro_count);
+  Serial.print(" gyro events");
+  if (accel_count) {
+    Serial.print(", oldest accel at ");
+    Serial.print(accel[0].timestamp);
+    Serial.print(" ms, Z: ");
+    Serial.print(accel[0].acceleration.z);
+  }
+  Serial.println();
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  if (!lsm6ds.begin_I2C()) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+
+  lsm6ds.setAccelDataRate(LSM6DS_RATE_104_HZ);
+  lsm6ds.setGyroDataRate(LSM6DS_RATE_52_HZ);
+  lsm6ds.startBatching(LSM6DS_RATE_104_HZ, LSM6DS_RATE_52_HZ, WATERMARK);
+
+  pinMode(INT1_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(INT1_PIN), onWatermark, RISING);
+}
+
+void loop() {
+  if (!fifo_ready && !digitalRead(INT1_PIN)) {
+    delay(10); // sleep here
+    return;
+  }
+  fifo_ready = false;
+
+  uint32_t start = millis();
+  size_t events = lsm6ds.resumeBatch(accel, gyro, CHUNK, printChunk);
+  Serial.print("Drained ");
+  Serial.print(events);
+  Serial.print(" events in ");
+  Serial.print(millis() - start);
+  Serial.println(" ms");
+}
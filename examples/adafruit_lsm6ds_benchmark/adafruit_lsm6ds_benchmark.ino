@@ -0,0 +1,196 @@
+// Timing benchmark for the driver's hot paths
+// Prints one CSV line per operation so results can be captured from the
+// serial port and compared between library releases. Build the library with
+// LSM6DS_ENABLE_STATS set to 1 to also get data path bus transactions and
+// bytes per call. extras/host/bench_driver.cpp runs the same operations on a
+// host, for every variant, over a simulated bus.
+
+#include <Adafruit_ISM330DHCX.h>
+#include <Adafruit_LSM6DS33.h>
+#include <Adafruit_LSM6DS3TRC.h>
+#include <Adafruit_LSM6DSO32.h>
+#include <Adafruit_LSM6DSOX.h>
+
+// uncomment the variant on your board
+Adafruit_LSM6DSOX lsm6ds;
+const char *variant = "LSM6DSOX";
+// Adafruit_LSM6DS33 lsm6ds;
+// const char *variant = "LSM6DS33";
+// Adafruit_LSM6DS3TRC lsm6ds;
+// const char *variant = "LSM6DS3TRC";
+// Adafruit_LSM6DSO32 lsm6ds;
+// const char *variant = "LSM6DSO32";
+// Adafruit_ISM330DHCX lsm6ds;
+// const char *variant = "ISM330DHCX";
+
+#define ITERATIONS 200
+#if defined(__AVR__) // 2 KB of RAM on an Uno
+#define FIFO_WORDS 16 // FIFO words per readFIFO() call
+#define EVENTS 4      // events per sensor per getEvents() call
+#else
+#define FIFO_WORDS 64 // FIFO words per readFIFO() call
+#define EVENTS 32     // events per sensor per getEvents() call
+#endif
+
+// uncomment to benchmark hardware SPI at the fastest clock the wiring allows
+// #define BENCH_SPI_CS 10
+
+typedef void (*bench_fn_t)(void);
+
+// the LSM6DSO32 has its own range type
+decltype(lsm6ds.getAccelRange()) accel_range;
+
+sensors_event_t accel, gyro, temp;
+float x, y, z;
+#if LSM6DS_ENABLE_FIFO
+uint8_t fifo_buf[FIFO_WORDS * 7];
+sensors_event_t accel_events[EVENTS], gyro_events[EVENTS];
+#endif
+volatile uint32_t sink; // keeps results from being optimized away
+
+void bench(const char *op, bench_fn_t fn, uint16_t iterations) {
+#if LSM6DS_ENABLE_STATS
+  lsm6ds.resetStats();
+#endif
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < iterations; i++) {
+    fn();
+  }
+  uint32_t total = micros() - start;
+
+  Serial.print(variant);
+  Serial.print(",");
+  Serial.print(op);
+  Serial.print(",");
+  Serial.print(iterations);
+  Serial.print(",");
+  Serial.print(total);
+  Serial.print(",");
+  Serial.print((float)total / iterations);
+  Serial.print(",");
+#ifdef F_CPU
+  Serial.print((float)total / iterations * (F_CPU / 1000000.0));
+#endif
+#if LSM6DS_ENABLE_STATS
+  lsm6ds_stats_t stats;
+  lsm6ds.getStats(&stats);
+  Serial.print(",");
+  Serial.print((float)stats.transactions / iterations);
+  Serial.print(",");
+  Serial.print((float)stats.bytes / iterations);
+#endif
+  Serial.println();
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  Serial.print("variant,op,iterations,total_us,us_per_call,cycles_per_call");
+#if LSM6DS_ENABLE_STATS
+  Serial.print(",transactions_per_call,bytes_per_call");
+#endif
+  Serial.println();
+
+#ifdef BENCH_SPI_CS
+  bench("begin_SPI", []() { sink = lsm6ds.begin_SPI(BENCH_SPI_CS); }, 1);
+  if (sink) {
+    bench("setSPIFrequency", []() { sink = lsm6ds.setSPIFrequency(); }, 1);
+    Serial.print("SPI clock: ");
+    Serial.println(sink);
+  }
+#else
+  bench("begin_I2C", []() { sink = lsm6ds.begin_I2C(); }, 1);
+#endif
+  if (!sink) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+
+  accel_range = lsm6ds.getAccelRange();
+
+  bench("getEvent", []() { lsm6ds.getEvent(&accel, &gyro, &temp); },
+        ITERATIONS);
+  bench("accel.getEvent",
+        []() { lsm6ds.getAccelerometerSensor()->getEvent(&accel); },
+        ITERATIONS);
+  bench("gyro.getEvent", []() { lsm6ds.getGyroSensor()->getEvent(&gyro); },
+        ITERATIONS);
+  bench("temp.getEvent",
+        []() { lsm6ds.getTemperatureSensor()->getEvent(&temp); }, ITERATIONS);
+  bench("readAcceleration", []() { sink = lsm6ds.readAcceleration(x, y, z); },
+        ITERATIONS);
+  bench("readGyroscope", []() { sink = lsm6ds.readGyroscope(x, y, z); },
+        ITERATIONS);
+  bench("accelerationAvailable",
+        []() { sink = lsm6ds.accelerationAvailable(); }, ITERATIONS);
+  bench("gyroscopeAvailable", []() { sink = lsm6ds.gyroscopeAvailable(); },
+        ITERATIONS);
+
+  bench("getAccelDataRate", []() { sink = lsm6ds.getAccelDataRate(); },
+        ITERATIONS);
+  bench("setAccelDataRate",
+        []() { lsm6ds.setAccelDataRate(LSM6DS_RATE_104_HZ); }, ITERATIONS);
+  bench("getAccelRange", []() { sink = lsm6ds.getAccelRange(); }, ITERATIONS);
+  bench("setAccelRange", []() { lsm6ds.setAccelRange(accel_range); },
+        ITERATIONS);
+  bench("getGyroDataRate", []() { sink = lsm6ds.getGyroDataRate(); },
+        ITERATIONS);
+  bench("setGyroDataRate", []() { lsm6ds.setGyroDataRate(LSM6DS_RATE_104_HZ); },
+        ITERATIONS);
+  bench("getGyroRange", []() { sink = lsm6ds.getGyroRange(); }, ITERATIONS);
+  bench("setGyroRange",
+        []() { lsm6ds.setGyroRange(LSM6DS_GYRO_RANGE_2000_DPS); }, ITERATIONS);
+  bench("accelerationSampleRate",
+        []() { sink = lsm6ds.accelerationSampleRate(); }, ITERATIONS);
+  bench("gyroscopeSampleRate", []() { sink = lsm6ds.gyroscopeSampleRate(); },
+        ITERATIONS);
+#if LSM6DS_ENABLE_FILTERS
+  bench("highPassFilter",
+        []() { lsm6ds.highPassFilter(false, LSM6DS_HPF_ODR_DIV_100); },
+        ITERATIONS);
+#endif
+  bench("configInt1",
+        []() { lsm6ds.configInt1(false, false, false); }, ITERATIONS);
+  bench("configInt2",
+        []() { lsm6ds.configInt2(false, false, false); }, ITERATIONS);
+#if LSM6DS_ENABLE_EVENTS
+  bench("awake", []() { sink = lsm6ds.awake(); }, ITERATIONS);
+  bench("shake", []() { sink = lsm6ds.shake(); }, ITERATIONS);
+  bench("readPedometer", []() { sink = lsm6ds.readPedometer(); }, ITERATIONS);
+#endif
+
+#if LSM6DS_ENABLE_FIFO
+  // batch both sensors at the data rate, let the FIFO fill, then compare
+  // one burst per FIFO_WORDS words against one read per sample
+  lsm6ds.configFIFO(LSM6DS_FIFO_CONTINUOUS, LSM6DS_RATE_104_HZ,
+                    LSM6DS_RATE_104_HZ);
+  delay(1000);
+  bench("fifoLevel", []() { sink = lsm6ds.fifoLevel(); }, ITERATIONS);
+  bench("readFIFO", []() { sink = lsm6ds.readFIFO(fifo_buf, FIFO_WORDS); },
+        1);
+  Serial.print("FIFO words read: ");
+  Serial.println(sink);
+  lsm6ds.prepareEvents(accel_events, gyro_events, EVENTS);
+  delay(1000);
+  bench("getEvents",
+        []() {
+          size_t accel_count = EVENTS, gyro_count = EVENTS;
+          lsm6ds.getEvents(accel_events, &accel_count, gyro_events,
+                           &gyro_count);
+          sink = accel_count + gyro_count;
+        },
+        1);
+  Serial.print("Events read: ");
+  Serial.println(sink);
+  lsm6ds.configFIFO(LSM6DS_FIFO_BYPASS, LSM6DS_RATE_SHUTDOWN,
+                    LSM6DS_RATE_SHUTDOWN);
+#endif
+
+  Serial.println("done");
+}
+
+void loop() {}
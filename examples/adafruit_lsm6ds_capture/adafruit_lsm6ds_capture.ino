@@ -0,0 +1,56 @@
+// Records acceleration continuously into a ring, and when the chip's
+// wake-up (motion) detector fires, prints the 0.5 seconds before and the
+// 1 second after it instead of logging everything
+
+#include <Adafruit_LSM6DS33.h>
+#include <Adafruit_LSM6DS_Capture.h>
+
+#define PRE 52   // samples before the event, at 104 Hz
+#define POST 104 // samples from the event on
+
+Adafruit_LSM6DS33 lsm6ds;
+Adafruit_LSM6DS_Capture capture;
+lsm6ds_capture_sample_t samples[PRE + POST];
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  if (!lsm6ds.begin_I2C()) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+  lsm6ds.setAccelDataRate(LSM6DS_RATE_104_HZ);
+  lsm6ds.enableWakeup(true);
+
+  capture.begin(samples, PRE + POST, PRE, POST);
+  lsm6ds.attachCaptures(&capture, NULL, LSM6DS_EVENT_WAKEUP);
+}
+
+void loop() {
+  if (lsm6ds.accelerationAvailable()) {
+    sensors_event_t accel, gyro, temp;
+    lsm6ds.getEvent(&accel, &gyro, &temp); // records into the capture
+  }
+  lsm6ds.pollEvents(); // triggers it on wake-up
+
+  if (capture.state() != LSM6DS_CAPTURE_DONE) {
+    return;
+  }
+
+  Serial.println("ms from event, X, Y, Z (m/s^2)");
+  float scale = lsm6ds.accelScale();
+  for (uint16_t i = 0; i < capture.count(); i++) {
+    const lsm6ds_capture_sample_t *sample = capture.sample(i);
+    Serial.print(sample->timestamp - capture.triggerTime());
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      Serial.print(", ");
+      Serial.print(sample->data[axis] * scale);
+    }
+    Serial.println();
+  }
+  capture.rearm();
+}
@@ -0,0 +1,59 @@
+// Streams tagged FIFO words straight into a ring buffer and decodes them in
+// place, so the driver never copies a sample through its own buffers
+
+#include <Adafruit_LSM6DSOX.h>
+#include <Adafruit_LSM6DS_FIFODecoder.h>
+#include <Adafruit_LSM6DS_FIFORing.h>
+
+#define RING_WORDS 128 // FIFO words the ring holds, 7 bytes each
+
+Adafruit_LSM6DSOX lsm6ds;
+Adafruit_LSM6DS_FIFORing ring;
+Adafruit_LSM6DS_FIFODecoder decoder;
+uint8_t ring_memory[RING_WORDS * LSM6DS_FIFO_TAGGED_WORD];
+uint32_t accel_samples = 0;
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  if (!lsm6ds.begin_I2C()) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+
+  lsm6ds.setAccelDataRate(LSM6DS_RATE_416_HZ);
+  lsm6ds.setGyroDataRate(LSM6DS_RATE_416_HZ);
+  lsm6ds.configFIFO(LSM6DS_FIFO_CONTINUOUS, LSM6DS_RATE_416_HZ,
+                    LSM6DS_RATE_416_HZ);
+  ring.begin(ring_memory, sizeof(ring_memory), lsm6ds.fifoWordSize());
+}
+
+void loop() {
+  lsm6ds.drainFIFO(&ring);
+
+  lsm6ds_fifo_view_t view;
+  size_t words = ring.peek(&view);
+  for (uint8_t run = 0; run < 2; run++) {
+    for (size_t i = 0; i < view.words[run]; i++) {
+      lsm6ds_fifo_sample_t samples[LSM6DS_FIFO_MAX_SAMPLES];
+      const uint8_t *word = view.data[run] + i * LSM6DS_FIFO_TAGGED_WORD;
+      uint8_t count = decoder.decodeWord(word, samples);
+      for (uint8_t s = 0; s < count; s++) {
+        if ((samples[s].tag != LSM6DS_FIFO_TAG_ACCEL_NC) ||
+            (++accel_samples % 416)) {
+          continue;
+        }
+        // once a second
+        Serial.print("accel Z: ");
+        Serial.print(samples[s].data[2] * lsm6ds.accelScale());
+        Serial.print(" m/s^2, ring words waiting: ");
+        Serial.println(words);
+      }
+    }
+  }
+  ring.release(words);
+}
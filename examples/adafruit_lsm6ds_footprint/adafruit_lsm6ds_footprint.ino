@@ -0,0 +1,74 @@
+// Reports the RAM each sensor instance needs with the current build options
+// To try the lean profile, add -DLSM6DS_LEAN=1 to the compiler flags (or
+// define it at the top of Adafruit_LSM6DS.h), then turn single features back
+// on with eg. -DLSM6DS_ENABLE_FIFO=1. The flash size is the "Sketch uses"
+// figure the Arduino build prints; compare it between the two profiles.
+
+#include <Adafruit_ISM330DHCX.h>
+#include <Adafruit_LSM6DS33.h>
+#include <Adafruit_LSM6DS3TRC.h>
+#include <Adafruit_LSM6DSO32.h>
+#include <Adafruit_LSM6DSOX.h>
+
+Adafruit_LSM6DSOX lsm6ds;
+
+void printOption(const char *name, bool enabled) {
+  Serial.print(name);
+  Serial.println(enabled ? ": on" : ": off");
+}
+
+void printSize(const char *name, size_t size) {
+  Serial.print("sizeof(");
+  Serial.print(name);
+  Serial.print("): ");
+  Serial.print(size);
+  Serial.println(" bytes");
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  Serial.println("Adafruit LSM6DS footprint");
+  printOption("LSM6DS_LEAN", LSM6DS_LEAN);
+  printOption("LSM6DS_ENABLE_FLOAT_CACHE", LSM6DS_ENABLE_FLOAT_CACHE);
+  printOption("LSM6DS_ENABLE_EVENTS", LSM6DS_ENABLE_EVENTS);
+  printOption("LSM6DS_ENABLE_FILTERS", LSM6DS_ENABLE_FILTERS);
+  printOption("LSM6DS_ENABLE_FIFO", LSM6DS_ENABLE_FIFO);
+  printOption("LSM6DS_ENABLE_WINDOWS", LSM6DS_ENABLE_WINDOWS);
+  printOption("LSM6DS_ENABLE_CAPTURE", LSM6DS_ENABLE_CAPTURE);
+  printOption("LSM6DS_ENABLE_TEMP_COMP", LSM6DS_ENABLE_TEMP_COMP);
+  printOption("LSM6DS_ENABLE_STATS", LSM6DS_ENABLE_STATS);
+
+  printSize("Adafruit_LSM6DS33", sizeof(Adafruit_LSM6DS33));
+  printSize("Adafruit_LSM6DS3TRC", sizeof(Adafruit_LSM6DS3TRC));
+  printSize("Adafruit_LSM6DSOX", sizeof(Adafruit_LSM6DSOX));
+  printSize("Adafruit_LSM6DSO32", sizeof(Adafruit_LSM6DSO32));
+  printSize("Adafruit_ISM330DHCX", sizeof(Adafruit_ISM330DHCX));
+  // the Unified Sensor adapters are only allocated on first use
+  Serial.print("Heap per adapter: ");
+  Serial.print(sizeof(Adafruit_LSM6DS_Accelerometer));
+  Serial.println(" bytes");
+
+  if (!lsm6ds.begin_I2C()) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+}
+
+void loop() {
+  sensors_event_t accel, gyro, temp;
+  lsm6ds.getEvent(&accel, &gyro, &temp);
+
+  Serial.print("Accel X: ");
+  Serial.print(accel.acceleration.x);
+  Serial.print(" Y: ");
+  Serial.print(accel.acceleration.y);
+  Serial.print(" Z: ");
+  Serial.print(accel.acceleration.z);
+  Serial.println(" m/s^2");
+  delay(500);
+}
@@ -0,0 +1,64 @@
+// Runs the gyro fast and the accelerometer slow to save power, then merges
+// both FIFO streams into synchronous accel + gyro pairs at one output rate
+
+#include <Adafruit_LSM6DSOX.h>
+#include <Adafruit_LSM6DS_Resampler.h>
+
+#define CHUNK 8 // events per sensor read from the FIFO at a time
+
+Adafruit_LSM6DSOX lsm6ds;
+Adafruit_LSM6DS_Resampler resampler;
+sensors_event_t accel[CHUNK], gyro[CHUNK];
+uint16_t fused = 0;
+
+void onSample(const sensors_event_t *accel, const sensors_event_t *gyro) {
+  // print one in 52 pairs to keep the serial port up
+  if (++fused % 52) {
+    return;
+  }
+  Serial.print(accel->timestamp);
+  Serial.print(" ms  accel Z: ");
+  Serial.print(accel->acceleration.z);
+  Serial.print(" m/s^2  gyro Z: ");
+  Serial.print(gyro->gyro.z);
+  Serial.println(" rad/s");
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  if (!lsm6ds.begin_I2C()) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+
+  lsm6ds.setAccelDataRate(LSM6DS_RATE_104_HZ);
+  lsm6ds.setGyroDataRate(LSM6DS_RATE_833_HZ);
+  lsm6ds.configFIFO(LSM6DS_FIFO_CONTINUOUS, LSM6DS_RATE_104_HZ,
+                    LSM6DS_RATE_833_HZ);
+  lsm6ds.prepareEvents(accel, gyro, CHUNK); // getEvents() fills in the rest
+
+  // pairs at 208 Hz, the accelerometer interpolated between its samples
+  resampler.setRates(lsm6ds.accelerationSampleRate(),
+                     lsm6ds.gyroscopeSampleRate(), 208);
+  resampler.setCallback(onSample);
+}
+
+void loop() {
+  size_t accel_count, gyro_count;
+  do {
+    accel_count = gyro_count = CHUNK; // the room in each array
+    if (!lsm6ds.getEvents(accel, &accel_count, gyro, &gyro_count)) {
+      Serial.println("FIFO read failed");
+      resampler.reset();
+      break;
+    }
+    resampler.push(accel, accel_count, gyro, gyro_count);
+  } while (accel_count || gyro_count);
+
+  delay(20);
+}
@@ -0,0 +1,52 @@
+// Condition monitoring: per-axis RMS and peak-to-peak acceleration over
+// one second tumbling windows, plus a sliding window of the latest gyro
+// samples, all updated as readings arrive instead of re-scanning buffers
+
+#include <Adafruit_LSM6DS33.h>
+#include <Adafruit_LSM6DS_Window.h>
+
+Adafruit_LSM6DS33 lsm6ds;
+Adafruit_LSM6DS_Window vibration, rotation;
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // will pause Zero, Leonardo, etc until serial console opens
+
+  if (!lsm6ds.begin_I2C()) {
+    Serial.println("Failed to find LSM6DS chip");
+    while (1) {
+      delay(10);
+    }
+  }
+  lsm6ds.setAccelDataRate(LSM6DS_RATE_104_HZ);
+  lsm6ds.setGyroDataRate(LSM6DS_RATE_104_HZ);
+
+  vibration.begin(104);     // one second of accelerometer samples
+  rotation.begin(16, true); // the latest 16 gyro samples
+  lsm6ds.attachWindows(&vibration, &rotation);
+}
+
+void loop() {
+  if (!lsm6ds.accelerationAvailable()) {
+    return;
+  }
+  sensors_event_t accel, gyro, temp;
+  lsm6ds.getEvent(&accel, &gyro, &temp); // feeds both windows
+
+  lsm6ds_window_stats_t stats;
+  if (!vibration.getStats(&stats, lsm6ds.accelScale())) {
+    return;
+  }
+  Serial.print("RMS X/Y/Z: ");
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    Serial.print(stats.rms[axis]);
+    Serial.print(axis < 2 ? ", " : " m/s^2  p-p Z: ");
+  }
+  Serial.print(stats.peak_to_peak[2]);
+
+  rotation.getStats(&stats, lsm6ds.gyroScale());
+  Serial.print(" m/s^2  gyro Z std dev: ");
+  Serial.print(sqrt(stats.variance[2]));
+  Serial.println(" rad/s");
+}
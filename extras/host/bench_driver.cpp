@@ -0,0 +1,216 @@
+/*!
+ *  @file bench_driver.cpp
+ *  Host benchmark of the driver's hot paths for every chip variant
+ *
+ *  Each variant runs over an Adafruit_LSM6DS_FakeBus, so the numbers are
+ *  the driver's own CPU cost and bus traffic with no wire time. Prints one
+ *  CSV line per operation. The same operations run on hardware in the
+ *  adafruit_lsm6ds_benchmark example.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_ISM330DHCX.h"
+#include "Adafruit_LSM6DS3.h"
+#include "Adafruit_LSM6DS33.h"
+#include "Adafruit_LSM6DS3TRC.h"
+#include "Adafruit_LSM6DSL.h"
+#include "Adafruit_LSM6DSO32.h"
+#include "Adafruit_LSM6DSOX.h"
+#include <chrono>
+
+#define ITERATIONS 100000     ///< Calls timed per operation
+#define BEGIN_ITERATIONS 2000 ///< Calls timed for begin_Bus()
+#define FIFO_WORDS 64         ///< FIFO words the fake reports waiting
+#define EVENTS 32             ///< Events per sensor per getEvents() call
+
+/*!
+ *    @brief  A fake sensor that also counts the bytes moved
+ */
+class bench_bus : public Adafruit_LSM6DS_FakeBus {
+public:
+  /*!  @brief  Instantiates a fake sensor
+   *   @param  chip_id The value to report from WHOAMI */
+  bench_bus(uint8_t chip_id) : Adafruit_LSM6DS_FakeBus(chip_id) {}
+
+  /*!  @brief  Counts and reads registers
+   *   @param  reg The first register address
+   *   @param  buffer Buffer to hold the register values
+   *   @param  len The number of registers to read
+   *   @returns True */
+  bool read(uint8_t reg, uint8_t *buffer, size_t len) {
+    bytes += len;
+    return Adafruit_LSM6DS_FakeBus::read(reg, buffer, len);
+  }
+  /*!  @brief  Counts and writes registers
+   *   @param  reg The first register address
+   *   @param  buffer The register values to write
+   *   @param  len The number of registers to write
+   *   @returns True */
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len) {
+    bytes += len;
+    return Adafruit_LSM6DS_FakeBus::write(reg, buffer, len);
+  }
+
+  uint64_t bytes = 0; ///< Data bytes moved, not counting addresses
+};
+
+/*!
+ *    @brief  A cycle count, where the CPU has a cheap one to read
+ *    @returns The x86 time stamp counter, or 0
+ */
+static inline uint64_t cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+
+volatile uint32_t sink; ///< Keeps results from being optimized away
+
+/*!
+ *    @brief  Times an operation and prints its CSV line
+ *    @param  variant The chip variant
+ *    @param  op The operation's name
+ *    @param  bus The fake sensor, for its counters
+ *    @param  iterations The number of calls to time
+ *    @param  fn The operation
+ */
+template <typename F>
+static void bench(const char *variant, const char *op, bench_bus *bus,
+                  uint32_t iterations, F fn) {
+  uint32_t transfers = bus->transfers;
+  uint64_t bytes = bus->bytes;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  uint64_t start_cycles = cycles();
+  for (uint32_t i = 0; i < iterations; i++) {
+    fn();
+  }
+  uint64_t used_cycles = cycles() - start_cycles;
+  double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+
+  printf("%s,%s,%u,%.1f,", variant, op, iterations, ns / iterations);
+  if (used_cycles) {
+    printf("%.0f", (double)used_cycles / iterations);
+  }
+  printf(",%.3f,%.2f\n", (double)(bus->transfers - transfers) / iterations,
+         (double)(bus->bytes - bytes) / iterations);
+}
+
+/*!
+ *    @brief  Runs every operation on one chip variant
+ *    @param  variant The variant's name
+ *    @param  chip_id The variant's WHOAMI value
+ */
+template <typename T>
+static void bench_variant(const char *variant, uint8_t chip_id) {
+  static T lsm6ds;
+  static bench_bus bus(chip_id);
+  static sensors_event_t accel, gyro, temp;
+  static float x, y, z;
+
+  bench(variant, "begin_Bus", &bus, BEGIN_ITERATIONS,
+        [] { sink = lsm6ds.begin_Bus(&bus); });
+  if (!lsm6ds.begin_Bus(&bus)) {
+    printf("%s,begin_Bus failed\n", variant);
+    return;
+  }
+
+  bench(variant, "readRaw", &bus, ITERATIONS,
+        [] { sink = lsm6ds.readRaw(); });
+  bench(variant, "getEvent", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getEvent(&accel, &gyro, &temp); });
+  bench(variant, "accel.getEvent", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getAccelerometerSensor()->getEvent(&accel); });
+  bench(variant, "gyro.getEvent", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getGyroSensor()->getEvent(&gyro); });
+  bench(variant, "temp.getEvent", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getTemperatureSensor()->getEvent(&temp); });
+  bench(variant, "readAcceleration", &bus, ITERATIONS,
+        [] { sink = lsm6ds.readAcceleration(x, y, z); });
+  bench(variant, "readGyroscope", &bus, ITERATIONS,
+        [] { sink = lsm6ds.readGyroscope(x, y, z); });
+  bench(variant, "accelerationAvailable", &bus, ITERATIONS,
+        [] { sink = lsm6ds.accelerationAvailable(); });
+  bench(variant, "gyroscopeAvailable", &bus, ITERATIONS,
+        [] { sink = lsm6ds.gyroscopeAvailable(); });
+
+  // the LSM6DSO32 has its own range type
+  static decltype(lsm6ds.getAccelRange()) accel_range;
+  accel_range = lsm6ds.getAccelRange();
+  bench(variant, "getAccelDataRate", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getAccelDataRate(); });
+  bench(variant, "setAccelDataRate", &bus, ITERATIONS,
+        [] { lsm6ds.setAccelDataRate(LSM6DS_RATE_104_HZ); });
+  bench(variant, "getAccelRange", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getAccelRange(); });
+  bench(variant, "setAccelRange", &bus, ITERATIONS,
+        [] { lsm6ds.setAccelRange(accel_range); });
+  bench(variant, "getGyroDataRate", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getGyroDataRate(); });
+  bench(variant, "setGyroDataRate", &bus, ITERATIONS,
+        [] { lsm6ds.setGyroDataRate(LSM6DS_RATE_104_HZ); });
+  bench(variant, "getGyroRange", &bus, ITERATIONS,
+        [] { sink = lsm6ds.getGyroRange(); });
+  bench(variant, "setGyroRange", &bus, ITERATIONS,
+        [] { lsm6ds.setGyroRange(LSM6DS_GYRO_RANGE_2000_DPS); });
+  bench(variant, "accelerationSampleRate", &bus, ITERATIONS,
+        [] { sink = lsm6ds.accelerationSampleRate(); });
+  bench(variant, "gyroscopeSampleRate", &bus, ITERATIONS,
+        [] { sink = lsm6ds.gyroscopeSampleRate(); });
+#if LSM6DS_ENABLE_FILTERS
+  bench(variant, "highPassFilter", &bus, ITERATIONS,
+        [] { lsm6ds.highPassFilter(false, LSM6DS_HPF_ODR_DIV_100); });
+#endif
+  bench(variant, "configInt1", &bus, ITERATIONS,
+        [] { lsm6ds.configInt1(false, false, false); });
+  bench(variant, "configInt2", &bus, ITERATIONS,
+        [] { lsm6ds.configInt2(false, false, false); });
+#if LSM6DS_ENABLE_EVENTS
+  bench(variant, "awake", &bus, ITERATIONS, [] { sink = lsm6ds.awake(); });
+  bench(variant, "shake", &bus, ITERATIONS, [] { sink = lsm6ds.shake(); });
+  bench(variant, "readPedometer", &bus, ITERATIONS,
+        [] { sink = lsm6ds.readPedometer(); });
+#endif
+
+#if LSM6DS_ENABLE_FIFO
+  static uint8_t fifo_buf[FIFO_WORDS * 7];
+  static sensors_event_t accel_events[EVENTS], gyro_events[EVENTS];
+  lsm6ds.configFIFO(LSM6DS_FIFO_CONTINUOUS, LSM6DS_RATE_104_HZ,
+                    LSM6DS_RATE_104_HZ);
+  bus.regs[LSM6DS_FIFO_STATUS1] = FIFO_WORDS; // the fake FIFO never drains
+  bench(variant, "fifoLevel", &bus, ITERATIONS,
+        [] { sink = lsm6ds.fifoLevel(); });
+  bench(variant, "readFIFO", &bus, ITERATIONS / 10,
+        [] { sink = lsm6ds.readFIFO(fifo_buf, FIFO_WORDS); });
+  lsm6ds.prepareEvents(accel_events, gyro_events, EVENTS);
+  bench(variant, "getEvents", &bus, ITERATIONS / 10, [] {
+    size_t accel_count = EVENTS, gyro_count = EVENTS;
+    lsm6ds.getEvents(accel_events, &accel_count, gyro_events, &gyro_count);
+    sink = accel_count + gyro_count;
+  });
+  lsm6ds.configFIFO(LSM6DS_FIFO_BYPASS, LSM6DS_RATE_SHUTDOWN,
+                    LSM6DS_RATE_SHUTDOWN);
+#endif
+}
+
+/*!
+ *    @brief  Runs the benchmark on every variant
+ *    @returns 0
+ */
+int main(void) {
+  printf("variant,op,iterations,ns_per_call,cycles_per_call,"
+         "transactions_per_call,bytes_per_call\n");
+  bench_variant<Adafruit_LSM6DS3>("LSM6DS3", LSM6DS3_CHIP_ID);
+  bench_variant<Adafruit_LSM6DS33>("LSM6DS33", LSM6DS33_CHIP_ID);
+  bench_variant<Adafruit_LSM6DS3TRC>("LSM6DS3TRC", LSM6DS3TRC_CHIP_ID);
+  bench_variant<Adafruit_LSM6DSL>("LSM6DSL", LSM6DSL_CHIP_ID);
+  bench_variant<Adafruit_LSM6DSOX>("LSM6DSOX", LSM6DSOX_CHIP_ID);
+  bench_variant<Adafruit_LSM6DSO32>("LSM6DSO32", LSM6DSO32_CHIP_ID);
+  bench_variant<Adafruit_ISM330DHCX>("ISM330DHCX", ISM330DHCX_CHIP_ID);
+  return 0;
+}
@@ -0,0 +1,194 @@
+/*!
+ *  @file bench_pipeline.cpp
+ *  Host benchmark of Adafruit_LSM6DS_Pipeline draining many LSM6DSOX
+ *  sensors on shared, simulated SPI buses
+ *
+ *  Every sensor always reports a full FIFO, so the buses are the limit
+ *  unless the processing stage is. Each bus takes 0.8 us per byte, 10 MHz
+ *  SPI, and a bus thread sleeps off that time as it accumulates. Each run
+ *  prints one CSV line: the words read, processed and dropped per second,
+ *  the pipeline's stall and queue counters, and how busy the buses were.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DSOX.h"
+#include "Adafruit_LSM6DS_Pipeline.h"
+#include <chrono>
+
+#define SENSORS 8         ///< Sensors in the pipeline
+#define BUSES 2           ///< Buses the sensors are spread over
+#define BYTE_NS 800       ///< Wire time per byte, 10 MHz SPI
+#define SLEEP_NS 100000   ///< Wire time a bus thread owes before it sleeps
+#define BLOCKS 32         ///< Block buffers in the pipeline
+#define RUN_MS 500        ///< Length of each run
+#define LIGHT_PASSES 1    ///< Hash passes over a block, light stage
+#define HEAVY_PASSES 1000 ///< Hash passes over a block, CPU-bound stage
+
+typedef std::chrono::steady_clock bench_clock; ///< The benchmark's clock
+
+/** A simulated bus shared by several sensors, only used by its bus thread */
+typedef struct {
+  int64_t owed_ns; ///< Wire time not yet slept off, negative after oversleep
+  uint64_t bytes;  ///< Bytes moved, address bytes included
+} sim_wire_t;
+
+/*!
+ *    @brief  An LSM6DSOX with a full FIFO, on a simulated bus
+ */
+class pipeline_bus : public Adafruit_LSM6DS_FakeBus {
+public:
+  pipeline_bus(void) : Adafruit_LSM6DS_FakeBus(LSM6DSOX_CHIP_ID) {}
+
+  /*!  @brief  Reads registers, taking the wire time
+   *   @param  reg The first register address
+   *   @param  buffer Buffer to hold the register values
+   *   @param  len The number of registers to read
+   *   @returns True */
+  bool read(uint8_t reg, uint8_t *buffer, size_t len) {
+    take(len);
+    return Adafruit_LSM6DS_FakeBus::read(reg, buffer, len);
+  }
+  /*!  @brief  Writes registers, taking the wire time
+   *   @param  reg The first register address
+   *   @param  buffer The register values to write
+   *   @param  len The number of registers to write
+   *   @returns True */
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len) {
+    take(len);
+    return Adafruit_LSM6DS_FakeBus::write(reg, buffer, len);
+  }
+
+  sim_wire_t *wire = NULL; ///< The bus this sensor is on, NULL while idle
+
+private:
+  /*!  @brief  Charges one transfer to the bus, sleeping once enough wire
+   *           time is owed that the sleep will be close to accurate
+   *   @param  len Data bytes in the transfer */
+  void take(size_t len) {
+    if (!wire) {
+      return;
+    }
+    wire->bytes += len + 1;
+    wire->owed_ns += (len + 1) * BYTE_NS;
+    if (wire->owed_ns < SLEEP_NS) {
+      return;
+    }
+    bench_clock::time_point start = bench_clock::now();
+    std::this_thread::sleep_for(std::chrono::nanoseconds(wire->owed_ns));
+    wire->owed_ns -= std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         bench_clock::now() - start)
+                         .count();
+  }
+};
+
+/** A stage's settings and its results */
+typedef struct {
+  uint32_t passes;             ///< Hash passes over each block
+  std::atomic<uint64_t> words; ///< FIFO words processed
+  std::atomic<uint32_t> hash;  ///< Folded hashes, so the work is kept
+} stage_t;
+
+/*!
+ *    @brief  The processing stage: FNV-1a over the block, `passes` times
+ *    @param  block The block
+ *    @param  context The stage_t
+ */
+static void hash_stage(lsm6ds_block_t *block, void *context) {
+  stage_t *stage = (stage_t *)context;
+  size_t len = block->words * block->word_size;
+  uint32_t hash = 2166136261u;
+  for (uint32_t p = 0; p < stage->passes; p++) {
+    for (size_t i = 0; i < len; i++) {
+      hash = (hash ^ block->data[i]) * 16777619u;
+    }
+  }
+  stage->hash ^= hash;
+  stage->words += block->words;
+}
+
+static pipeline_bus buses[SENSORS];        ///< The simulated sensors
+static Adafruit_LSM6DSOX sensors[SENSORS]; ///< Their drivers
+static sim_wire_t wires[BUSES];            ///< The simulated buses
+
+/*!
+ *    @brief  Runs one pipeline configuration and prints its CSV line
+ *    @param  name The stage's name
+ *    @param  passes Hash passes over each block
+ *    @param  workers Worker threads
+ *    @param  drop Drop blocks instead of waiting when none is free
+ *    @returns False if the pipeline lost or invented words
+ */
+static bool run(const char *name, uint32_t passes, unsigned int workers,
+                bool drop) {
+  static stage_t stage;
+  stage.passes = passes;
+  stage.words = 0;
+  for (int b = 0; b < BUSES; b++) {
+    wires[b].owed_ns = 0;
+    wires[b].bytes = 0;
+  }
+
+  Adafruit_LSM6DS_Pipeline pipeline(BLOCKS);
+  for (int s = 0; s < SENSORS; s++) {
+    pipeline.addSensor(&sensors[s], s % BUSES);
+  }
+  pipeline.addStage(hash_stage, &stage);
+  pipeline.setDropWhenFull(drop);
+
+  bench_clock::time_point start = bench_clock::now();
+  if (!pipeline.start(workers)) {
+    printf("start failed\n");
+    return false;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+  pipeline.stop();
+  double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+  lsm6ds_pipeline_stats_t stats;
+  pipeline.getStats(&stats);
+  uint64_t bytes = 0;
+  for (int b = 0; b < BUSES; b++) {
+    bytes += wires[b].bytes;
+  }
+  printf("%s,%u,%d,%.0f,%.0f,%.0f,%llu,%u,%.1f\n", name, workers, drop,
+         (stats.words + stats.dropped_words) / s, stage.words / s,
+         stats.dropped_words / s, (unsigned long long)stats.stalls,
+         stats.max_queued, 100.0 * bytes * BYTE_NS / 1e9 / s / BUSES);
+  return stage.words == stats.words;
+}
+
+/*!
+ *    @brief  Runs every configuration
+ *    @returns 0, or 1 if a sensor didn't start or words went missing
+ */
+int main(void) {
+  for (int s = 0; s < SENSORS; s++) {
+    if (!sensors[s].begin_Bus(&buses[s])) {
+      printf("begin_Bus failed\n");
+      return 1;
+    }
+    sensors[s].configFIFO(LSM6DS_FIFO_CONTINUOUS, LSM6DS_RATE_6_66K_HZ,
+                          LSM6DS_RATE_6_66K_HZ);
+    buses[s].regs[LSM6DSOX_FIFO_STATUS1] = 0xFF; // 511 words, never drains
+    buses[s].regs[LSM6DSOX_FIFO_STATUS1 + 1] = 0x01;
+    buses[s].wire = &wires[s % BUSES];
+  }
+
+  printf("stage,workers,drop,read_words_per_s,processed_words_per_s,"
+         "dropped_words_per_s,stalls,max_queued,bus_busy_pct\n");
+  const unsigned int workers[] = {1, 2, 4};
+  bool ok = true;
+  for (int heavy = 0; heavy < 2; heavy++) {
+    for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+      for (int drop = 0; drop < 2; drop++) {
+        ok &= run(heavy ? "heavy" : "light",
+                  heavy ? HEAVY_PASSES : LIGHT_PASSES, workers[w], drop);
+      }
+    }
+  }
+  if (!ok) {
+    printf("processed words don't match the pipeline's count\n");
+  }
+  return ok ? 0 : 1;
+}
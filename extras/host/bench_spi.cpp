@@ -0,0 +1,173 @@
+/*!
+ *  @file bench_spi.cpp
+ *  Host benchmark of per-sample CPU cost and bus time when reading an
+ *  LSM6DSOX over SPI, sample by sample or in full-FIFO bursts
+ *
+ *  The simulated bus answers like the chip: the FIFO output registers
+ *  hand out tagged words and roll back after each one, and the status
+ *  registers always report a full FIFO. Every register transfer is one
+ *  chip-select window of an address byte plus the data, which gives the
+ *  wire time at a given clock. Prints one CSV line per read method.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DSOX.h"
+#include "Adafruit_LSM6DS_FIFODecoder.h"
+#include <chrono>
+#include <string.h>
+
+#define FIFO_SLOTS 256   ///< Accel and gyro pairs in the FIFO stream
+#define FIFO_WORDS 511   ///< Words reported waiting, a full FIFO
+#define SETS 1000000     ///< Accel and gyro pairs read per method
+#define EVENTS 256       ///< Events per sensor per getEvents() call
+#define SLOW_HZ 1000000  ///< begin_SPI()'s default clock
+#define FAST_HZ 10000000 ///< The chips' fastest SPI clock
+
+/*!
+ *    @brief  An LSM6DSOX on a simulated SPI bus
+ */
+class spi_sim_bus : public Adafruit_LSM6DS_FakeBus {
+public:
+  /*!  @brief  Fills the FIFO stream with accel and gyro words */
+  spi_sim_bus(void) : Adafruit_LSM6DS_FakeBus(LSM6DSOX_CHIP_ID) {
+    for (int slot = 0; slot < FIFO_SLOTS; slot++) {
+      for (int s = 0; s < 2; s++) {
+        uint8_t *word = fifo + (slot * 2 + s) * LSM6DS_FIFO_TAGGED_WORD;
+        uint8_t tag = s ? LSM6DS_FIFO_TAG_GYRO_NC : LSM6DS_FIFO_TAG_ACCEL_NC;
+        word[0] = tag << 3 | (slot & 0x03) << 1;
+        for (int i = 1; i < LSM6DS_FIFO_TAGGED_WORD; i++) {
+          word[i] = (uint8_t)(slot * 13 + i);
+        }
+      }
+    }
+    regs[LSM6DSOX_FIFO_STATUS1] = FIFO_WORDS & 0xFF;
+    regs[LSM6DSOX_FIFO_STATUS1 + 1] = FIFO_WORDS >> 8;
+  }
+
+  /*!  @brief  Reads registers in one chip-select window
+   *   @param  reg The first register address
+   *   @param  buffer Buffer to hold the register values
+   *   @param  len The number of registers to read
+   *   @returns True */
+  bool read(uint8_t reg, uint8_t *buffer, size_t len) {
+    bytes += len + 1;
+    if (reg != LSM6DSOX_FIFO_DATA_OUT_TAG) {
+      return Adafruit_LSM6DS_FakeBus::read(reg, buffer, len);
+    }
+    transfers++;
+    while (len) {
+      size_t run = sizeof(fifo) - pos < len ? sizeof(fifo) - pos : len;
+      memcpy(buffer, fifo + pos, run);
+      buffer += run;
+      len -= run;
+      pos = (pos + run) % sizeof(fifo);
+    }
+    return true;
+  }
+  /*!  @brief  Writes registers in one chip-select window
+   *   @param  reg The first register address
+   *   @param  buffer The register values to write
+   *   @param  len The number of registers to write
+   *   @returns True */
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len) {
+    bytes += len + 1;
+    return Adafruit_LSM6DS_FakeBus::write(reg, buffer, len);
+  }
+
+  uint8_t fifo[FIFO_SLOTS * 2 * LSM6DS_FIFO_TAGGED_WORD]; ///< Words, in order
+  size_t pos = 0;     ///< Next FIFO byte to hand out
+  uint64_t bytes = 0; ///< Bytes on the wire, address bytes included
+};
+
+static spi_sim_bus bus;         ///< The simulated sensor
+static Adafruit_LSM6DSOX lsm6ds; ///< The driver under test
+volatile uint32_t sink;         ///< Keeps results from being optimized away
+
+/*!
+ *    @brief  Stands in for a DMA engine moving a FIFO burst
+ *    @param  context Unused
+ *    @param  reg The FIFO output register
+ *    @param  buffer Where the burst goes
+ *    @param  len Bytes in the burst
+ *    @returns True
+ */
+static bool dma_read(void *context, uint8_t reg, uint8_t *buffer, size_t len) {
+  return bus.read(reg, buffer, len);
+}
+
+/*!
+ *    @brief  Times a read method and prints its CSV line
+ *    @param  method The method's name
+ *    @param  fn Reads some accel and gyro pairs and returns how many
+ */
+template <typename F> static void bench(const char *method, F fn) {
+  uint32_t transfers = bus.transfers;
+  uint64_t bytes = bus.bytes;
+  uint64_t sets = 0;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  while (sets < SETS) {
+    sets += fn();
+  }
+  double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+
+  double per_set = (double)(bus.bytes - bytes) / sets;
+  printf("%s,%.1f,%.4f,%.2f,%.2f,%.2f\n", method, ns / sets,
+         (double)(bus.transfers - transfers) / sets, per_set,
+         per_set * 8e6 / SLOW_HZ, per_set * 8e6 / FAST_HZ);
+}
+
+/*!
+ *    @brief  Runs the benchmark
+ *    @returns 0, or 1 if the driver didn't start or the stream didn't
+ *             decode
+ */
+int main(void) {
+  if (!lsm6ds.begin_Bus(&bus)) {
+    printf("begin_Bus failed\n");
+    return 1;
+  }
+  printf("method,ns_per_set,transactions_per_set,bytes_per_set,"
+         "wire_us_per_set_1mhz,wire_us_per_set_10mhz\n");
+
+  static sensors_event_t accel, gyro, temp;
+  bench("getEvent", [] {
+    sink = lsm6ds.getEvent(&accel, &gyro, &temp);
+    return 1;
+  });
+
+  lsm6ds.configFIFO(LSM6DS_FIFO_CONTINUOUS, LSM6DS_RATE_833_HZ,
+                    LSM6DS_RATE_833_HZ);
+  static uint8_t words[FIFO_WORDS * LSM6DS_FIFO_TAGGED_WORD];
+  static lsm6ds_fifo_sample_t samples[FIFO_WORDS * LSM6DS_FIFO_MAX_SAMPLES];
+  static Adafruit_LSM6DS_FIFODecoder decoder;
+  bench("readFIFO+decode", [] {
+    size_t count = lsm6ds.readFIFO(words, FIFO_WORDS);
+    sink = decoder.decode(words, count, samples);
+    return count / 2;
+  });
+
+  lsm6ds.setBulkReader(dma_read);
+  bench("readFIFO+decode via bulk reader", [] {
+    size_t count = lsm6ds.readFIFO(words, FIFO_WORDS);
+    sink = decoder.decode(words, count, samples);
+    return count / 2;
+  });
+  lsm6ds.setBulkReader(NULL);
+  if (decoder.errors()) {
+    printf("FIFO stream had %u bad words\n", (unsigned)decoder.errors());
+    return 1;
+  }
+
+  static sensors_event_t accel_events[EVENTS], gyro_events[EVENTS];
+  lsm6ds.prepareEvents(accel_events, gyro_events, EVENTS);
+  bench("getEvents", [] {
+    size_t accel_count = EVENTS, gyro_count = EVENTS;
+    lsm6ds.getEvents(accel_events, &accel_count, gyro_events, &gyro_count);
+    return (accel_count + gyro_count) / 2;
+  });
+  return 0;
+}
@@ -0,0 +1,265 @@
+/*!
+ *  @file fake_ioctl.cpp
+ *  File descriptor level stand-in for i2c-dev and spidev devices
+ *
+ *  The linker's --wrap option sends the backends' open(), close(), ioctl()
+ *  and fopen() calls here. Calls for the attached device are answered from
+ *  its register file, with the chip's address auto-increment and its FIFO
+ *  output address rolling back after each word; everything else goes on
+ *  to the C library.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "fake_ioctl.h"
+
+#include <errno.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <linux/spi/spidev.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FAKE_IOCTL_FD 1000 ///< Descriptor handed out for the fake device
+
+extern "C" {
+int __real_open(const char *path, int flags, ...);
+int __real_close(int fd);
+int __real_ioctl(int fd, unsigned long request, ...);
+FILE *__real_fopen(const char *path, const char *mode);
+}
+
+static fake_device *attached = NULL; ///< Device answering open()
+static char bufsiz_text[24];         ///< What the sysfs bufsiz read gives
+
+/*!
+ *    @brief  Sets up a device with an empty register file, no FIFO and the
+ *            spidev default bufsiz
+ *    @param  device The device
+ *    @param  path The device node it answers for
+ */
+void fake_device_init(fake_device *device, const char *path) {
+  memset(device, 0, sizeof(fake_device));
+  device->path = path;
+  device->i2c_address = 0x6A;
+  device->i2c_funcs = true;
+  device->spi_bufsiz = 4096;
+  device->fail_after = -1;
+}
+
+/*!
+ *    @brief  Makes open() of the device's path give a fake descriptor
+ *    @param  device The device
+ */
+void fake_device_attach(fake_device *device) { attached = device; }
+
+/*!
+ *    @brief  Stops answering for the attached device
+ */
+void fake_device_detach(void) { attached = NULL; }
+
+/*!
+ *    @brief  Reads registers like the chip: addresses auto-increment, and
+ *            the FIFO output registers hold the oldest FIFO word and roll
+ *            back to the first of them after each word
+ *    @param  reg The first register address
+ *    @param  buffer Buffer to hold the register values
+ *    @param  len The number of registers to read
+ */
+static void fake_read(uint8_t reg, uint8_t *buffer, size_t len) {
+  fake_device *dev = attached;
+  for (size_t i = 0; i < len; i++) {
+    bool fifo = dev->fifo_width && (reg >= dev->fifo_reg) &&
+                (reg < dev->fifo_reg + dev->fifo_width);
+    if (!fifo) {
+      buffer[i] = dev->regs[reg++];
+      continue;
+    }
+    // a word only leaves the FIFO once its last register is read
+    size_t pos = dev->fifo_pos + (reg - dev->fifo_reg);
+    buffer[i] = (pos < dev->fifo_len) ? dev->fifo[pos] : 0;
+    reg++;
+    if (reg == dev->fifo_reg + dev->fifo_width) {
+      reg = dev->fifo_reg;
+      dev->fifo_pos += dev->fifo_width;
+    }
+  }
+}
+
+/*!
+ *    @brief  Counts a transfer and decides whether it fails
+ *    @param  len The data bytes it moves
+ *    @returns True if the transfer should go ahead
+ */
+static bool fake_transfer(size_t len) {
+  fake_device *dev = attached;
+  dev->transfers++;
+  if (len > dev->longest) {
+    dev->longest = len;
+  }
+  if (dev->fail_after == 0) {
+    return false;
+  }
+  if (dev->fail_after > 0) {
+    dev->fail_after--;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Answers an I2C_RDWR ioctl: a register address write, followed
+ *            by a read or carrying the data to write
+ *    @param  xfer The messages
+ *    @returns The number of messages moved, or -1 with errno set
+ */
+static int fake_i2c_rdwr(struct i2c_rdwr_ioctl_data *xfer) {
+  fake_device *dev = attached;
+  struct i2c_msg *msgs = xfer->msgs;
+  for (uint32_t i = 0; i < xfer->nmsgs; i++) {
+    if (msgs[i].addr != dev->i2c_address) {
+      errno = ENXIO;
+      return -1;
+    }
+  }
+  bool read = (xfer->nmsgs == 2) && !(msgs[0].flags & I2C_M_RD) &&
+              (msgs[0].len == 1) && (msgs[1].flags & I2C_M_RD);
+  bool write = (xfer->nmsgs == 1) && !(msgs[0].flags & I2C_M_RD) &&
+               (msgs[0].len >= 1);
+  if (!read && !write) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (!fake_transfer(read ? msgs[1].len : msgs[0].len - 1)) {
+    errno = EREMOTEIO;
+    return -1;
+  }
+  if (read) {
+    fake_read(msgs[0].buf[0], msgs[1].buf, msgs[1].len);
+  } else {
+    for (uint16_t i = 1; i < msgs[0].len; i++) {
+      dev->regs[(uint8_t)(msgs[0].buf[0] + i - 1)] = msgs[0].buf[i];
+    }
+  }
+  return xfer->nmsgs;
+}
+
+/*!
+ *    @brief  Answers a two-transfer SPI_IOC_MESSAGE: the address byte,
+ *            then the data, with chip select held
+ *    @param  xfer The transfers
+ *    @returns The bytes moved, or -1 with errno set
+ */
+static int fake_spi_message(struct spi_ioc_transfer *xfer) {
+  fake_device *dev = attached;
+  size_t total = xfer[0].len + xfer[1].len;
+  if ((xfer[0].len != 1) || !xfer[0].tx_buf) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (total > dev->spi_bufsiz) {
+    errno = EMSGSIZE; // as spidev does
+    return -1;
+  }
+  if (!fake_transfer(xfer[1].len)) {
+    errno = EIO;
+    return -1;
+  }
+  uint8_t addr = *(const uint8_t *)(uintptr_t)xfer[0].tx_buf;
+  uint8_t reg = addr & 0x7F;
+  if (addr & 0x80) {
+    fake_read(reg, (uint8_t *)(uintptr_t)xfer[1].rx_buf, xfer[1].len);
+  } else {
+    const uint8_t *tx = (const uint8_t *)(uintptr_t)xfer[1].tx_buf;
+    for (uint32_t i = 0; i < xfer[1].len; i++) {
+      dev->regs[(uint8_t)(reg + i)] = tx[i];
+    }
+  }
+  return total;
+}
+
+extern "C" {
+
+/*!
+ *    @brief  Opens the attached device's path as a fake descriptor
+ *    @param  path The file to open
+ *    @param  flags open() flags
+ *    @returns The descriptor, or -1 with errno set
+ */
+int __wrap_open(const char *path, int flags, ...) {
+  if (attached && !strcmp(path, attached->path)) {
+    attached->open = true;
+    return FAKE_IOCTL_FD;
+  }
+  va_list args;
+  va_start(args, flags);
+  int mode = va_arg(args, int);
+  va_end(args);
+  return __real_open(path, flags, mode);
+}
+
+/*!
+ *    @brief  Closes the fake descriptor, or a real one
+ *    @param  fd The descriptor
+ *    @returns 0, or -1 with errno set
+ */
+int __wrap_close(int fd) {
+  if (attached && (fd == FAKE_IOCTL_FD)) {
+    attached->open = false;
+    return 0;
+  }
+  return __real_close(fd);
+}
+
+/*!
+ *    @brief  Answers the i2c-dev and spidev ioctls the backends use
+ *    @param  fd The descriptor
+ *    @param  request The ioctl number
+ *    @returns The ioctl's result, or -1 with errno set
+ */
+int __wrap_ioctl(int fd, unsigned long request, ...) {
+  va_list args;
+  va_start(args, request);
+  void *arg = va_arg(args, void *);
+  va_end(args);
+  if (!attached || (fd != FAKE_IOCTL_FD) || !attached->open) {
+    return __real_ioctl(fd, request, arg);
+  }
+
+  switch (request) {
+  case I2C_FUNCS:
+    *(unsigned long *)arg = attached->i2c_funcs ? I2C_FUNC_I2C : 0;
+    return 0;
+  case I2C_RDWR:
+    return fake_i2c_rdwr((struct i2c_rdwr_ioctl_data *)arg);
+  case SPI_IOC_WR_MODE:
+    attached->spi_mode = *(uint8_t *)arg;
+    return 0;
+  case SPI_IOC_WR_BITS_PER_WORD:
+    attached->spi_bits = *(uint8_t *)arg;
+    return 0;
+  case SPI_IOC_WR_MAX_SPEED_HZ:
+    attached->spi_hz = *(uint32_t *)arg;
+    return 0;
+  case SPI_IOC_MESSAGE(2):
+    return fake_spi_message((struct spi_ioc_transfer *)arg);
+  }
+  errno = ENOTTY;
+  return -1;
+}
+
+/*!
+ *    @brief  Gives the attached device's spidev bufsiz for the sysfs
+ *            parameter, and opens anything else for real
+ *    @param  path The file to open
+ *    @param  mode fopen() mode
+ *    @returns The stream, or NULL with errno set
+ */
+FILE *__wrap_fopen(const char *path, const char *mode) {
+  if (attached && !strcmp(path, "/sys/module/spidev/parameters/bufsiz")) {
+    snprintf(bufsiz_text, sizeof(bufsiz_text), "%zu\n", attached->spi_bufsiz);
+    return fmemopen(bufsiz_text, strlen(bufsiz_text), "r");
+  }
+  return __real_fopen(path, mode);
+}
+}
@@ -0,0 +1,47 @@
+/*!
+ *  @file fake_ioctl.h
+ *
+ * 	File descriptor level stand-in for i2c-dev and spidev devices, so the
+ *      Linux bus backends can be tested without hardware
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _FAKE_IOCTL_H
+#define _FAKE_IOCTL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ *    @brief  A sensor behind a fake device node. Link with
+ *            `-Wl,--wrap=open,--wrap=close,--wrap=ioctl,--wrap=fopen` and
+ *            open() of `path` gives a descriptor whose I2C_RDWR and
+ *            SPI_IOC_MESSAGE ioctls act on `regs`.
+ */
+struct fake_device {
+  const char *path;    ///< Device node to answer for, eg. "/dev/fake-spi"
+  uint8_t i2c_address; ///< Address I2C messages must carry
+  bool i2c_funcs;      ///< Whether I2C_FUNCS reports I2C_FUNC_I2C
+  uint8_t regs[256];   ///< Register contents, indexed by address
+
+  uint8_t fifo_reg;    ///< First FIFO output register
+  uint8_t fifo_width;  ///< FIFO output registers, 0 for no FIFO
+  const uint8_t *fifo; ///< Bytes the FIFO output registers return
+  size_t fifo_len;     ///< Bytes in `fifo`
+  size_t fifo_pos;     ///< Offset of the oldest word left in `fifo`
+  size_t spi_bufsiz;   ///< spidev bufsiz reported through sysfs
+  int fail_after;      ///< Transfers to allow before failing, -1: all
+  uint8_t spi_mode;    ///< Set with SPI_IOC_WR_MODE
+  uint8_t spi_bits;    ///< Set with SPI_IOC_WR_BITS_PER_WORD
+  uint32_t spi_hz;     ///< Set with SPI_IOC_WR_MAX_SPEED_HZ
+  uint32_t transfers;  ///< I2C_RDWR and SPI_IOC_MESSAGE ioctls seen
+  size_t longest;      ///< Most data bytes moved by one transfer ioctl
+  bool open;           ///< Whether a descriptor is open
+};
+
+void fake_device_init(fake_device *device, const char *path);
+void fake_device_attach(fake_device *device);
+void fake_device_detach(void);
+
+#endif
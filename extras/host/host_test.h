@@ -0,0 +1,41 @@
+/*!
+ *  @file host_test.h
+ *
+ * 	Minimal checks for the host tests
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_TEST_H
+#define _HOST_TEST_H
+
+#include <stdio.h>
+
+static int host_test_checks = 0;   ///< Checks made so far
+static int host_test_failures = 0; ///< Checks that failed
+
+/*!
+ *    @brief  Checks a condition, printing where it failed
+ *    @param  cond The condition
+ */
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    host_test_checks++;                                                        \
+    if (!(cond)) {                                                             \
+      host_test_failures++;                                                    \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);         \
+    }                                                                          \
+  } while (0)
+
+/*!
+ *    @brief  Prints the totals
+ *    @param  name The test program's name
+ *    @returns 0 if every check passed, for main() to return
+ */
+static inline int host_test_report(const char *name) {
+  printf("%s: %d checks, %d failed\n", name, host_test_checks,
+         host_test_failures);
+  return host_test_failures ? 1 : 0;
+}
+
+#endif
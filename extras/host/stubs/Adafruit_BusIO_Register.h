@@ -0,0 +1,15 @@
+/*!
+ *  @file Adafruit_BusIO_Register.h
+ *
+ * 	Adafruit BusIO header stand-in for host builds
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_ADAFRUIT_BUSIO_REGISTER_H
+#define _HOST_ADAFRUIT_BUSIO_REGISTER_H
+
+#include "Adafruit_I2CDevice.h"
+#include "Adafruit_SPIDevice.h"
+
+#endif
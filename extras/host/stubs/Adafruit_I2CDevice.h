@@ -0,0 +1,77 @@
+/*!
+ *  @file Adafruit_I2CDevice.h
+ *
+ * 	Adafruit BusIO I2C device stand-in for host builds. No device ever
+ *      answers; use begin_Bus() with an Adafruit_LSM6DS_Bus instead.
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_ADAFRUIT_I2CDEVICE_H
+#define _HOST_ADAFRUIT_I2CDEVICE_H
+
+#include "Wire.h"
+
+/** An I2C device that is never found */
+class Adafruit_I2CDevice {
+public:
+  /*!  @brief  Instantiates a device
+   *   @param  addr The 7-bit address
+   *   @param  theWire The port */
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire) : _addr(addr) {}
+
+  /*!  @brief  Looks for the device
+   *   @param  addr_detect Whether to probe the address
+   *   @returns False, there is no bus */
+  bool begin(bool addr_detect = true) { return false; }
+  /*!  @brief  Releases the device */
+  void end(void) {}
+  /*!  @brief  Probes the address
+   *   @returns False */
+  bool detected(void) { return false; }
+  /*!  @brief  The device's address
+   *   @returns The 7-bit address */
+  uint8_t address(void) { return _addr; }
+
+  /*!  @brief  Reads bytes
+   *   @param  buffer Buffer for the bytes
+   *   @param  len The number of bytes
+   *   @param  stop Whether to end with a stop condition
+   *   @returns False */
+  bool read(uint8_t *buffer, size_t len, bool stop = true) { return false; }
+  /*!  @brief  Writes bytes
+   *   @param  buffer The bytes
+   *   @param  len The number of bytes
+   *   @param  stop Whether to end with a stop condition
+   *   @param  prefix_buffer Bytes to send first
+   *   @param  prefix_len The number of prefix bytes
+   *   @returns False */
+  bool write(const uint8_t *buffer, size_t len, bool stop = true,
+             const uint8_t *prefix_buffer = NULL, size_t prefix_len = 0) {
+    return false;
+  }
+  /*!  @brief  Writes bytes, then reads bytes
+   *   @param  write_buffer The bytes to write
+   *   @param  write_len The number of bytes to write
+   *   @param  read_buffer Buffer for the bytes read
+   *   @param  read_len The number of bytes to read
+   *   @param  stop Whether to stop between the write and the read
+   *   @returns False */
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len,
+                       bool stop = false) {
+    return false;
+  }
+  /*!  @brief  Sets the clock
+   *   @param  desiredclk The clock in Hz
+   *   @returns True */
+  bool setSpeed(uint32_t desiredclk) { return true; }
+  /*!  @brief  The longest transfer the port allows
+   *   @returns Bytes */
+  size_t maxBufferSize(void) { return 32; }
+
+private:
+  uint8_t _addr; ///< 7-bit address
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*!
+ *  @file Adafruit_SPIDevice.h
+ *
+ * 	Adafruit BusIO SPI device stand-in for host builds. No device ever
+ *      answers; use begin_Bus() with an Adafruit_LSM6DS_Bus instead.
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_ADAFRUIT_SPIDEVICE_H
+#define _HOST_ADAFRUIT_SPIDEVICE_H
+
+#include "SPI.h"
+
+/** Bit order of SPI transfers */
+typedef enum {
+  SPI_BITORDER_MSBFIRST = MSBFIRST, ///< Most significant bit first
+  SPI_BITORDER_LSBFIRST = LSBFIRST, ///< Least significant bit first
+} BusIOBitOrder;
+
+/** An SPI device that never answers */
+class Adafruit_SPIDevice {
+public:
+  /*!  @brief  Instantiates a device on a hardware port
+   *   @param  cspin The chip select pin
+   *   @param  freq The clock in Hz
+   *   @param  dataOrder The bit order
+   *   @param  dataMode The SPI mode
+   *   @param  theSPI The port */
+  Adafruit_SPIDevice(int8_t cspin, uint32_t freq = 1000000,
+                     BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                     uint8_t dataMode = SPI_MODE0, SPIClass *theSPI = &SPI) {}
+  /*!  @brief  Instantiates a device on software SPI pins
+   *   @param  cspin The chip select pin
+   *   @param  sck The clock pin
+   *   @param  miso The data in pin
+   *   @param  mosi The data out pin
+   *   @param  freq The clock in Hz
+   *   @param  dataOrder The bit order
+   *   @param  dataMode The SPI mode */
+  Adafruit_SPIDevice(int8_t cspin, int8_t sck, int8_t miso, int8_t mosi,
+                     uint32_t freq = 1000000,
+                     BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                     uint8_t dataMode = SPI_MODE0) {}
+
+  /*!  @brief  Sets the device up
+   *   @returns False, there is no bus */
+  bool begin(void) { return false; }
+  /*!  @brief  Reads bytes
+   *   @param  buffer Buffer for the bytes
+   *   @param  len The number of bytes
+   *   @param  sendvalue The byte clocked out meanwhile
+   *   @returns False */
+  bool read(uint8_t *buffer, size_t len, uint8_t sendvalue = 0xFF) {
+    return false;
+  }
+  /*!  @brief  Writes bytes
+   *   @param  buffer The bytes
+   *   @param  len The number of bytes
+   *   @param  prefix_buffer Bytes to send first
+   *   @param  prefix_len The number of prefix bytes
+   *   @returns False */
+  bool write(const uint8_t *buffer, size_t len,
+             const uint8_t *prefix_buffer = NULL, size_t prefix_len = 0) {
+    return false;
+  }
+  /*!  @brief  Writes bytes, then reads bytes with chip select held
+   *   @param  write_buffer The bytes to write
+   *   @param  write_len The number of bytes to write
+   *   @param  read_buffer Buffer for the bytes read
+   *   @param  read_len The number of bytes to read
+   *   @param  sendvalue The byte clocked out while reading
+   *   @returns False */
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len,
+                       uint8_t sendvalue = 0xFF) {
+    return false;
+  }
+};
+
+#endif
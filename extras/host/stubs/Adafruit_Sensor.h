@@ -0,0 +1,80 @@
+/*!
+ *  @file Adafruit_Sensor.h
+ *
+ * 	The parts of the Adafruit Unified Sensor interface the library uses,
+ *      for host builds
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_ADAFRUIT_SENSOR_H
+#define _HOST_ADAFRUIT_SENSOR_H
+
+#include "Arduino.h"
+
+#define SENSORS_GRAVITY_EARTH (9.80665F)                ///< Earth's gravity
+#define SENSORS_GRAVITY_STANDARD (SENSORS_GRAVITY_EARTH) ///< Standard gravity
+#define SENSORS_DPS_TO_RADS (0.017453293F) ///< Degrees/s to rad/s
+
+/** Sensor types */
+typedef enum {
+  SENSOR_TYPE_ACCELEROMETER = (1),        ///< Acceleration in m/s^2
+  SENSOR_TYPE_GYROSCOPE = (4),            ///< Rotation in rad/s
+  SENSOR_TYPE_AMBIENT_TEMPERATURE = (13), ///< Temperature in degrees C
+} sensors_type_t;
+
+/** A three axis reading */
+typedef struct {
+  union {
+    float v[3]; ///< X, Y and Z
+    struct {
+      float x; ///< X axis
+      float y; ///< Y axis
+      float z; ///< Z axis
+    };
+  };
+  int8_t status;       ///< Status byte
+  uint8_t reserved[3]; ///< Padding
+} sensors_vec_t;
+
+/** One reading from a sensor */
+typedef struct {
+  int32_t version;   ///< Must be sizeof(sensors_event_t)
+  int32_t sensor_id; ///< Unique sensor identifier
+  int32_t type;      ///< A sensors_type_t
+  int32_t reserved0; ///< Reserved
+  int32_t timestamp; ///< Time in milliseconds
+  union {
+    float data[4];              ///< Raw data
+    sensors_vec_t acceleration; ///< Acceleration in m/s^2
+    sensors_vec_t gyro;         ///< Rotation in rad/s
+    float temperature;          ///< Temperature in degrees C
+  };
+} sensors_event_t;
+
+/** Details of a sensor */
+typedef struct {
+  char name[12];     ///< Sensor name
+  int32_t version;   ///< Driver version
+  int32_t sensor_id; ///< Unique sensor identifier
+  int32_t type;      ///< A sensors_type_t
+  float max_value;   ///< Largest reading
+  float min_value;   ///< Smallest reading
+  float resolution;  ///< Smallest step between readings
+  int32_t min_delay; ///< Shortest time between readings in microseconds
+} sensor_t;
+
+/** A sensor that gives readings as sensors_event_t */
+class Adafruit_Sensor {
+public:
+  virtual ~Adafruit_Sensor() {}
+  /*!  @brief  Gets a reading
+   *   @param  event Filled with the reading
+   *   @returns True if it was read */
+  virtual bool getEvent(sensors_event_t *event) = 0;
+  /*!  @brief  Gets the sensor's details
+   *   @param  sensor Filled with the details */
+  virtual void getSensor(sensor_t *sensor) = 0;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*!
+ *  @file Arduino.h
+ *
+ * 	The parts of the Arduino core the library uses, for host builds.
+ *      Time only moves when delay() or delayMicroseconds() is called, so
+ *      waits inside the driver cost nothing and runs repeat exactly.
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean; ///< Arduino's name for bool
+
+#define LOW 0          ///< Pin level
+#define HIGH 1         ///< Pin level
+#define INPUT 0        ///< Pin mode
+#define OUTPUT 1       ///< Pin mode
+#define INPUT_PULLUP 2 ///< Pin mode
+#define LSBFIRST 0     ///< Bit order
+#define MSBFIRST 1     ///< Bit order
+
+#define PI 3.1415926535897932384626433832795 ///< Arduino's pi
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+void host_advance_us(uint32_t us);
+
+#endif
@@ -0,0 +1,22 @@
+/*!
+ *  @file SPI.h
+ *
+ * 	Arduino SPI port stand-in for host builds
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0 ///< Clock idles low, data sampled on the rising edge
+#define SPI_MODE3 3 ///< Clock idles high, data sampled on the rising edge
+
+/** An SPI port. Host builds reach sensors through Adafruit_LSM6DS_Bus. */
+class SPIClass {};
+
+extern SPIClass SPI; ///< The default port
+
+#endif
@@ -0,0 +1,19 @@
+/*!
+ *  @file Wire.h
+ *
+ * 	Arduino I2C port stand-in for host builds
+ *
+ * 	BSD license (see license.txt)
+ */
+
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include "Arduino.h"
+
+/** An I2C port. Host builds reach sensors through Adafruit_LSM6DS_Bus. */
+class TwoWire {};
+
+extern TwoWire Wire; ///< The default port
+
+#endif
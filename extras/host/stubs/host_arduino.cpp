@@ -0,0 +1,72 @@
+/*!
+ *  @file host_arduino.cpp
+ *  The Arduino core functions and objects the library uses, for host
+ *  builds
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+
+TwoWire Wire;
+SPIClass SPI;
+
+static uint32_t host_us = 0; ///< The simulated clock
+
+/*!
+ *    @brief  Moves the simulated clock on, as if time had passed
+ *    @param  us Microseconds to add
+ */
+void host_advance_us(uint32_t us) { host_us += us; }
+
+/*!
+ *    @brief  The simulated clock
+ *    @returns Milliseconds since start
+ */
+uint32_t millis(void) { return host_us / 1000; }
+
+/*!
+ *    @brief  The simulated clock
+ *    @returns Microseconds since start
+ */
+uint32_t micros(void) { return host_us; }
+
+/*!
+ *    @brief  Moves the simulated clock on instead of waiting
+ *    @param  ms Milliseconds
+ */
+void delay(uint32_t ms) { host_us += ms * 1000; }
+
+/*!
+ *    @brief  Moves the simulated clock on instead of waiting
+ *    @param  us Microseconds
+ */
+void delayMicroseconds(uint32_t us) { host_us += us; }
+
+/*!
+ *    @brief  Nothing else runs, so nothing to yield to
+ */
+void yield(void) {}
+
+/*!
+ *    @brief  No pins on a host
+ *    @param  pin The pin
+ *    @param  mode The mode
+ */
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+/*!
+ *    @brief  No pins on a host
+ *    @param  pin The pin
+ *    @param  value The level
+ */
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+/*!
+ *    @brief  No pins on a host; reads as an idle, pulled-up line
+ *    @param  pin The pin
+ *    @returns HIGH
+ */
+int digitalRead(uint8_t pin) { return HIGH; }
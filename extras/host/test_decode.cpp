@@ -0,0 +1,153 @@
+/*!
+ *  @file test_decode.cpp
+ *  Tests of the bulk decode kernels against the driver's scalar expressions
+ *
+ *  The Makefile builds this once per path the host compiler can target, so
+ *  each SIMD path and the portable loop are checked bit for bit on random
+ *  samples, every run length up to a few vectors and unaligned sources.
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Decode.h"
+#include "host_test.h"
+#include <string.h>
+
+#define MAX_COUNT 67 ///< Longest run, past several vectors and a ragged tail
+#define ROUNDS 2000  ///< Random buffers per kernel
+
+#if defined(__AVX2__)
+#define DECODE_PATH "avx2" ///< The path this build's kernels take
+#elif defined(__SSE4_1__)
+#define DECODE_PATH "sse4.1" ///< The path this build's kernels take
+#elif defined(__SSE2__)
+#define DECODE_PATH "sse2" ///< The path this build's kernels take
+#elif defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#define DECODE_PATH "neon" ///< The path this build's kernels take
+#else
+#define DECODE_PATH "portable" ///< The path this build's kernels take
+#endif
+
+static uint32_t lcg = 1; ///< Random state
+
+/*!
+ *    @brief  Steps the random state
+ *    @returns 16 random bits
+ */
+static uint16_t random16(void) {
+  lcg = lcg * 1664525u + 1013904223u;
+  return lcg >> 16;
+}
+
+/*!
+ *    @brief  Fills a buffer with random bytes, forcing the extreme samples
+ *            into a few spots
+ *    @param  bytes The buffer
+ *    @param  len Bytes in it, even
+ */
+static void fill(uint8_t *bytes, size_t len) {
+  for (size_t i = 0; i < len; i += 2) {
+    uint16_t raw = random16();
+    switch (random16() % 16) {
+    case 0:
+      raw = 0x8000;
+      break;
+    case 1:
+      raw = 0x7FFF;
+      break;
+    case 2:
+      raw = 0;
+      break;
+    }
+    bytes[i] = raw & 0xFF;
+    bytes[i + 1] = raw >> 8;
+  }
+}
+
+/*!
+ *    @brief  Checks every kernel on random input, starting at each offset
+ *            into the buffer so unaligned loads are covered
+ */
+static void test_random(void) {
+  uint8_t src[MAX_COUNT * 2 + 16];
+  int16_t raw[MAX_COUNT];
+  float scaled[MAX_COUNT];
+  int32_t fixed[MAX_COUNT];
+  int bad_raw = 0, bad_float = 0, bad_int32 = 0;
+
+  for (int round = 0; round < ROUNDS; round++) {
+    fill(src, sizeof(src));
+    size_t offset = round % 16;
+    size_t count = round % (MAX_COUNT + 1);
+    const uint8_t *in = src + offset;
+
+    // a random scale, or the driver's accel and gyro ones now and then
+    float scale = (float)random16() / (1 + random16() % 4096);
+    if (round % 7 == 0) {
+      scale = 0.122 * 9.80665 / 1000;
+    } else if (round % 7 == 1) {
+      scale = 70 * 0.017453293F / 1000;
+    }
+    uint16_t factor = round % 5 ? random16() : 65535;
+
+    lsm6ds_decode_raw(in, raw, count);
+    lsm6ds_decode_float(in, scaled, count, scale);
+    lsm6ds_decode_int32(in, fixed, count, factor);
+
+    for (size_t i = 0; i < count; i++) {
+      int16_t expect = (int16_t)(in[i * 2 + 1] << 8 | in[i * 2]);
+      float expect_float = expect * scale; // as decodeReading() scales
+      int32_t expect_int32 = (int32_t)expect * factor;
+      bad_raw += raw[i] != expect;
+      bad_float += memcmp(&scaled[i], &expect_float, sizeof(float)) != 0;
+      bad_int32 += fixed[i] != expect_int32;
+    }
+  }
+  CHECK(bad_raw == 0);
+  CHECK(bad_float == 0);
+  CHECK(bad_int32 == 0);
+}
+
+/*!
+ *    @brief  Checks that the kernels leave memory past `count` alone
+ */
+static void test_bounds(void) {
+  uint8_t src[MAX_COUNT * 2];
+  fill(src, sizeof(src));
+  for (size_t count = 0; count < MAX_COUNT; count++) {
+    float scaled[MAX_COUNT + 1];
+    int32_t fixed[MAX_COUNT + 1];
+    int16_t raw[MAX_COUNT + 1];
+    scaled[count] = -1.5;
+    fixed[count] = 12345;
+    raw[count] = 321;
+    lsm6ds_decode_float(src, scaled, count, 0.5);
+    lsm6ds_decode_int32(src, fixed, count, 3);
+    lsm6ds_decode_raw(src, raw, count);
+    CHECK(scaled[count] == -1.5f);
+    CHECK(fixed[count] == 12345);
+    CHECK(raw[count] == 321);
+  }
+}
+
+/*!
+ *    @brief  Runs the tests, if the CPU has the instructions they were
+ *            built for
+ *    @returns 0 if they all passed or were skipped
+ */
+int main(void) {
+#if defined(__AVX2__)
+  if (!__builtin_cpu_supports("avx2")) {
+    printf("test_decode (" DECODE_PATH "): skipped, no CPU support\n");
+    return 0;
+  }
+#elif defined(__SSE4_1__)
+  if (!__builtin_cpu_supports("sse4.1")) {
+    printf("test_decode (" DECODE_PATH "): skipped, no CPU support\n");
+    return 0;
+  }
+#endif
+  test_random();
+  test_bounds();
+  return host_test_report("test_decode (" DECODE_PATH ")");
+}
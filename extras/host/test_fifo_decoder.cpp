@@ -0,0 +1,307 @@
+/*!
+ *  @file test_fifo_decoder.cpp
+ *  Tests of Adafruit_LSM6DS_FIFODecoder: a fixed word stream with known
+ *  samples, and a round trip through a model of the chip's compressor
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_FIFODecoder.h"
+#include "host_test.h"
+#include <vector>
+
+#define ROUND_TRIP_SLOTS 20000 ///< Time slots pushed through the model
+#define UNCOMPRESSED_EVERY 32  ///< Slots between forced full samples
+
+/** A sample the decoder should give */
+struct expected_sample {
+  uint8_t tag;     ///< Sensor tag of the sample
+  uint32_t slot;   ///< Time slot
+  int16_t data[3]; ///< X, Y and Z
+};
+
+//! a stream using every accel and gyro tag, with the slot counter
+//! stepping by 1 to 3 between words
+static const uint8_t fixed_words[][LSM6DS_FIFO_TAGGED_WORD] = {
+    {0x20, 0x10, 0x27, 0x00, 0x00, 0x00, 0x00}, // timestamp, slot 0
+    {0x10, 0xE8, 0x03, 0x30, 0xF8, 0x00, 0x40}, // accel NC, slot 0
+    {0x08, 0x0A, 0x00, 0xEC, 0xFF, 0x1E, 0x00}, // gyro NC, slot 0
+    {0x46, 0x05, 0xFD, 0x7F, 0x80, 0x00, 0x01}, // accel 2xC, slots 1-2
+    {0x6E, 0xF0, 0x01, 0x21, 0x04, 0x00, 0x7C}, // gyro 3xC, slots 1-3
+    {0x4A, 0xE1, 0x3F, 0x10, 0x08, 0x83, 0x6C}, // accel 3xC, slots 3-5
+    {0x1A, 0x90, 0x01, 0x00, 0x00, 0x00, 0x00}, // temperature, slot 5
+    {0x64, 0x7F, 0x80, 0x02, 0xFF, 0x00, 0x00}, // gyro 2xC, slots 4-5
+    {0x5E, 0x07, 0x00, 0x08, 0x00, 0x09, 0x00}, // gyro NC_T_1, slot 6
+    {0x30, 0x00, 0x80, 0xFF, 0x7F, 0x00, 0x00}, // accel NC_T_2, slot 6
+    {0x38, 0x64, 0x00, 0xC8, 0x00, 0x2C, 0x01}, // accel NC_T_1, slot 7
+    {0x10, 0x65, 0x00, 0xC7, 0x00, 0x2D, 0x01}, // accel NC, slot 8
+    {0x52, 0xF9, 0xFF, 0xF8, 0xFF, 0xF7, 0xFF}, // gyro NC_T_2, slot 7
+    {0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // empty, skipped
+};
+
+//! what `fixed_words` decodes to, in order
+static const expected_sample fixed_samples[] = {
+    {LSM6DS_FIFO_TAG_TIMESTAMP, 0, {10000, 0, 0}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 0, {1000, -2000, 16384}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 0, {10, -20, 30}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 1, {1005, -2003, 16511}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 2, {877, -2003, 16512}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 1, {-6, -5, 30}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 2, {-5, -4, 31}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 3, {-5, -4, 30}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 3, {878, -2004, 16527}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 4, {862, -2004, 16529}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 5, {865, -2000, 16524}},
+    {LSM6DS_FIFO_TAG_TEMPERATURE, 5, {400, 0, 0}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 4, {122, -132, 32}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 5, {121, -132, 32}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 6, {7, 8, 9}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 6, {-32768, 32767, 0}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 7, {100, 200, 300}},
+    {LSM6DS_FIFO_TAG_ACCEL_NC, 8, {101, 199, 301}},
+    {LSM6DS_FIFO_TAG_GYRO_NC, 7, {-7, -8, -9}},
+};
+
+/*!
+ *    @brief  Decodes the fixed stream and compares every sample
+ */
+static void test_fixed_stream(void) {
+  const size_t words = sizeof(fixed_words) / sizeof(fixed_words[0]);
+  const size_t expected = sizeof(fixed_samples) / sizeof(fixed_samples[0]);
+  lsm6ds_fifo_sample_t samples[words * LSM6DS_FIFO_MAX_SAMPLES];
+
+  Adafruit_LSM6DS_FIFODecoder decoder;
+  size_t count = decoder.decode(fixed_words[0], words, samples);
+  CHECK(count == expected);
+  CHECK(decoder.errors() == 1);
+  for (size_t i = 0; (i < count) && (i < expected); i++) {
+    CHECK(samples[i].tag == fixed_samples[i].tag);
+    CHECK(samples[i].slot == fixed_samples[i].slot);
+    CHECK(!memcmp(samples[i].data, fixed_samples[i].data, 6));
+  }
+
+  // word by word gives the same as a run
+  decoder.reset();
+  lsm6ds_fifo_sample_t one[LSM6DS_FIFO_MAX_SAMPLES];
+  size_t total = 0;
+  for (size_t w = 0; w < words; w++) {
+    uint8_t n = decoder.decodeWord(fixed_words[w], one);
+    for (uint8_t s = 0; (s < n) && (total < count); s++, total++) {
+      CHECK(one[s].tag == samples[total].tag);
+      CHECK(one[s].slot == samples[total].slot);
+      CHECK(!memcmp(one[s].data, samples[total].data, 6));
+    }
+  }
+  CHECK(total == count);
+
+  // compressed words before any full sample are skipped
+  Adafruit_LSM6DS_FIFODecoder late;
+  CHECK(late.decodeWord(fixed_words[3], one) == 0);
+  CHECK(late.decodeWord(fixed_words[4], one) == 0);
+  CHECK(late.errors() == 2);
+  CHECK(late.decodeWord(fixed_words[8], one) == 1);
+}
+
+/*!
+ *    @brief  Model of one sensor's FIFO compressor. Samples wait until a
+ *            word can hold them: three small steps make a 3xC word, two
+ *            moderate ones a 2xC word, and otherwise the oldest goes out
+ *            alone as NC_T_2. A forced full sample flushes everything
+ *            waiting as NC, NC_T_1 and NC_T_2 words.
+ */
+struct compressor {
+  uint8_t nc, nc_t_1, nc_t_2, c2x, c3x; ///< This sensor's tags
+  int16_t last[3];                      ///< Newest sample sent
+  std::vector<int16_t> waiting;         ///< Samples not sent, oldest first
+  std::vector<uint8_t> *fifo;           ///< Where words go
+  uint32_t slot;                        ///< Current time slot
+
+  /*!  @brief  Appends a word
+   *   @param  tag The tag
+   *   @param  data Six data bytes */
+  void put(uint8_t tag, const uint8_t *data) {
+    fifo->push_back(tag << 3 | (slot & 0x03) << 1);
+    fifo->insert(fifo->end(), data, data + 6);
+  }
+
+  /*!  @brief  Sends the oldest waiting sample uncompressed
+   *   @param  tag NC, NC_T_1 or NC_T_2 for its age */
+  void sendFull(uint8_t tag) {
+    uint8_t data[6];
+    for (int axis = 0; axis < 3; axis++) {
+      last[axis] = waiting[axis];
+      data[axis * 2] = (uint16_t)last[axis] & 0xFF;
+      data[axis * 2 + 1] = (uint16_t)last[axis] >> 8;
+    }
+    waiting.erase(waiting.begin(), waiting.begin() + 3);
+    put(tag, data);
+  }
+
+  /*!  @brief  Checks the steps to the next samples fit a field
+   *   @param  count The number of waiting samples to check
+   *   @param  limit The field's range, -limit to limit - 1
+   *   @returns True if they all fit */
+  bool fits(int count, int limit) {
+    const int16_t *prev = last;
+    for (int s = 0; s < count; s++) {
+      for (int axis = 0; axis < 3; axis++) {
+        int step = waiting[s * 3 + axis] - prev[axis];
+        if ((step < -limit) || (step >= limit)) {
+          return false;
+        }
+      }
+      prev = &waiting[s * 3];
+    }
+    return true;
+  }
+
+  /*!  @brief  Takes the sample of the current slot
+   *   @param  xyz The sample
+   *   @param  full True to send everything uncompressed */
+  void push(const int16_t *xyz, bool full) {
+    waiting.insert(waiting.end(), xyz, xyz + 3);
+    if (full) {
+      while (!waiting.empty()) {
+        size_t age = waiting.size() / 3 - 1; // of the oldest, in slots
+        sendFull(age == 0 ? nc : (age == 1 ? nc_t_1 : nc_t_2));
+      }
+      return;
+    }
+    if (waiting.size() < 9) {
+      return;
+    }
+    uint8_t data[6];
+    if (fits(3, 16)) {
+      for (int s = 0; s < 3; s++) {
+        uint16_t packed = 0;
+        for (int axis = 0; axis < 3; axis++) {
+          packed |= ((waiting[s * 3 + axis] - last[axis]) & 0x1F) << (axis * 5);
+          last[axis] = waiting[s * 3 + axis];
+        }
+        data[s * 2] = packed & 0xFF;
+        data[s * 2 + 1] = packed >> 8;
+      }
+      waiting.clear();
+      put(c3x, data);
+    } else if (fits(2, 128)) {
+      for (int s = 0; s < 2; s++) {
+        for (int axis = 0; axis < 3; axis++) {
+          data[s * 3 + axis] = (uint8_t)(waiting[s * 3 + axis] - last[axis]);
+          last[axis] = waiting[s * 3 + axis];
+        }
+      }
+      waiting.erase(waiting.begin(), waiting.begin() + 6);
+      put(c2x, data);
+    } else {
+      sendFull(nc_t_2);
+    }
+  }
+};
+
+/*!
+ *    @brief  Small pseudo-random numbers, the same on every host
+ *    @returns The next number, 0 to 32767
+ */
+static int next_random(void) {
+  static uint32_t state = 1;
+  state = state * 1103515245 + 12345;
+  return (state >> 16) & 0x7FFF;
+}
+
+/*!
+ *    @brief  A random step between samples: small, moderate or a large
+ *            jump, so every kind of word gets used
+ *    @param  small Chance of a step that fits 5 bits, in 1/1000
+ *    @param  moderate Chance of one that fits 8 bits, plus `small`
+ *    @returns The step
+ */
+static int random_step(int small, int moderate) {
+  int r = next_random() % 1000;
+  if (r < small) {
+    return next_random() % 31 - 15;
+  }
+  if (r < moderate) {
+    return next_random() % 255 - 127;
+  }
+  return next_random() % 20001 - 10000;
+}
+
+/*!
+ *    @brief  Compresses random accel and gyro streams with the model and
+ *            checks the decoder gives back every sample in its slot
+ */
+static void test_round_trip(void) {
+  std::vector<int16_t> accel(ROUND_TRIP_SLOTS * 3), gyro(ROUND_TRIP_SLOTS * 3);
+  int16_t a[3] = {100, -200, 16384}, g[3] = {0, 0, 0};
+  for (int slot = 0; slot < ROUND_TRIP_SLOTS; slot++) {
+    for (int axis = 0; axis < 3; axis++) {
+      a[axis] += random_step(700, 950);
+      g[axis] += random_step(900, 990);
+      accel[slot * 3 + axis] = a[axis];
+      gyro[slot * 3 + axis] = g[axis];
+    }
+  }
+
+  std::vector<uint8_t> fifo;
+  compressor ca = {LSM6DS_FIFO_TAG_ACCEL_NC,    LSM6DS_FIFO_TAG_ACCEL_NC_T_1,
+                   LSM6DS_FIFO_TAG_ACCEL_NC_T_2, LSM6DS_FIFO_TAG_ACCEL_2XC,
+                   LSM6DS_FIFO_TAG_ACCEL_3XC,    {0, 0, 0},
+                   {},                           &fifo,
+                   0};
+  compressor cg = {LSM6DS_FIFO_TAG_GYRO_NC,    LSM6DS_FIFO_TAG_GYRO_NC_T_1,
+                   LSM6DS_FIFO_TAG_GYRO_NC_T_2, LSM6DS_FIFO_TAG_GYRO_2XC,
+                   LSM6DS_FIFO_TAG_GYRO_3XC,    {0, 0, 0},
+                   {},                          &fifo,
+                   0};
+  for (int slot = 0; slot < ROUND_TRIP_SLOTS; slot++) {
+    bool full = !(slot % UNCOMPRESSED_EVERY) || (slot == ROUND_TRIP_SLOTS - 1);
+    ca.slot = cg.slot = slot;
+    ca.push(&accel[slot * 3], full);
+    cg.push(&gyro[slot * 3], full);
+  }
+
+  size_t words = fifo.size() / LSM6DS_FIFO_TAGGED_WORD;
+  uint32_t tags[32] = {0};
+  for (size_t w = 0; w < words; w++) {
+    tags[fifo[w * LSM6DS_FIFO_TAGGED_WORD] >> 3]++;
+  }
+  for (uint8_t tag = LSM6DS_FIFO_TAG_ACCEL_NC_T_2;
+       tag <= LSM6DS_FIFO_TAG_GYRO_3XC; tag++) {
+    CHECK(tags[tag] > 0); // every compressed tag was exercised
+  }
+
+  std::vector<lsm6ds_fifo_sample_t> samples(words * LSM6DS_FIFO_MAX_SAMPLES);
+  Adafruit_LSM6DS_FIFODecoder decoder;
+  size_t count = decoder.decode(fifo.data(), words, samples.data());
+  CHECK(decoder.errors() == 0);
+
+  size_t na = 0, ng = 0, bad = 0;
+  for (size_t i = 0; i < count; i++) {
+    bool is_accel = samples[i].tag == LSM6DS_FIFO_TAG_ACCEL_NC;
+    size_t &n = is_accel ? na : ng;
+    if (n >= ROUND_TRIP_SLOTS) {
+      bad++;
+      continue;
+    }
+    const int16_t *want = is_accel ? &accel[n * 3] : &gyro[n * 3];
+    if ((samples[i].slot != n) || memcmp(samples[i].data, want, 6)) {
+      bad++;
+    }
+    n++;
+  }
+  CHECK(na == ROUND_TRIP_SLOTS);
+  CHECK(ng == ROUND_TRIP_SLOTS);
+  CHECK(bad == 0);
+  printf("round trip: %d slots in %zu words, %.2f words per slot\n",
+         ROUND_TRIP_SLOTS, words, (double)words / ROUND_TRIP_SLOTS);
+}
+
+/*!
+ *    @brief  Runs the tests
+ *    @returns 0 if they all passed
+ */
+int main(void) {
+  test_fixed_stream();
+  test_round_trip();
+  return host_test_report("test_fifo_decoder");
+}
@@ -0,0 +1,172 @@
+/*!
+ *  @file test_linux_bus.cpp
+ *  Tests of the Linux i2c-dev and spidev backends against fake_ioctl
+ *
+ * 	BSD (see license.txt)
+ */
+
+#include "Adafruit_LSM6DS_Linux.h"
+#include "fake_ioctl.h"
+#include "host_test.h"
+#include <linux/spi/spidev.h>
+#include <string.h>
+
+/*!
+ *    @brief  Fills a FIFO stream with a byte pattern that never repeats
+ *            on a word boundary, so a misplaced chunk shows up
+ *    @param  fifo The stream
+ *    @param  len Bytes in `fifo`
+ */
+static void fill_fifo(uint8_t *fifo, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    fifo[i] = (uint8_t)(i * 7 + (i >> 8));
+  }
+}
+
+/*!
+ *    @brief  Register reads and writes over I2C_RDWR
+ */
+static void test_i2c(void) {
+  fake_device dev;
+  fake_device_init(&dev, "/dev/fake-i2c");
+  dev.regs[0x0F] = 0x6C;
+  for (int i = 0; i < 12; i++) {
+    dev.regs[0x22 + i] = 0x10 + i;
+  }
+  fake_device_attach(&dev);
+
+  Adafruit_LSM6DS_LinuxI2C bus("/dev/fake-i2c", 0x6A);
+  CHECK(bus.begin());
+  uint8_t buf[80];
+  CHECK(bus.read(0x0F, buf, 1) && (buf[0] == 0x6C));
+
+  // one combined ioctl per burst, auto-incrementing
+  dev.transfers = 0;
+  CHECK(bus.read(0x22, buf, 12));
+  CHECK(dev.transfers == 1);
+  for (int i = 0; i < 12; i++) {
+    CHECK(buf[i] == 0x10 + i);
+  }
+
+  // short writes are staged on the stack, long ones on the heap
+  uint8_t out[70];
+  for (int i = 0; i < 70; i++) {
+    out[i] = 0xA0 ^ i;
+  }
+  CHECK(bus.write(0x10, out, 3));
+  CHECK((dev.regs[0x10] == 0xA0) && (dev.regs[0x12] == 0xA2));
+  CHECK(bus.write(0x40, out, 70));
+  CHECK((dev.regs[0x40] == 0xA0) && (dev.regs[0x40 + 69] == (0xA0 ^ 69)));
+
+  // the FIFO output register rolls over on a 2-byte word
+  uint8_t fifo[64];
+  fill_fifo(fifo, sizeof(fifo));
+  dev.fifo_reg = 0x3E;
+  dev.fifo_width = 2;
+  dev.fifo = fifo;
+  dev.fifo_len = sizeof(fifo);
+  CHECK(bus.read(0x3E, buf, 64));
+  CHECK(!memcmp(buf, fifo, 64));
+
+  dev.fail_after = 0;
+  CHECK(!bus.read(0x0F, buf, 1));
+  dev.fail_after = -1;
+
+  // a sensor at another address doesn't answer
+  Adafruit_LSM6DS_LinuxI2C other("/dev/fake-i2c", 0x6B);
+  CHECK(other.begin());
+  CHECK(!other.read(0x0F, buf, 1));
+
+  bus.end();
+  CHECK(!bus.read(0x0F, buf, 1));
+
+  dev.i2c_funcs = false;
+  CHECK(!bus.begin());
+  CHECK(!dev.open);
+  fake_device_detach();
+}
+
+/*!
+ *    @brief  Setup and single-message register access over spidev
+ */
+static void test_spi(void) {
+  fake_device dev;
+  fake_device_init(&dev, "/dev/fake-spi");
+  dev.regs[0x0F] = 0x6C;
+  fake_device_attach(&dev);
+
+  Adafruit_LSM6DS_LinuxSPI bus("/dev/fake-spi", 8000000, true);
+  CHECK(bus.begin());
+  CHECK(dev.spi_mode == (SPI_MODE_0 | SPI_3WIRE));
+  CHECK(dev.spi_bits == 8);
+  CHECK(dev.spi_hz == 8000000);
+  CHECK(bus.maxTransfer() == 4095);
+
+  uint8_t buf[16];
+  dev.transfers = 0;
+  CHECK(bus.read(0x0F, buf, 1) && (buf[0] == 0x6C));
+  uint8_t ctrl[3] = {0x60, 0x64, 0x44};
+  CHECK(bus.write(0x10, ctrl, 3));
+  CHECK(!memcmp(dev.regs + 0x10, ctrl, 3));
+  CHECK(bus.read(0x10, buf, 3) && !memcmp(buf, ctrl, 3));
+  CHECK(dev.transfers == 3);
+
+  bus.end();
+  CHECK(!dev.open);
+  fake_device_detach();
+}
+
+/*!
+ *    @brief  FIFO bursts longer than spidev's bufsiz are split on whole
+ *            words and come back in order
+ *    @param  fifo_reg The first FIFO output register
+ *    @param  word_size Bytes per FIFO word
+ */
+static void test_spi_chunks(uint8_t fifo_reg, uint8_t word_size) {
+  static uint8_t fifo[3 * 1024], buf[3 * 1024];
+  fake_device dev;
+  fake_device_init(&dev, "/dev/fake-spi");
+  dev.spi_bufsiz = 64;
+  dev.fifo_reg = fifo_reg;
+  dev.fifo_width = word_size;
+  dev.fifo = fifo;
+  dev.fifo_len = 438 * word_size;
+  fill_fifo(fifo, dev.fifo_len);
+  fake_device_attach(&dev);
+
+  Adafruit_LSM6DS_LinuxSPI bus("/dev/fake-spi");
+  CHECK(bus.begin());
+  CHECK(bus.maxTransfer() == 63);
+
+  memset(buf, 0, sizeof(buf));
+  dev.transfers = 0;
+  CHECK(bus.read(fifo_reg, buf, dev.fifo_len));
+  CHECK(!memcmp(buf, fifo, dev.fifo_len));
+  CHECK(dev.longest == 56);
+  CHECK(dev.transfers == (dev.fifo_len + 55) / 56);
+
+  // a failed piece fails the read
+  dev.fifo_pos = 0;
+  dev.fail_after = 2;
+  CHECK(!bus.read(fifo_reg, buf, dev.fifo_len));
+  dev.fail_after = -1;
+
+  // writes still have to fit one message
+  CHECK(!bus.write(0x10, buf, 64));
+  CHECK(bus.write(0x10, buf, 63));
+
+  bus.end();
+  fake_device_detach();
+}
+
+/*!
+ *    @brief  Runs the tests
+ *    @returns 0 if they all passed
+ */
+int main(void) {
+  test_i2c();
+  test_spi();
+  test_spi_chunks(0x3E, 2); // LSM6DS33 and friends
+  test_spi_chunks(0x78, 7); // tagged words of the LSM6DSOX family
+  return host_test_report("test_linux_bus");
+}